@@ -1,4 +1,5 @@
 import sys
+import time
 from threading import Lock
 import cv2
 import numpy as np
@@ -24,6 +25,8 @@ class YarpMdetr(yarp.RFModule):
         self.image_w = rf.find('image_width').asInt32() if rf.check('image_width') else 640
         self.image_h = rf.find('image_height').asInt32() if rf.check('image_height') else 480
         self.min_conf = rf.find('min_confidence').asFloat32() if rf.check('min_confidence') else 0.95
+        self.batch_size = rf.find('batch_size').asInt32() if rf.check('batch_size') else 8
+        self.batch_timeout = rf.find('batch_timeout').asFloat32() if rf.check('batch_timeout') else 5.0
 
         # Opening ports
         self.cmd_port = yarp.Port()
@@ -37,6 +40,13 @@ class YarpMdetr(yarp.RFModule):
         self._input_image_port.open(imageInPortName)
         print('{:s} opened'.format(imageInPortName))
 
+        # images of the 'batch' command, none of them can be dropped
+        self._batch_image_port = yarp.BufferedPortImageRgb()
+        batchImagePortName = rf.find('batch_image_port').asString() if rf.check('batch_image_port') else '/yarpMdetr/batch/image:i'
+        self._batch_image_port.setStrict()
+        self._batch_image_port.open(batchImagePortName)
+        print('{:s} opened'.format(batchImagePortName))
+
         self._output_image_port = yarp.Port()
         imageOutPortName = rf.find('output_image_port').asString() if rf.check('output_image_port') else '/yarpMdetr/image:o' 
         self._output_image_port.open(imageOutPortName)
@@ -95,11 +105,19 @@ class YarpMdetr(yarp.RFModule):
             else:
                 reply.addString('not found')
             self.lock.release()
+        elif command.get(0).asString() == 'batch' and command.size() == 3:
+            print('Command \'batch\' received')
+            self.lock.acquire()
+            if not self.batch_inference(command.get(1).asString(), command.get(2).asInt32(), reply):
+                reply.clear()
+                reply.addVocab32('nack')
+            self.lock.release()
         elif command.get(0).asString() == 'help':
             print('Command \'help\' received')
             reply.addVocab32('many')
             reply.addString('label <something> : identify "something" in input image')
             reply.addString('where <something> : returns whether "something" is found in the input image')
+            reply.addString('batch <something> <n> : looks for "something" in the next n images of the batch port, returns one list of detections per image')
             reply.addString('help : get this list')           
         else:
             print('Command {:s} not recognized'.format(command.get(0).asString()) + '. Type \'help\'')
@@ -113,6 +131,7 @@ class YarpMdetr(yarp.RFModule):
         print('Interrupt function')
         self.cmd_port.close()
         self._input_image_port.close()
+        self._batch_image_port.close()
         self._output_image_port.close()
         self.output_coords_port.close()
         self.read_coords_port.close()
@@ -178,22 +197,79 @@ class YarpMdetr(yarp.RFModule):
         if probs_bbox.size(dim=-1)>0:
             idx=0
             for box in out_bbox:
-                x, y, _, _ = box.unbind(-1)
+                x, y, w, h = box.unbind(-1)
                 x_out=x.item() * self.image_w
                 y_out=y.item() * self.image_h
+                w_out=w.item() * self.image_w
+                h_out=h.item() * self.image_h
                 b = bout.addList()
                 b.addString(self.caption)
                 b.addFloat32(float(probs_bbox[idx]))
                 b.addFloat32(x_out)
                 b.addFloat32(y_out)
+                b.addFloat32(x_out - w_out/2)       # bounding box: top left and bottom right corners
+                b.addFloat32(y_out - h_out/2)
+                b.addFloat32(x_out + w_out/2)
+                b.addFloat32(y_out + h_out/2)
                 idx=idx+1
         else:
             bout.addString('nothing')
         self.output_coords_port.write()
 
+    def batch_inference(self, caption, n, reply):
+        # the images have been queued on the batch port before the command
+        frames = []
+        timeout = time.time() + self.batch_timeout
+        while len(frames) < n and time.time() < timeout:
+            received_image = self._batch_image_port.read(False)
+            if received_image is None:
+                time.sleep(0.005)
+                continue
+            frame = np.zeros((received_image.height(), received_image.width(), 3), dtype=np.uint8)
+            buf_image = yarp.ImageRgb()
+            buf_image.resize(received_image.width(), received_image.height())
+            buf_image.setExternal(frame, frame.shape[1], frame.shape[0])
+            buf_image.copy(received_image)
+            frames.append(frame)
+        if len(frames) < n:
+            print('Batch: received {:d} images of {:d}'.format(len(frames), n))
+            while self._batch_image_port.getPendingReads() > 0:
+                self._batch_image_port.read(False)
+            return False
+
+        for first in range(0, n, self.batch_size):
+            chunk = frames[first:first + self.batch_size]
+            imgs = torch.stack([self.transform(Image.fromarray(f)) for f in chunk]).cuda()
+            captions = [caption] * len(chunk)
+            memory_cache = self.model(imgs, captions, encode_and_save=True)
+            outputs = self.model(imgs, captions, encode_and_save=False, memory_cache=memory_cache)
+            for i, frame in enumerate(chunk):
+                probas = 1 - outputs['pred_logits'].softmax(-1)[i, :, -1].cpu()
+                keep = probas > self.min_conf
+                out_bbox = outputs['pred_boxes'].cpu()[i, keep]
+                img_h, img_w = frame.shape[0], frame.shape[1]
+                detections = reply.addList()
+                for prob, box in zip(probas[keep], out_bbox):
+                    x, y, w, h = box.unbind(-1)
+                    x_out = x.item() * img_w
+                    y_out = y.item() * img_h
+                    w_out = w.item() * img_w
+                    h_out = h.item() * img_h
+                    b = detections.addList()
+                    b.addString(caption)
+                    b.addFloat32(float(prob))
+                    b.addFloat32(x_out)
+                    b.addFloat32(y_out)
+                    b.addFloat32(x_out - w_out/2)
+                    b.addFloat32(y_out - h_out/2)
+                    b.addFloat32(x_out + w_out/2)
+                    b.addFloat32(y_out + h_out/2)
+        return True
+
     def updateModule(self):
-        self.lock.acquire()
+        # the stream is read without the lock, so that a batch does not wait for it
         received_image = self._input_image_port.read()
+        self.lock.acquire()
         self._in_buf_image.copy(received_image)   
         assert self._in_buf_array.__array_interface__['data'][0] == self._in_buf_image.getRawImage().__int__()
         frame = self._in_buf_array
@@ -105,7 +105,10 @@ void ApproachObject::onRead(Bottle& b)
     yCInfo(APPROACH_OBJECT,"Received:  %s",b.toString().c_str());
     if(b.size() == 2)
     {
-        m_thread->exec(b);
+        //the envelope carries the timestamp of the image where the object has been detected
+        Stamp stamp;
+        m_input_port.getEnvelope(stamp);
+        m_thread->exec(b, stamp.isValid() ? stamp.getTime() : -1.0);
     }
     else if(b.size() == 1)
     {
@@ -28,7 +28,9 @@ ApproachObjectThread::ApproachObjectThread(double _period, ResourceFinder &rf):
     m_rf(rf),
     m_ext_start(false),
     m_ext_stop(false),
-    m_ext_resume(false)
+    m_ext_resume(false),
+    m_coords_stamp(-1.0),
+    m_depth_buffer(nullptr)
 {
     m_gaze_target_port_name         = "/approachObject/gaze_target:o";
     m_object_finder_rpc_port_name   = "/approachObject/object_finder/rpc";
@@ -159,18 +161,21 @@ bool ApproachObjectThread::threadInit()
         return false;
     }
 
+    // --------- Navigation status --------- //
+    string navStatusPort = m_rf.check("nav_status_port") ? m_rf.find("nav_status_port").asString() : "/navStatusBroadcaster/status:o";
+    m_navStatus = new NavStatusCache(m_iNav2D);
+    if(!m_navStatus->open("/approachObject/navStatus:i", navStatusPort))
+        return false;
+
 
     // --------- RGBDSensor config --------- //
+    // no RGBD client: the intrinsics are asked on the rpc port of the camera and only the depth stream is received
     Property rgbdProp;
     // Prepare default prop object
-    rgbdProp.put("device",          "RGBDSensorClient");
-    rgbdProp.put("localImagePort",  "/approachObject/clientRgbPort:i");
     rgbdProp.put("localDepthPort",  "/approachObject/clientDepthPort:i");
     rgbdProp.put("localRpcPort",    "/approachObject/clientRpcPort");
-    rgbdProp.put("remoteImagePort", "/SIM_CER_ROBOT/depthCamera/rgbImage:o");
     rgbdProp.put("remoteDepthPort", "/SIM_CER_ROBOT/depthCamera/depthImage:o");
     rgbdProp.put("remoteRpcPort",   "/SIM_CER_ROBOT/depthCamera/rpc:i");
-    rgbdProp.put("ImageCarrier",    "mjpeg");
     rgbdProp.put("DepthCarrier",    "fast_tcp");
     bool okRgbdRf = m_rf.check("RGBD_SENSOR_CLIENT");
     if(!okRgbdRf)
@@ -180,38 +185,55 @@ bool ApproachObjectThread::threadInit()
     else
     {
         Searchable& rgbd_config = m_rf.findGroup("RGBD_SENSOR_CLIENT");
-        if(rgbd_config.check("device")) {rgbdProp.put("device", rgbd_config.find("device").asString());}
-        if(rgbd_config.check("localImagePort")) {rgbdProp.put("localImagePort", rgbd_config.find("localImagePort").asString());}
         if(rgbd_config.check("localDepthPort")) {rgbdProp.put("localDepthPort", rgbd_config.find("localDepthPort").asString());}
         if(rgbd_config.check("localRpcPort")) {rgbdProp.put("localRpcPort", rgbd_config.find("localRpcPort").asString());}
-        if(rgbd_config.check("remoteImagePort")) {rgbdProp.put("remoteImagePort", rgbd_config.find("remoteImagePort").asString());}
         if(rgbd_config.check("remoteDepthPort")) {rgbdProp.put("remoteDepthPort", rgbd_config.find("remoteDepthPort").asString());}
         if(rgbd_config.check("remoteRpcPort")) {rgbdProp.put("remoteRpcPort", rgbd_config.find("remoteRpcPort").asString());}
-        if(rgbd_config.check("ImageCarrier")) {rgbdProp.put("ImageCarrier", rgbd_config.find("ImageCarrier").asString());}
         if(rgbd_config.check("DepthCarrier")) {rgbdProp.put("DepthCarrier", rgbd_config.find("DepthCarrier").asString());}
     }
 
-    m_rgbdPoly.open(rgbdProp);
-    if(!m_rgbdPoly.isValid())
+    //get parameters data from the camera
+    CameraInfo camera;
+    if(!camera.open(rgbdProp.find("localRpcPort").asString(), rgbdProp.find("remoteRpcPort").asString()))
+        return false;
+    bool propintr = camera.getDepthIntrinsicParam(m_propIntrinsics);
+    camera.close();
+    if(!propintr){
+        yCError(APPROACH_OBJECT_THREAD,"Cannot get the depth intrinsics from the camera");
+        return false;
+    }
+    yCInfo(APPROACH_OBJECT_THREAD) << "Depth Intrinsics:" << m_propIntrinsics.toString();
+    m_intrinsics.fromProperty(m_propIntrinsics);
+
+    //the depth stream stays connected: the buffer below must hold the frames around the time of a detection
+    string localDepth = rgbdProp.find("localDepthPort").asString();
+    string remoteDepth = rgbdProp.find("remoteDepthPort").asString();
+    if(!m_depth_port.open(localDepth))
     {
-        yCError(APPROACH_OBJECT_THREAD,"Error opening PolyDriver check parameters");
+        yCError(APPROACH_OBJECT_THREAD) << "Cannot open port" << localDepth;
         return false;
     }
-    m_rgbdPoly.view(m_iRgbd);
-    if(!m_iRgbd)
+    if(!Network::connect(remoteDepth, localDepth, rgbdProp.find("DepthCarrier").asString()))
     {
-        yCError(APPROACH_OBJECT_THREAD,"Error opening iRGBD interface. Device not available");
+        yCError(APPROACH_OBJECT_THREAD) << "Cannot connect" << remoteDepth << "to" << localDepth;
         return false;
     }
-   
-    //get parameters data from the camera
-    bool propintr  = m_iRgbd->getDepthIntrinsicParam(m_propIntrinsics);
-    if(!propintr){
+
+
+    // --------- Depth frames buffer --------- //
+    int depthBufferSize = m_rf.check("depth_buffer_size") ? m_rf.find("depth_buffer_size").asInt32() : 15;
+    double depthBufferPeriod = m_rf.check("depth_buffer_period") ? m_rf.find("depth_buffer_period").asFloat32() : 0.033;
+    m_depth_buffer = new DepthRingBuffer(depthBufferPeriod, &m_depth_port, depthBufferSize);
+    if (!m_depth_buffer->start())
+    {
+        yCError(APPROACH_OBJECT_THREAD,"Error starting the depth frames buffer");
         return false;
     }
-    yCInfo(APPROACH_OBJECT_THREAD) << "Depth Intrinsics:" << m_propIntrinsics.toString();
-    m_intrinsics.fromProperty(m_propIntrinsics);
 
+    // --------- Telemetry --------- //
+    m_telemetry = new SearchTelemetry("approachObject");
+    if(!m_telemetry->configure(m_rf))
+        return false;
 
     return true;
 }
@@ -220,14 +242,31 @@ bool ApproachObjectThread::threadInit()
 /****************************************************************/
 void ApproachObjectThread::threadRelease()
 {
+    if(m_depth_buffer)
+    {
+        m_depth_buffer->stop();
+        delete m_depth_buffer;
+        m_depth_buffer = nullptr;
+    }
+
     if(m_tcPoly.isValid())
         m_tcPoly.close();
     
+    if(m_navStatus)
+    {
+        m_navStatus->close();
+        delete m_navStatus;
+        m_navStatus = nullptr;
+    }
+
     if(m_nav2DPoly.isValid())
         m_nav2DPoly.close();
     
-    if(m_rgbdPoly.isValid())
-        m_rgbdPoly.close();
+    if(!m_depth_port.isClosed())
+    {
+        m_depth_port.interrupt();
+        m_depth_port.close();
+    }
 
     if (m_object_finder_rpc_port.asPort().isOpen())
         m_object_finder_rpc_port.close();   
@@ -240,14 +279,33 @@ void ApproachObjectThread::threadRelease()
 
     if (!m_gaze_target_port.isClosed())
         m_gaze_target_port.close(); 
+
+    if(m_telemetry)
+    {
+        m_telemetry->close();
+        delete m_telemetry;
+        m_telemetry = nullptr;
+    }
 }
 
 
 /****************************************************************/
-void ApproachObjectThread::exec(Bottle& b) 
+void ApproachObjectThread::exec(Bottle& b, double stamp) 
 {
+    //"b" belongs to the input port and is reused for the next message: its content is copied
+    Bottle* coords = b.get(1).asList();
+    if (coords == nullptr)
+    {
+        yCError(APPROACH_OBJECT_THREAD, "The coordinates of the object are not a list");
+        return;
+    }
+
+    lock_guard<mutex> lock(m_coords_mutex);
     m_object = b.get(0).asString();
-    m_coords = b.get(1).asList();
+    m_coords.resize(coords->size());
+    for (int i=0; i<coords->size(); i++)
+        m_coords[i] = coords->get(i).asFloat32();
+    m_coords_stamp = stamp;
 
     m_ext_start = true;
 }   
@@ -258,37 +316,44 @@ void ApproachObjectThread::run()
 {  
     if (m_ext_start && !m_ext_stop)
     {
+        string object;
+        double coordsStamp;
+        {
+            lock_guard<mutex> lock(m_coords_mutex);
+            object = m_object;
+            m_target_coords = m_coords;
+            coordsStamp = m_coords_stamp;
+        }
+
+        m_telemetry->increment("approaches");
+        SearchTelemetry::Timer approachTimer(m_telemetry, "approach_total");
+
         Map2DLocation locRobot, locObject, locTarget;
-        m_iNav2D->getCurrentPosition(locRobot);
+        m_navStatus->getCurrentPosition(locRobot);
         yCInfo(APPROACH_OBJECT_THREAD,) << "Current location:"<< locRobot.toString();
         
         yCInfo(APPROACH_OBJECT_THREAD,"Calculating approaching position");
-        if (m_coords->size() == 2) //pixel coordinates in camera ref frame
+        if (m_target_coords.size() == 2) //pixel coordinates in camera ref frame
         {
-            double u = m_coords->get(0).asFloat32();
-            double v = m_coords->get(1).asFloat32();
+            double u = m_target_coords[0];
+            double v = m_target_coords[1];
 
-            //get depth image from camera
-            ImageOf<float>  depth_image;  
-            bool depth_ok = m_iRgbd->getDepthImage(depth_image);
-            if (!depth_ok)
+            //get the depth frame synchronized with the image where the object has been detected
+            double depth_stamp;
+            if (!m_depth_buffer->getNearest(coordsStamp, m_depth_image, depth_stamp))
             {
-                yCError(APPROACH_OBJECT_THREAD, "getDepthImage failed");
-                m_ext_start = false;
-                return;
-            }
-            if (depth_image.getRawImage()==nullptr)
-            {
-                yCError(APPROACH_OBJECT_THREAD, "invalid image received");
+                yCError(APPROACH_OBJECT_THREAD, "no depth frame available");
                 m_ext_start = false;
                 return;
             }
+            if (coordsStamp >= 0)
+                yCDebug(APPROACH_OBJECT_THREAD, "Using depth frame %.3f s away from the detection", fabs(depth_stamp - coordsStamp));
 
             //transforming pixel coordinates in space coordinates wrt camera frame
             Vector tempPoint(4,1.0);
-            tempPoint[0] = (u - m_intrinsics.principalPointX) / m_intrinsics.focalLengthX * depth_image.pixel(u, v);
-            tempPoint[1] = (v - m_intrinsics.principalPointY) / m_intrinsics.focalLengthY * depth_image.pixel(u, v);
-            tempPoint[2] = depth_image.pixel(u, v);
+            tempPoint[0] = (u - m_intrinsics.principalPointX) / m_intrinsics.focalLengthX * m_depth_image.pixel(u, v);
+            tempPoint[1] = (v - m_intrinsics.principalPointY) / m_intrinsics.focalLengthY * m_depth_image.pixel(u, v);
+            tempPoint[2] = m_depth_image.pixel(u, v);
 
             //computing the transformation matrix from the camera to the base reference frame
             Matrix transform_mtrx;
@@ -316,10 +381,10 @@ void ApproachObjectThread::run()
             locObject.x=v_object_world[0];
             locObject.y=v_object_world[1];
         }
-        else if (m_coords->size() == 3) //absolute position of object
+        else if (m_target_coords.size() == 3) //absolute position of object
         {
-            locObject.x = m_coords->get(0).asFloat32();
-            locObject.y = m_coords->get(1).asFloat32();
+            locObject.x = m_target_coords[0];
+            locObject.y = m_target_coords[1];
         }
 
         calculateTargetLoc(locRobot, locObject, locTarget);
@@ -328,26 +393,31 @@ void ApproachObjectThread::run()
         yCInfo(APPROACH_OBJECT_THREAD,"Approaching object");
 
         yCInfo(APPROACH_OBJECT_THREAD,) << "Approach location:"<< locTarget.toString();
-        m_iNav2D->gotoTargetByAbsoluteLocation(locTarget);
+        SearchTelemetry::Timer navTimer(m_telemetry, "approach_navigation");
+        m_navStatus->goalSent();
+        if (!m_iNav2D->gotoTargetByAbsoluteLocation(locTarget))
+            m_navStatus->goalFailed();
 
         NavigationStatusEnum currentStatus;
-        m_iNav2D->getNavigationStatus(currentStatus);
+        m_navStatus->getNavigationStatus(currentStatus);
         while (currentStatus != navigation_status_goal_reached  && !m_ext_stop  )
         {
-            Time::delay(0.2);
-            m_iNav2D->getNavigationStatus(currentStatus);
+            m_navStatus->waitForStatusChange(currentStatus, 0.2);
 
             if (currentStatus == navigation_status_aborted)
             {
                 yCWarning(APPROACH_OBJECT_THREAD, "Navigation aborted.");
+                m_telemetry->increment("navigation_aborts");
                 m_iNav2D->stopNavigation();
 
                 yCInfo(APPROACH_OBJECT_THREAD,"Calculating new approach location");
                 if (calculateTargetLoc(locRobot, locObject, locTarget))
                 {
                     yCInfo(APPROACH_OBJECT_THREAD,) << "New approach location:"<< locTarget.toString();
-                    m_iNav2D->gotoTargetByAbsoluteLocation(locTarget);
-                    m_iNav2D->getNavigationStatus(currentStatus);   
+                    m_navStatus->goalSent();
+                    if (!m_iNav2D->gotoTargetByAbsoluteLocation(locTarget))
+                        m_navStatus->goalFailed();
+                    m_navStatus->getNavigationStatus(currentStatus);   
                 } 
                 else 
                 {
@@ -357,6 +427,8 @@ void ApproachObjectThread::run()
             }
         }
 
+        navTimer.stop();
+
         //look again for object
         if (!m_ext_stop)
         {
@@ -365,22 +437,29 @@ void ApproachObjectThread::run()
             else if (currentStatus == navigation_status_goal_reached)
                 yCInfo(APPROACH_OBJECT_THREAD,"Approaching location reached. Looking for object again");
                 
-            if(lookAgain(m_object))
+            SearchTelemetry::Timer lookTimer(m_telemetry, "look_again");
+            bool seen = lookAgain(object);
+            lookTimer.stop();
+            if(seen)
             {
                 Bottle* finderResult = m_object_finder_result_port.read(false); 
                 if(finderResult  != nullptr && !m_ext_stop)
                 {
-                    Bottle* new_coords = new Bottle;
-                    if (!getObjCoordinates(finderResult, new_coords))
+                    Stamp finderStamp;
+                    m_object_finder_result_port.getEnvelope(finderStamp);
+                    if (!getObjCoordinates(finderResult, object, m_found_coords))
                     {
-                        yCWarning(APPROACH_OBJECT_THREAD, "The Object Finder is not seeing any %s", m_object.c_str());
+                        yCWarning(APPROACH_OBJECT_THREAD, "The Object Finder is not seeing any %s", object.c_str());
                     }
                     else
                     {
                         yCInfo(APPROACH_OBJECT_THREAD,"Object approached");
                         Bottle&  toSend = m_output_coordinates_port.prepare();
                         toSend.clear();
-                        toSend = *new_coords;
+                        toSend.addFloat32(m_found_coords[0]);
+                        toSend.addFloat32(m_found_coords[1]);
+                        if (finderStamp.isValid())
+                            m_output_coordinates_port.setEnvelope(finderStamp);
                         m_output_coordinates_port.write();
                     }
                              
@@ -393,6 +472,7 @@ void ApproachObjectThread::run()
                 toSend.clear();
                 toSend.addString("object lost");
                 m_output_coordinates_port.write();
+                m_telemetry->increment("objects_lost");
             }
         }   
     } 
@@ -401,15 +481,23 @@ void ApproachObjectThread::run()
         if (!m_ext_stop)
         {
             yCInfo(APPROACH_OBJECT_THREAD,"Looking for object again");
-            if(lookAgain(m_object))
+            string object;
+            {
+                lock_guard<mutex> lock(m_coords_mutex);
+                object = m_object;
+            }
+            if(lookAgain(object))
             {
                 Bottle* finderResult = m_object_finder_result_port.read(false); 
                 if(finderResult  != nullptr)
                 {
-                    m_coords = new Bottle;
-                    if (!getObjCoordinates(finderResult, m_coords))
+                    Stamp finderStamp;
+                    m_object_finder_result_port.getEnvelope(finderStamp);
+                    lock_guard<mutex> lock(m_coords_mutex);
+                    m_coords_stamp = finderStamp.isValid() ? finderStamp.getTime() : -1.0;
+                    if (!getObjCoordinates(finderResult, object, m_coords))
                     {
-                        yCWarning(APPROACH_OBJECT_THREAD, "The Object Finder is not seeing any %s", m_object.c_str());
+                        yCWarning(APPROACH_OBJECT_THREAD, "The Object Finder is not seeing any %s", object.c_str());
                     }
                     else
                     {
@@ -429,6 +517,7 @@ void ApproachObjectThread::run()
                 toSend.clear();
                 toSend.addString("object lost");
                 m_output_coordinates_port.write();
+                m_telemetry->increment("objects_lost");
             }
         }
     }
@@ -501,14 +590,14 @@ bool ApproachObjectThread::lookAgain(string object )
 
 
 /****************************************************************/
-bool ApproachObjectThread::getObjCoordinates(Bottle* btl, Bottle* out)
+bool ApproachObjectThread::getObjCoordinates(Bottle* btl, const string& object, Vector& out)
 {
     double max_conf = 0.0;
     double x = -1.0, y;
     for (int i=0; i<btl->size(); i++)
     {
         Bottle* b = btl->get(i).asList();
-        if (b->get(0).asString() != m_object) //skip objects with another label
+        if (b->get(0).asString() != object) //skip objects with another label
             continue;
         
         if(b->get(1).asFloat32() > max_conf) //get the object with the max confidence
@@ -521,8 +610,9 @@ bool ApproachObjectThread::getObjCoordinates(Bottle* btl, Bottle* out)
     if (x<0)
         return false;
     
-    out->addFloat32(x);
-    out->addFloat32(y);
+    out.resize(2);
+    out[0] = x;
+    out[1] = y;
     return true;
 }
 
@@ -559,7 +649,7 @@ bool ApproachObjectThread::externalStop()
     m_ext_stop = true;
 
     NavigationStatusEnum currentStatus;
-    m_iNav2D->getNavigationStatus(currentStatus);
+    m_navStatus->getNavigationStatus(currentStatus);
     if (currentStatus == navigation_status_moving)
         m_iNav2D->stopNavigation();
 
@@ -581,19 +671,19 @@ bool ApproachObjectThread::externalResume()
 
 /****************************************************************/
 string ApproachObjectThread::getObject()
-{return m_object;} 
+{lock_guard<mutex> lock(m_coords_mutex); return m_object;} 
 
 
 /****************************************************************/
-Bottle* ApproachObjectThread::getCoords()
-{return m_coords;} 
+Vector ApproachObjectThread::getCoords()
+{lock_guard<mutex> lock(m_coords_mutex); return m_coords;} 
 
 
 /****************************************************************/
 void ApproachObjectThread::setObject(string& ob)
-{m_object = ob;}
+{lock_guard<mutex> lock(m_coords_mutex); m_object = ob;}
 
 
 /****************************************************************/
-void ApproachObjectThread::setCoords(Bottle* coo)
-{if(coo) m_coords = coo;}
\ No newline at end of file
+void ApproachObjectThread::setCoords(const Vector& coo)
+{lock_guard<mutex> lock(m_coords_mutex); m_coords = coo;}
\ No newline at end of file
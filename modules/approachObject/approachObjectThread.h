@@ -24,10 +24,14 @@
 #include <yarp/dev/IFrameTransform.h>
 #include <yarp/dev/INavigation2D.h>
 #include <yarp/sig/IntrinsicParams.h>
-#include <yarp/dev/IRGBDSensor.h> 
 #include <yarp/math/Math.h>
 #include <cmath>
+#include <mutex>
 
+#include "depthRingBuffer.h"
+#include "navStatusCache.h"
+#include "searchTelemetry.h"
+#include "cameraInfo.h"
 
 using namespace std;
 using namespace yarp::os;
@@ -44,7 +48,11 @@ private:
     bool                    m_ext_resume;
 
     string                  m_object;
-    Bottle*                 m_coords = new Bottle;
+    Vector                  m_coords;           //pixel (u v) or absolute (x y z) coordinates of the object
+    double                  m_coords_stamp;     //timestamp of the image where the object has been detected
+    mutex                   m_coords_mutex;     //m_object and m_coords are written by the input port callback
+    Vector                  m_target_coords;    //copy of m_coords used while approaching
+    Vector                  m_found_coords;     //coordinates found by the final look-again
     double                  m_safe_distance;
     double                  m_wait_for_search;
 
@@ -62,9 +70,10 @@ private:
     PolyDriver              m_tcPoly;
     IFrameTransform*        m_iTc{nullptr}; 
     PolyDriver              m_nav2DPoly;
-    INavigation2D*          m_iNav2D{nullptr}; 
-    PolyDriver              m_rgbdPoly;
-    IRGBDSensor*            m_iRgbd{nullptr}; 
+    INavigation2D*          m_iNav2D{nullptr};
+    NavStatusCache*         m_navStatus{nullptr}; 
+    SearchTelemetry*        m_telemetry{nullptr};
+    BufferedPort<ImageOf<float>> m_depth_port;  //depth stream only, the RGB one is never connected
 
     //Computation related attributes
     string                  m_world_frame_id;
@@ -72,6 +81,8 @@ private:
     string                  m_camera_frame_id; 
     Property                m_propIntrinsics;
     IntrinsicParams         m_intrinsics;   
+    DepthRingBuffer*        m_depth_buffer;
+    ImageOf<float>          m_depth_image;
     
     double                  m_deg_increase;
     int                     m_deg_increase_count;
@@ -84,17 +95,17 @@ public:
     virtual bool threadInit() override;
     virtual void threadRelease() override;
 
-    void exec(Bottle& b);
+    void exec(Bottle& b, double stamp);
     bool lookAgain(string object);
-    bool getObjCoordinates(Bottle* btl, Bottle* out);
+    bool getObjCoordinates(Bottle* btl, const string& object, Vector& out);
     bool calculateTargetLoc(Map2DLocation& locRobot, Map2DLocation& locObject, Map2DLocation& locTarget);
     bool externalStop();  
     bool externalResume();    
 
     string getObject();
-    Bottle* getCoords();
+    Vector getCoords();
     void setObject(string& ob);
-    void setCoords(Bottle* coo);
+    void setCoords(const Vector& coo);
 };
 
 #endif 
\ No newline at end of file
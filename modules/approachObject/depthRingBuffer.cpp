@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "depthRingBuffer.h"
+
+
+YARP_LOG_COMPONENT(DEPTH_RING_BUFFER, "r1_obr.approachObject.depthRingBuffer")
+
+
+/****************************************************************/
+DepthRingBuffer::DepthRingBuffer(double _period, BufferedPort<ImageOf<float>>* port, size_t size):
+    PeriodicThread(_period),
+    m_port(port),
+    m_frames(size > 0 ? size : 1),
+    m_head(0),
+    m_count(0)
+{
+}
+
+
+/****************************************************************/
+void DepthRingBuffer::run()
+{
+    ImageOf<float>* image = m_port->read(false);
+    if (image == nullptr || image->getRawImage() == nullptr)
+        return;
+
+    Stamp stamp;
+    m_port->getEnvelope(stamp);
+
+    double t = stamp.isValid() ? stamp.getTime() : Time::now();
+
+    lock_guard<mutex> lock(m_mutex);
+    if (m_count > 0)
+    {
+        size_t last = (m_head + m_frames.size() - 1) % m_frames.size();
+        if (m_frames[last].stamp == t)
+            return; //same frame as before, nothing new from the camera
+    }
+
+    //the slot keeps its buffer: copy() does not reallocate when the size does not change
+    DepthFrame& slot = m_frames[m_head];
+    slot.image.copy(*image);
+    slot.stamp = t;
+
+    m_head = (m_head + 1) % m_frames.size();
+    if (m_count < m_frames.size())
+        m_count++;
+}
+
+
+/****************************************************************/
+bool DepthRingBuffer::getNearest(double stamp, ImageOf<float>& out, double& frame_stamp)
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_count == 0)
+    {
+        yCWarning(DEPTH_RING_BUFFER, "No depth frame received yet");
+        return false;
+    }
+
+    size_t last = (m_head + m_frames.size() - 1) % m_frames.size();
+    size_t best = last;
+    if (stamp >= 0)
+    {
+        double best_diff = fabs(m_frames[last].stamp - stamp);
+        for (size_t i=1; i<m_count; i++)
+        {
+            size_t idx = (last + m_frames.size() - i) % m_frames.size();
+            double diff = fabs(m_frames[idx].stamp - stamp);
+            if (diff < best_diff)
+            {
+                best_diff = diff;
+                best = idx;
+            }
+        }
+    }
+
+    out.copy(m_frames[best].image);
+    frame_stamp = m_frames[best].stamp;
+
+    return true;
+}
+
+
+/****************************************************************/
+void DepthRingBuffer::clear()
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_head = 0;
+    m_count = 0;
+}
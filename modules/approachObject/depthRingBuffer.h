@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef DEPTH_RING_BUFFER_H
+#define DEPTH_RING_BUFFER_H
+
+#include <yarp/os/all.h>
+#include <yarp/sig/Image.h>
+#include <vector>
+#include <mutex>
+#include <cmath>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+class DepthRingBuffer : public PeriodicThread
+{
+private:
+    struct DepthFrame
+    {
+        ImageOf<float>  image;
+        double          stamp{-1.0};
+    };
+
+    BufferedPort<ImageOf<float>>* m_port;
+    vector<DepthFrame>      m_frames;       //allocated once, the images are reused frame after frame
+    size_t                  m_head;
+    size_t                  m_count;
+    mutex                   m_mutex;
+
+public:
+    DepthRingBuffer(double _period, BufferedPort<ImageOf<float>>* port, size_t size);
+    ~DepthRingBuffer() = default;
+
+    virtual void run() override;
+
+    //copies in "out" the depth frame whose timestamp is the closest to "stamp" (the latest one if stamp<0)
+    bool getNearest(double stamp, ImageOf<float>& out, double& frame_stamp);
+    void clear();
+};
+
+#endif
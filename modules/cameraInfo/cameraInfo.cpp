@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include "cameraInfo.h"
+#include <yarp/dev/GenericVocabs.h>
+
+
+YARP_LOG_COMPONENT(CAMERA_INFO, "r1_obr.cameraInfo")
+
+
+/****************************************************************/
+bool CameraInfo::open(const string& local, const string& remote)
+{
+    m_remote = remote;
+    if (!m_rpc.open(local))
+    {
+        yCError(CAMERA_INFO) << "Cannot open port" << local;
+        return false;
+    }
+    if (!Network::connect(local, remote))
+    {
+        yCError(CAMERA_INFO) << "Cannot connect" << local << "to" << remote;
+        m_rpc.close();
+        return false;
+    }
+
+    return true;
+}
+
+
+/****************************************************************/
+void CameraInfo::close()
+{
+    if (!m_rpc.isClosed())
+    {
+        m_rpc.interrupt();
+        m_rpc.close();
+    }
+}
+
+
+/****************************************************************/
+bool CameraInfo::ask(yarp::conf::vocab32_t params, yarp::conf::vocab32_t what, Bottle& reply)
+{
+    //<params> get <what> -> <params> is <what> <values...>, or fail
+    Bottle request;
+    request.addVocab32(params);
+    request.addVocab32(VOCAB_GET);
+    request.addVocab32(what);
+    reply.clear();
+    if (!m_rpc.write(request, reply) || reply.size() < 4 || reply.get(0).asVocab32() == VOCAB_FAILED)
+    {
+        yCError(CAMERA_INFO) << "No reply from" << m_remote << "to" << request.toString();
+        return false;
+    }
+
+    return true;
+}
+
+
+/****************************************************************/
+bool CameraInfo::getRgbFOV(double& horizontalFov, double& verticalFov)
+{
+    Bottle reply;
+    if (!ask(VOCAB_RGB_VISUAL_PARAMS, VOCAB_FOV, reply))
+        return false;
+
+    horizontalFov = reply.get(3).asFloat64();
+    verticalFov = reply.size() > 4 ? reply.get(4).asFloat64() : 0.0;
+    return reply.size() > 4;
+}
+
+
+/****************************************************************/
+bool CameraInfo::getDepthIntrinsicParam(Property& intrinsics)
+{
+    Bottle reply;
+    if (!ask(VOCAB_DEPTH_VISUAL_PARAMS, VOCAB_INTRINSIC_PARAM, reply))
+        return false;
+
+    intrinsics.fromString(reply.get(3).toString());
+    return intrinsics.check("focalLengthX") && intrinsics.check("principalPointX");
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#ifndef CAMERA_INFO_H
+#define CAMERA_INFO_H
+
+#include <yarp/os/all.h>
+#include <yarp/dev/IVisualParams.h>
+#include <string>
+
+using namespace std;
+using namespace yarp::os;
+
+// Metadata of a RGBD camera (FOV, intrinsics) asked on the rpc port of its network wrapper,
+// without opening a RGBDSensorClient: no image stream is connected.
+// The requests are the ones of the IRgbVisualParams and IDepthVisualParams interfaces.
+class CameraInfo
+{
+private:
+    RpcClient               m_rpc;
+    string                  m_remote;
+
+public:
+    CameraInfo() = default;
+    ~CameraInfo() = default;
+
+    bool open(const string& local, const string& remote);
+    void close();
+
+    bool getRgbFOV(double& horizontalFov, double& verticalFov);
+    bool getDepthIntrinsicParam(Property& intrinsics);
+
+private:
+    bool ask(yarp::conf::vocab32_t params, yarp::conf::vocab32_t what, Bottle& reply);
+};
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "backProjector.h"
+
+
+YARP_LOG_COMPONENT(BACK_PROJECTOR, "r1_obr.detectionLifter.backProjector")
+
+
+/****************************************************************/
+BackProjector::BackProjector(const IntrinsicParams& intrinsics, Searchable& config):
+    m_intrinsics(intrinsics)
+{
+    m_depth_min       = config.check("depth_min", Value(0.1)).asFloat32();
+    m_depth_max       = config.check("depth_max", Value(6.0)).asFloat32();
+    m_depth_tolerance = config.check("depth_tolerance", Value(0.15)).asFloat32();
+    m_depth_noise     = config.check("depth_noise", Value(0.0025)).asFloat32();
+    m_box_shrink      = config.check("box_shrink", Value(0.5)).asFloat32();
+    m_stride          = config.check("pixel_stride", Value(2)).asInt32();
+    if (m_stride < 1)
+        m_stride = 1;
+}
+
+
+/****************************************************************/
+void BackProjector::updateRays(size_t width, size_t height)
+{
+    if (m_ray_x.size() == width && m_ray_y.size() == height)
+        return;
+
+    m_ray_x.resize(width);
+    m_ray_y.resize(height);
+    for (size_t u=0; u<width; u++)
+        m_ray_x[u] = (u - m_intrinsics.principalPointX) / m_intrinsics.focalLengthX;
+    for (size_t v=0; v<height; v++)
+        m_ray_y[v] = (v - m_intrinsics.principalPointY) / m_intrinsics.focalLengthY;
+    m_depths.reserve(width*height);
+}
+
+
+/****************************************************************/
+int BackProjector::lift(const ImageOf<float>& depth, double u0, double v0, double u1, double v1, Vector& mean, Matrix& cov)
+{
+    int width = depth.width();
+    int height = depth.height();
+    updateRays(width, height);
+
+    //keep the central part of the box, the borders are mostly background
+    double cu = (u0 + u1) / 2, cv = (v0 + v1) / 2;
+    double hu = (u1 - u0) * m_box_shrink / 2, hv = (v1 - v0) * m_box_shrink / 2;
+    int umin = max(0, (int)floor(cu - hu)), umax = min(width - 1, (int)ceil(cu + hu));
+    int vmin = max(0, (int)floor(cv - hv)), vmax = min(height - 1, (int)ceil(cv + hv));
+    if (umin > umax || vmin > vmax)
+        return 0;
+
+    //first pass: median depth of the box
+    m_depths.clear();
+    for (int v=vmin; v<=vmax; v+=m_stride)
+    {
+        const float* row = reinterpret_cast<const float*>(depth.getRow(v));
+        for (int u=umin; u<=umax; u+=m_stride)
+        {
+            float z = row[u];
+            if (z > m_depth_min && z < m_depth_max)
+                m_depths.push_back(z);
+        }
+    }
+    if (m_depths.empty())
+        return 0;
+
+    auto mid = m_depths.begin() + m_depths.size()/2;
+    nth_element(m_depths.begin(), mid, m_depths.end());
+    float median = *mid;
+    float zlow = median - m_depth_tolerance, zhigh = median + m_depth_tolerance;
+
+    //second pass: first and second moments of the points on the object.
+    //The loop has no branches (invalid points get weight 0) so that it can be vectorized
+    //Rows are summed in float and accumulated in double to limit the rounding errors
+    double n{0}, sx{0}, sy{0}, sz{0}, sxx{0}, sxy{0}, sxz{0}, syy{0}, syz{0}, szz{0};
+    for (int v=vmin; v<=vmax; v+=m_stride)
+    {
+        const float* row = reinterpret_cast<const float*>(depth.getRow(v));
+        const float ry = m_ray_y[v];
+        float rn{0}, rx{0}, rz{0}, rxx{0}, rxz{0}, rzz{0};
+        for (int u=umin; u<=umax; u+=m_stride)
+        {
+            float z = row[u];
+            bool valid = z > zlow && z < zhigh;     //false for NaN too
+            z = valid ? z : 0.0f;
+            float x = m_ray_x[u] * z;
+            rn  += valid ? 1.0f : 0.0f;
+            rx  += x;   rz  += z;
+            rxx += x*x; rxz += x*z; rzz += z*z;
+        }
+        //all the points of a row share the same ray_y, so y = ry*z
+        n   += rn;
+        sx  += rx;      sy  += ry*rz;       sz  += rz;
+        sxx += rxx;     sxy += ry*rxz;      sxz += rxz;
+        syy += ry*ry*rzz;   syz += ry*rzz;  szz += rzz;
+    }
+    if (n < 1)
+        return 0;
+
+    mean.resize(3);
+    mean[0] = sx/n; mean[1] = sy/n; mean[2] = sz/n;
+
+    cov.resize(3,3);
+    cov(0,0) = sxx/n - mean[0]*mean[0];
+    cov(0,1) = sxy/n - mean[0]*mean[1];
+    cov(0,2) = sxz/n - mean[0]*mean[2];
+    cov(1,1) = syy/n - mean[1]*mean[1];
+    cov(1,2) = syz/n - mean[1]*mean[2];
+    cov(2,2) = szz/n - mean[2]*mean[2];
+    cov(1,0) = cov(0,1);
+    cov(2,0) = cov(0,2);
+    cov(2,1) = cov(1,2);
+
+    //sensor noise along the optical axis, growing with the square of the distance
+    double sigma_z = m_depth_noise * mean[2] * mean[2];
+    cov(2,2) += sigma_z * sigma_z;
+
+    return (int)n;
+}
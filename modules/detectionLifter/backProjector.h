@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef BACK_PROJECTOR_H
+#define BACK_PROJECTOR_H
+
+#include <yarp/os/all.h>
+#include <yarp/sig/Image.h>
+#include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
+#include <yarp/sig/IntrinsicParams.h>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+class BackProjector
+{
+private:
+    IntrinsicParams         m_intrinsics;
+    double                  m_depth_min;
+    double                  m_depth_max;
+    double                  m_depth_tolerance;  //points farther than this from the median depth of the box are background
+    double                  m_depth_noise;      //std dev of the depth noise is m_depth_noise*z^2
+    double                  m_box_shrink;       //fraction of the bounding box (around its center) that is used
+    int                     m_stride;
+
+    //normalized ray of each column and row: x = m_ray_x[u]*z, y = m_ray_y[v]*z
+    vector<float>           m_ray_x;
+    vector<float>           m_ray_y;
+    vector<float>           m_depths;           //preallocated scratch buffer for the median
+
+public:
+    BackProjector(const IntrinsicParams& intrinsics, Searchable& config);
+    ~BackProjector() = default;
+
+    //lifts the pixels in the box [u0,u1]x[v0,v1] of the depth image to a 3D point in camera frame
+    //mean is a 3D vector, cov a 3x3 matrix. Returns the number of points used (0 if the box has no valid depth)
+    int lift(const ImageOf<float>& depth, double u0, double v0, double u1, double v1, Vector& mean, Matrix& cov);
+
+private:
+    void updateRays(size_t width, size_t height);
+};
+
+#endif
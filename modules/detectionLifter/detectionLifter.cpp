@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "detectionLifter.h"
+
+
+YARP_LOG_COMPONENT(DETECTION_LIFTER, "r1_obr.detectionLifter")
+
+
+/****************************************************************/
+DetectionLifter::DetectionLifter() :
+    m_period(1.0),
+    m_depth_buffer(nullptr),
+    m_back_projector(nullptr)
+{
+    m_detections_port_name  = "/detectionLifter/detections:i";
+    m_output_port_name      = "/detectionLifter/detections3D:o";
+    m_camera_frame_id       = "depth_center";
+    m_world_frame_id        = "map";
+    m_max_sync_delay        = 0.1;
+    m_patch_half_size       = 5.0;
+    m_min_points            = 10;
+}
+
+
+/****************************************************************/
+bool DetectionLifter::configure(ResourceFinder &rf)
+{
+    // ------------ Generic config ------------ //
+    if(rf.check("period"))          {m_period = rf.find("period").asFloat32();}
+    if(rf.check("camera_frame_id")) {m_camera_frame_id = rf.find("camera_frame_id").asString();}
+    if(rf.check("world_frame_id"))  {m_world_frame_id = rf.find("world_frame_id").asString();}
+    if(rf.check("max_sync_delay"))  {m_max_sync_delay = rf.find("max_sync_delay").asFloat32();}
+    if(rf.check("patch_half_size")) {m_patch_half_size = rf.find("patch_half_size").asFloat32();}
+    if(rf.check("min_points"))      {m_min_points = rf.find("min_points").asInt32();}
+
+
+    // ------------ TransformClient config ------------ //
+    Property tcProp;
+    //default
+    tcProp.put("device", "frameTransformClient");
+    tcProp.put("ft_client_prefix", "/detectionLifter");
+    tcProp.put("local_rpc", "/detectionLifter/ftClient.rpc");
+    bool okTransformRf = rf.check("TRANSFORM_CLIENT");
+    if(!okTransformRf)
+    {
+        yCWarning(DETECTION_LIFTER,"TRANSFORM_CLIENT section missing in ini file Using default values");
+        tcProp.put("filexml_option","ftc_yarp_only.xml");
+    }
+    else {
+        Searchable &tf_config = rf.findGroup("TRANSFORM_CLIENT");
+        if (tf_config.check("ft_client_prefix")) {
+            tcProp.put("ft_client_prefix", tf_config.find("ft_client_prefix").asString());
+        }
+        if (tf_config.check("ft_server_prefix")) {
+            tcProp.put("ft_server_prefix", tf_config.find("ft_server_prefix").asString());
+        }
+        if(tf_config.check("filexml_option") && !(tf_config.check("testxml_from") || tf_config.check("testxml_context")))
+        {
+            tcProp.put("filexml_option", tf_config.find("filexml_option").asString());
+        }
+        else if(!tf_config.check("filexml_option") && (tf_config.check("testxml_from") && tf_config.check("testxml_context")))
+        {
+            tcProp.put("testxml_from", tf_config.find("testxml_from").asString());
+            tcProp.put("testxml_context", tf_config.find("testxml_context").asString());
+        }
+        else
+        {
+            yCError(DETECTION_LIFTER,"TRANSFORM_CLIENT is missing information about the frameTransformClient device configuration. Check your config. RETURNING");
+            return false;
+        }
+    }
+    m_tcPoly.open(tcProp);
+    if(!m_tcPoly.isValid())
+    {
+        yCError(DETECTION_LIFTER,"Error opening PolyDriver check parameters");
+        return false;
+    }
+    m_tcPoly.view(m_iTc);
+    if(!m_iTc)
+    {
+        yCError(DETECTION_LIFTER,"Error opening iFrameTransform interface. Device not available");
+        return false;
+    }
+
+
+    // --------- RGBDSensor config --------- //
+    Property rgbdProp;
+    // Prepare default prop object
+    rgbdProp.put("device",          "RGBDSensorClient");
+    rgbdProp.put("localImagePort",  "/detectionLifter/clientRgbPort:i");
+    rgbdProp.put("localDepthPort",  "/detectionLifter/clientDepthPort:i");
+    rgbdProp.put("localRpcPort",    "/detectionLifter/clientRpcPort");
+    rgbdProp.put("remoteImagePort", "/SIM_CER_ROBOT/depthCamera/rgbImage:o");
+    rgbdProp.put("remoteDepthPort", "/SIM_CER_ROBOT/depthCamera/depthImage:o");
+    rgbdProp.put("remoteRpcPort",   "/SIM_CER_ROBOT/depthCamera/rpc:i");
+    rgbdProp.put("ImageCarrier",    "mjpeg");
+    rgbdProp.put("DepthCarrier",    "fast_tcp");
+    bool okRgbdRf = rf.check("RGBD_SENSOR_CLIENT");
+    if(!okRgbdRf)
+    {
+        yCWarning(DETECTION_LIFTER,"RGBD_SENSOR_CLIENT section missing in ini file. Using default values");
+    }
+    else
+    {
+        Searchable& rgbd_config = rf.findGroup("RGBD_SENSOR_CLIENT");
+        if(rgbd_config.check("device")) {rgbdProp.put("device", rgbd_config.find("device").asString());}
+        if(rgbd_config.check("localImagePort")) {rgbdProp.put("localImagePort", rgbd_config.find("localImagePort").asString());}
+        if(rgbd_config.check("localDepthPort")) {rgbdProp.put("localDepthPort", rgbd_config.find("localDepthPort").asString());}
+        if(rgbd_config.check("localRpcPort")) {rgbdProp.put("localRpcPort", rgbd_config.find("localRpcPort").asString());}
+        if(rgbd_config.check("remoteImagePort")) {rgbdProp.put("remoteImagePort", rgbd_config.find("remoteImagePort").asString());}
+        if(rgbd_config.check("remoteDepthPort")) {rgbdProp.put("remoteDepthPort", rgbd_config.find("remoteDepthPort").asString());}
+        if(rgbd_config.check("remoteRpcPort")) {rgbdProp.put("remoteRpcPort", rgbd_config.find("remoteRpcPort").asString());}
+        if(rgbd_config.check("ImageCarrier")) {rgbdProp.put("ImageCarrier", rgbd_config.find("ImageCarrier").asString());}
+        if(rgbd_config.check("DepthCarrier")) {rgbdProp.put("DepthCarrier", rgbd_config.find("DepthCarrier").asString());}
+    }
+
+    m_rgbdPoly.open(rgbdProp);
+    if(!m_rgbdPoly.isValid())
+    {
+        yCError(DETECTION_LIFTER,"Error opening PolyDriver check parameters");
+        return false;
+    }
+    m_rgbdPoly.view(m_iRgbd);
+    if(!m_iRgbd)
+    {
+        yCError(DETECTION_LIFTER,"Error opening iRGBD interface. Device not available");
+        return false;
+    }
+
+    //get parameters data from the camera
+    Property propIntrinsics;
+    if(!m_iRgbd->getDepthIntrinsicParam(propIntrinsics))
+    {
+        yCError(DETECTION_LIFTER,"Cannot get the depth intrinsic parameters");
+        return false;
+    }
+    yCInfo(DETECTION_LIFTER) << "Depth Intrinsics:" << propIntrinsics.toString();
+    IntrinsicParams intrinsics;
+    intrinsics.fromProperty(propIntrinsics);
+
+    //the RGB image is never used
+    Network::disconnect(rgbdProp.find("remoteImagePort").asString(), rgbdProp.find("localImagePort").asString());
+
+
+    // --------- Depth frames buffer --------- //
+    int depthBufferSize = rf.check("depth_buffer_size") ? rf.find("depth_buffer_size").asInt32() : 15;
+    double depthBufferPeriod = rf.check("depth_buffer_period") ? rf.find("depth_buffer_period").asFloat32() : 0.033;
+    m_depth_buffer = new DepthRingBuffer(depthBufferPeriod, m_iRgbd, depthBufferSize);
+    if (!m_depth_buffer->start())
+    {
+        yCError(DETECTION_LIFTER,"Error starting the depth frames buffer");
+        return false;
+    }
+
+    m_back_projector = new BackProjector(intrinsics, rf);
+
+
+    // ------------ Open ports ------------ //
+    if(rf.check("output_port")) {m_output_port_name = rf.find("output_port").asString();}
+    if(!m_output_port.open(m_output_port_name))
+    {
+        yCError(DETECTION_LIFTER) << "Cannot open port" << m_output_port_name;
+        return false;
+    }
+    else
+        yCInfo(DETECTION_LIFTER) << "opened port" << m_output_port_name;
+
+    if(rf.check("detections_port")) {m_detections_port_name = rf.find("detections_port").asString();}
+    m_detections_port.useCallback(*this);
+    if(!m_detections_port.open(m_detections_port_name))
+    {
+        yCError(DETECTION_LIFTER) << "Cannot open port" << m_detections_port_name;
+        return false;
+    }
+    else
+        yCInfo(DETECTION_LIFTER) << "opened port" << m_detections_port_name;
+
+
+    return true;
+}
+
+
+/****************************************************************/
+bool DetectionLifter::close()
+{
+    if (!m_detections_port.isClosed())
+    {
+        m_detections_port.disableCallback();
+        m_detections_port.close();
+    }
+
+    if (!m_output_port.isClosed())
+        m_output_port.close();
+
+    if(m_depth_buffer)
+    {
+        m_depth_buffer->stop();
+        delete m_depth_buffer;
+        m_depth_buffer = nullptr;
+    }
+
+    if(m_back_projector)
+    {
+        delete m_back_projector;
+        m_back_projector = nullptr;
+    }
+
+    if(m_tcPoly.isValid())
+        m_tcPoly.close();
+
+    if(m_rgbdPoly.isValid())
+        m_rgbdPoly.close();
+
+    return true;
+}
+
+
+/****************************************************************/
+double DetectionLifter::getPeriod()
+{
+    return m_period;
+}
+
+
+/****************************************************************/
+bool DetectionLifter::updateModule()
+{
+    if (isStopping())
+        return false;
+
+    return true;
+}
+
+
+/****************************************************************/
+void DetectionLifter::onRead(Bottle& b)
+{
+    //the envelope carries the timestamp of the image where the objects have been detected
+    Stamp stamp;
+    m_detections_port.getEnvelope(stamp);
+    double detStamp = stamp.isValid() ? stamp.getTime() : -1.0;
+
+    Bottle& out = m_output_port.prepare();
+    out.clear();
+
+    if (b.size() > 0 && b.get(0).isList())
+    {
+        double depthStamp;
+        Matrix camera2world;
+        if (!m_depth_buffer->getNearest(detStamp, m_depth_image, depthStamp))
+        {
+            m_output_port.unprepare();
+            return;
+        }
+        if (detStamp >= 0 && fabs(depthStamp - detStamp) > m_max_sync_delay)
+        {
+            yCWarning(DETECTION_LIFTER, "No depth frame within %.3f s from the detections (nearest is %.3f s away)", m_max_sync_delay, fabs(depthStamp - detStamp));
+            m_output_port.unprepare();
+            return;
+        }
+        if (!m_iTc->getTransform(m_camera_frame_id, m_world_frame_id, camera2world))
+        {
+            yCError(DETECTION_LIFTER) << "Unable to find the transformation from" << m_camera_frame_id << "to" << m_world_frame_id;
+            m_output_port.unprepare();
+            return;
+        }
+
+        for (int i=0; i<b.size(); i++)
+        {
+            Bottle* det = b.get(i).asList();
+            if (det && det->size() >= 4)
+                liftDetection(det, camera2world, out);
+        }
+    }
+
+    if (out.size() == 0)
+        out.addString("nothing");
+
+    if (stamp.isValid())
+        m_output_port.setEnvelope(stamp);
+    m_output_port.write();
+}
+
+
+/****************************************************************/
+bool DetectionLifter::liftDetection(Bottle* det, const Matrix& camera2world, Bottle& out)
+{
+    double u = det->get(2).asFloat32();
+    double v = det->get(3).asFloat32();
+
+    //detections without bounding box are lifted using a small patch around their center
+    double u0 = u - m_patch_half_size, v0 = v - m_patch_half_size;
+    double u1 = u + m_patch_half_size, v1 = v + m_patch_half_size;
+    if (det->size() >= 8)
+    {
+        u0 = det->get(4).asFloat32();
+        v0 = det->get(5).asFloat32();
+        u1 = det->get(6).asFloat32();
+        v1 = det->get(7).asFloat32();
+    }
+
+    Vector mean;
+    Matrix cov;
+    int points = m_back_projector->lift(m_depth_image, u0, v0, u1, v1, mean, cov);
+    if (points < m_min_points)
+        return false;
+
+    //position and covariance in world frame
+    Vector p(4, 1.0);
+    p[0] = mean[0]; p[1] = mean[1]; p[2] = mean[2];
+    Vector pWorld = camera2world * p;
+    Matrix rot = camera2world.submatrix(0, 2, 0, 2);
+    Matrix covWorld = rot * cov * rot.transposed();
+
+    Bottle& o = out.addList();
+    o.addString(det->get(0).asString());
+    o.addFloat32(det->get(1).asFloat32());
+    o.addFloat32(u);
+    o.addFloat32(v);
+    Bottle& pos = o.addList();
+    pos.addFloat32(pWorld[0]);
+    pos.addFloat32(pWorld[1]);
+    pos.addFloat32(pWorld[2]);
+    Bottle& c = o.addList();
+    for (int r=0; r<3; r++)
+        for (int k=0; k<3; k++)
+            c.addFloat32(covWorld(r, k));
+    o.addInt32(points);
+
+    return true;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef DETECTION_LIFTER_H
+#define DETECTION_LIFTER_H
+
+#include <yarp/os/all.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/IFrameTransform.h>
+#include <yarp/dev/IRGBDSensor.h>
+#include <yarp/sig/IntrinsicParams.h>
+#include <yarp/math/Math.h>
+#include <cmath>
+
+#include "depthRingBuffer.h"
+#include "backProjector.h"
+
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::sig;
+using namespace yarp::math;
+
+class DetectionLifter : public RFModule, public TypedReaderCallback<Bottle>
+{
+private:
+    double                      m_period;
+
+    //Ports
+    BufferedPort<Bottle>        m_detections_port;
+    string                      m_detections_port_name;
+    BufferedPort<Bottle>        m_output_port;
+    string                      m_output_port_name;
+
+    //Devices
+    PolyDriver                  m_tcPoly;
+    IFrameTransform*            m_iTc{nullptr};
+    PolyDriver                  m_rgbdPoly;
+    IRGBDSensor*                m_iRgbd{nullptr};
+
+    //Lifting
+    DepthRingBuffer*            m_depth_buffer;
+    BackProjector*              m_back_projector;
+    ImageOf<float>              m_depth_image;
+    string                      m_camera_frame_id;
+    string                      m_world_frame_id;
+    double                      m_max_sync_delay;
+    double                      m_patch_half_size;
+    int                         m_min_points;
+
+public:
+    DetectionLifter();
+    virtual bool configure(ResourceFinder &rf);
+    virtual bool close();
+    virtual double getPeriod();
+    virtual bool updateModule();
+
+    using TypedReaderCallback<Bottle>::onRead;
+    void onRead(Bottle& btl) override;
+
+private:
+    bool liftDetection(Bottle* det, const Matrix& camera2world, Bottle& out);
+};
+
+#endif
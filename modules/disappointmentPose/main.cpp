@@ -27,6 +27,8 @@
 #include <yarp/os/Port.h>
 #include <yarp/os/RFModule.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
+#include <mutex>
+#include "poseController.h"
 
 YARP_LOG_COMPONENT(DISAPPOINTMENT_POSE, "r1_obr.disappointmentPose")
 
@@ -37,18 +39,19 @@ using namespace std;
 class DisappointmentPose : public RFModule, public TypedReaderCallback<Bottle>
 {
 private:
-    //Polydriver
-    PolyDriver           m_drivers[3];
-    IControlMode*        m_ictrlmode[3];  
-    IPositionControl*    m_iposctrl[3];   \
+    //right_arm, left_arm, head and the "disappointment" pose
+    PoseController       m_body;
+    double               m_timeout;
+
+    //end of the motion, checked by updateModule so that the callback does not wait for it
+    mutex                m_motion_mutex;
+    future<bool>         m_motion_done;
 
     //Port
     BufferedPort<Bottle> m_input_port;
     string               m_input_port_name;
 
-    Bottle               m_right_arm_pos;
-    Bottle               m_left_arm_pos;
-    Bottle               m_head_pos;
+    Property             m_pose;
 
     double               m_period;
 
@@ -67,15 +70,15 @@ public:
     void onRead(Bottle& btl) override;
 
     void setPosition();
-    void setPosCtrlMode(const int part);
 };
 
-DisappointmentPose::DisappointmentPose()
+DisappointmentPose::DisappointmentPose() :
+    m_timeout(10.0)
 {
     //Default is the navigation position
-    m_right_arm_pos.fromString("-9.0 9.0 -10.0 50.0 0.0 0.0 0.0 0.0");
-    m_left_arm_pos.fromString("-9.0 9.0 -10.0 50.0 0.0 0.0 0.0 0.0");
-    m_head_pos.fromString("0.0 0.0");
+    m_pose.put("right_arm_pos", "-9.0 9.0 -10.0 50.0 0.0 0.0 0.0 0.0");
+    m_pose.put("left_arm_pos", "-9.0 9.0 -10.0 50.0 0.0 0.0 0.0 0.0");
+    m_pose.put("head_pos", "0.0 0.0");
 }
 
 
@@ -84,6 +87,7 @@ bool DisappointmentPose::configure(ResourceFinder &rf)
     
     //Generic config
     if(rf.check("period")) {m_period = rf.find("period").asFloat32();}
+    if(rf.check("motion_timeout")) {m_timeout = rf.find("motion_timeout").asFloat32();}
     string robot=rf.check("robot",Value("cer")).asString();
 
 
@@ -107,70 +111,37 @@ bool DisappointmentPose::configure(ResourceFinder &rf)
     {
         Searchable& config = rf.findGroup("ACTIVE");
         if(config.check("right_arm_pos")) 
-            m_right_arm_pos.fromString(config.find("right_arm_pos").asString());
+            m_pose.put("right_arm_pos", config.find("right_arm_pos").asString());
         if(config.check("left_arm_pos")) 
-            m_left_arm_pos.fromString(config.find("left_arm_pos").asString());
+            m_pose.put("left_arm_pos", config.find("left_arm_pos").asString());
         if(config.check("head_pos")) 
-            m_head_pos.fromString(config.find("head_pos").asString());
+            m_pose.put("head_pos", config.find("head_pos").asString());
     }
 
     
     // Polydriver config
-    Property prop;
-
-    prop.put("device","remote_controlboard");
-    prop.put("local","/disappointmentPose/right_arm");
-    prop.put("remote","/"+robot+"/right_arm");
-    if (!m_drivers[0].open(prop))
-    {
-        yCError(DISAPPOINTMENT_POSE,"Unable to connect to %s",("/"+robot+"/right_arm").c_str());
-        close();
-        return false;
-    }
-    prop.clear();
-    prop.put("device","remote_controlboard");
-    prop.put("local","/disappointmentPose/left_arm");
-    prop.put("remote","/"+robot+"/left_arm");
-    if (!m_drivers[1].open(prop))
-    {
-        yCError(DISAPPOINTMENT_POSE,"Unable to connect to %s",("/"+robot+"/left_arm").c_str());
-        close();
-        return false;
-    }
-    prop.clear();
-    prop.put("device","remote_controlboard");
-    prop.put("local","/disappointmentPose/head");
-    prop.put("remote","/"+robot+"/head");
-    if (!m_drivers[2].open(prop))
+    if (!m_body.open(robot, "/disappointmentPose", {"right_arm", "left_arm", "head"}))
     {
-        yCError(DISAPPOINTMENT_POSE,"Unable to connect to %s",("/"+robot+"/head").c_str());
+        yCError(DISAPPOINTMENT_POSE,"Unable to connect to the parts of %s", robot.c_str());
         close();
         return false;
     }
 
-    m_drivers[0].view(m_iposctrl[0]);
-    m_drivers[1].view(m_iposctrl[1]);
-    m_drivers[2].view(m_iposctrl[2]);
-    if(!m_iposctrl[0] || !m_iposctrl[1] || !m_iposctrl[2] )
-    {
-        yCError(DISAPPOINTMENT_POSE,"Error opening iPositionControl interfaces. Devices not available");
+    if (!m_body.addPose("disappointment", m_pose))
         return false;
-    }
-
-    m_drivers[0].view(m_ictrlmode[0]);
-    m_drivers[1].view(m_ictrlmode[1]);
-    m_drivers[2].view(m_ictrlmode[2]);
-    if(!m_ictrlmode[0] || !m_ictrlmode[1] || !m_ictrlmode[2])
-    {
-        yCError(DISAPPOINTMENT_POSE,"Error opening iControlMode interfaces. Devices not available");
-        return false;
-    }
 
     return true;
 }
 
 bool DisappointmentPose::updateModule()
 {
+    lock_guard<mutex> lock(m_motion_mutex);
+    if (m_motion_done.valid() && m_motion_done.wait_for(chrono::seconds(0)) == future_status::ready)
+    {
+        if (!m_motion_done.get())
+            yCWarning(DISAPPOINTMENT_POSE,"Disappointment pose not reached in %.1f seconds", m_timeout);
+    }
+
     return true;
 }
 
@@ -181,71 +152,40 @@ double DisappointmentPose::getPeriod()
 
 void DisappointmentPose::onRead(Bottle& b) 
 {
-    
     yCInfo(DISAPPOINTMENT_POSE,"Received something. Not a good thing probably. Therefore I am setting a disappointment pose");
     setPosition();
 }
 
-void DisappointmentPose::setPosCtrlMode(const int part)
-{
-    int NUMBER_OF_JOINTS;
-    m_iposctrl[part]->getAxes(&NUMBER_OF_JOINTS);
-    for (int i_joint=0; i_joint < NUMBER_OF_JOINTS; i_joint++){ m_ictrlmode[part]->setControlMode(i_joint, VOCAB_CM_POSITION); } 
-}
-
-
 void DisappointmentPose::setPosition()
 {    
-    for (int i = 0 ; i<=2 ; i++)
+    //one command per part, sent to all the parts together
+    if (!m_body.goToPose("disappointment"))
     {
-        setPosCtrlMode(i);
+        yCError(DISAPPOINTMENT_POSE,"Cannot set the disappointment pose");
+        return;
     }
-    
-    //right arm
-    m_iposctrl[0]->positionMove(0, m_right_arm_pos.get(0).asFloat32());
-    m_iposctrl[0]->positionMove(1, m_right_arm_pos.get(1).asFloat32());
-    m_iposctrl[0]->positionMove(2, m_right_arm_pos.get(2).asFloat32());
-    m_iposctrl[0]->positionMove(3, m_right_arm_pos.get(3).asFloat32());
-    m_iposctrl[0]->positionMove(4, m_right_arm_pos.get(4).asFloat32());
-    m_iposctrl[0]->positionMove(5, m_right_arm_pos.get(5).asFloat32());
-    m_iposctrl[0]->positionMove(6, m_right_arm_pos.get(6).asFloat32());
-    m_iposctrl[0]->positionMove(7, m_right_arm_pos.get(7).asFloat32());
-    
-    //left arm
-    m_iposctrl[1]->positionMove(0, m_left_arm_pos.get(0).asFloat32());
-    m_iposctrl[1]->positionMove(1, m_left_arm_pos.get(1).asFloat32());
-    m_iposctrl[1]->positionMove(2, m_left_arm_pos.get(2).asFloat32());
-    m_iposctrl[1]->positionMove(3, m_left_arm_pos.get(3).asFloat32());
-    m_iposctrl[1]->positionMove(4, m_left_arm_pos.get(4).asFloat32());
-    m_iposctrl[1]->positionMove(5, m_left_arm_pos.get(5).asFloat32());
-    m_iposctrl[1]->positionMove(6, m_left_arm_pos.get(6).asFloat32());
-    m_iposctrl[1]->positionMove(7, m_left_arm_pos.get(7).asFloat32());
-    
-    //head
-    m_iposctrl[2]->positionMove(0, m_head_pos.get(0).asFloat32());
-    m_iposctrl[2]->positionMove(1, m_head_pos.get(1).asFloat32());
+
+    //a check still running covers the new command too, the pose is the same
+    lock_guard<mutex> lock(m_motion_mutex);
+    if (!m_motion_done.valid())
+        m_motion_done = m_body.motionDone(m_timeout);
 }
 
 
 bool DisappointmentPose::close()
 {
-    if(m_drivers[0].isValid())
-    {
-        m_drivers[0].close();
-    }
-
-    if(m_drivers[1].isValid())
-    {
-        m_drivers[1].close();
-    }
+    //no more commands from the callback, and no check running on the drivers being closed
+    m_input_port.interrupt();
+    if (!m_input_port.isClosed())
+        m_input_port.close();
 
-    if(m_drivers[2].isValid())
     {
-        m_drivers[2].close();
+        lock_guard<mutex> lock(m_motion_mutex);
+        if (m_motion_done.valid())
+            m_motion_done.wait();
     }
 
-    if (!m_input_port.isClosed())
-        m_input_port.close();
+    m_body.close();
 
     return true;
 }
@@ -20,7 +20,11 @@
 
 YARP_LOG_COMPONENT(GET_READY_TO_NAV, "r1_obr.goAndFindIt.getReadyToNav")
 
-GetReadyToNav::GetReadyToNav() : m_time(2.0)
+GetReadyToNav::GetReadyToNav() : 
+    m_time(2.0),
+    m_arms_tolerance(10.0),
+    m_head_tolerance(20.0),
+    m_torso_tolerance(0.02)
 {
     m_right_arm_pos.fromString("-9.0 9.0 -10.0 50.0 0.0 0.0 0.0 0.0");
     m_left_arm_pos.fromString("-9.0 9.0 -10.0 50.0 0.0 0.0 0.0 0.0");
@@ -52,79 +56,42 @@ bool GetReadyToNav::configure(yarp::os::ResourceFinder &rf)
             m_head_pos.fromString(config.find("head_pos").asString());
         if(config.check("torso_pos")) 
             m_torso_pos.fromString(config.find("torso_pos").asString());
+        if(config.check("arms_tolerance")) 
+            m_arms_tolerance = config.find("arms_tolerance").asFloat32();
+        if(config.check("head_tolerance")) 
+            m_head_tolerance = config.find("head_tolerance").asFloat32();
+        if(config.check("torso_tolerance")) 
+            m_torso_tolerance = config.find("torso_tolerance").asFloat32();
     }
 
     
     // ----------- Polydriver config ----------- //
-    yarp::os::Property prop;
-
-    prop.put("device","remote_controlboard");
-    prop.put("local","/goAndFindIt/getReadyToNavRArm");
-    prop.put("remote","/"+robot+"/right_arm");
-    if (!m_drivers[0].open(prop))
-    {
-        yCError(GET_READY_TO_NAV,"Unable to connect to %s",("/"+robot+"/right_arm").c_str());
-        close();
-        return false;
-    }
-    prop.clear();
-    prop.put("device","remote_controlboard");
-    prop.put("local","/goAndFindIt/getReadyToNavLArm");
-    prop.put("remote","/"+robot+"/left_arm");
-    if (!m_drivers[1].open(prop))
-    {
-        yCError(GET_READY_TO_NAV,"Unable to connect to %s",("/"+robot+"/left_arm").c_str());
-        close();
-        return false;
-    }
-    prop.clear();
-    prop.put("device","remote_controlboard");
-    prop.put("local","/goAndFindIt/getReadyToNavHead");
-    prop.put("remote","/"+robot+"/head");
-    if (!m_drivers[2].open(prop))
-    {
-        yCError(GET_READY_TO_NAV,"Unable to connect to %s",("/"+robot+"/head").c_str());
-        close();
-        return false;
-    }
-    prop.clear();
-    prop.put("device","remote_controlboard");
-    prop.put("local","/goAndFindIt/getReadyToNavTorso");
-    prop.put("remote","/"+robot+"/torso");
-    if (!m_drivers[3].open(prop))
+    if (!m_body.open(robot, "/goAndFindIt/getReadyToNav", {"right_arm", "left_arm", "head", "torso"}))
     {
-        yCError(GET_READY_TO_NAV,"Unable to connect to %s",("/"+robot+"/torso").c_str());
+        yCError(GET_READY_TO_NAV,"Unable to connect to the parts of %s", robot.c_str());
         close();
         return false;
     }
 
-    m_drivers[0].view(m_iposctrl[0]);
-    m_drivers[1].view(m_iposctrl[1]);
-    m_drivers[2].view(m_iposctrl[2]);
-    m_drivers[3].view(m_iposctrl[3]);
-    if(!m_iposctrl[0] || !m_iposctrl[1] || !m_iposctrl[2] || !m_iposctrl[3])
-    {
-        yCError(GET_READY_TO_NAV,"Error opening iPositionControl interfaces. Devices not available");
+    yarp::os::Property navigation;
+    navigation.put("right_arm_pos", m_right_arm_pos.toString());
+    navigation.put("left_arm_pos", m_left_arm_pos.toString());
+    navigation.put("head_pos", m_head_pos.toString());
+    navigation.put("torso_pos", m_torso_pos.toString());
+    if (!m_body.addPose("navigation", navigation))
         return false;
-    }
 
-    m_drivers[0].view(m_ictrlmode[0]);
-    m_drivers[1].view(m_ictrlmode[1]);
-    m_drivers[2].view(m_ictrlmode[2]);
-    m_drivers[3].view(m_ictrlmode[3]);
-    if(!m_ictrlmode[0] || !m_ictrlmode[1] || !m_ictrlmode[2] || !m_ictrlmode[3])
-    {
-        yCError(GET_READY_TO_NAV,"Error opening iControlMode interfaces. Devices not available");
-        return false;
-    }
+    return true;
+}
 
-    m_drivers[0].view(m_iencoder[0]);
-    m_drivers[1].view(m_iencoder[1]);
-    m_drivers[2].view(m_iencoder[2]);
-    m_drivers[3].view(m_iencoder[3]);
-    if(!m_iencoder[0] || !m_iencoder[1] || !m_iencoder[2] || !m_iencoder[3])
+
+bool GetReadyToNav::navPosition()
+{    
+    //all the parts in position mode, with the speeds to get to the final position at the same time
+    yCInfo(GET_READY_TO_NAV, "Setting navigation position");  
+    if (!m_body.goToPose("navigation", m_time))
     {
-        yCError(GET_READY_TO_NAV,"Error opening IEncoders interfaces. Devices not available");
+        yCError(GET_READY_TO_NAV, "Error while setting navigation position");
         return false;
     }
 
@@ -132,34 +99,40 @@ bool GetReadyToNav::configure(yarp::os::ResourceFinder &rf)
 }
 
 
-bool GetReadyToNav::setPosCtrlMode(const int part)
+bool GetReadyToNav::areJointsOk()
 {
-    int NUMBER_OF_JOINTS;
-    std::vector<int> joints;
-    std::vector<int> modes;
-    m_iposctrl[part]->getAxes(&NUMBER_OF_JOINTS);
-    for (int i_joint=0; i_joint < NUMBER_OF_JOINTS; i_joint++)
-    { 
-        joints.push_back(i_joint);
-        modes.push_back(VOCAB_CM_POSITION);
-    } 
+    return m_body.areJointsOk();
+}
+
+const yarp::os::Bottle& GetReadyToNav::partPosition(const int part)
+{
+    if (part == 0)
+        return m_right_arm_pos;
+    else if (part == 1)
+        return m_left_arm_pos;
+    else if (part == 2)
+        return m_head_pos;
+    
+    return m_torso_pos;
+}
 
-    m_ictrlmode[part]->setControlModes(NUMBER_OF_JOINTS, joints.data(), modes.data());
 
-    yarp::os::Time::delay(0.01);  // give time to update control modes value
-    m_ictrlmode[part]->getControlModes(NUMBER_OF_JOINTS, joints.data(), modes.data());
-    for (size_t i=0; i<NUMBER_OF_JOINTS; i++)
+bool GetReadyToNav::isInSafeEnvelope()
+{
+    for (int i = 0 ; i<4 ; i++) 
     {
-        if(modes[i] != VOCAB_CM_POSITION)
-        {
-            std::string part_name="";
-            if(part==0) part_name = "right_arm";
-            else if(part==1) part_name = "left_arm";
-            else if(part==2) part_name = "head";
-            else if(part==3) part_name = "torso";
-            
-            yCError(GET_READY_TO_NAV) << "Joint" << i << "not in position mode for part:" << part_name;
+        double tolerance = i<2 ? m_arms_tolerance : (i==2 ? m_head_tolerance : m_torso_tolerance);
+        const yarp::os::Bottle& goal = partPosition(i);
+
+        int NUMBER_OF_JOINTS = m_body.getAxes(i);
+        std::vector<double> encs;
+        if (!m_body.state().getEncoders(i, encs, 0.0))
             return false;
+
+        for (int i_joint=0; i_joint < NUMBER_OF_JOINTS && i_joint < goal.size(); i_joint++)
+        {
+            if (fabs(encs[i_joint] - goal.get(i_joint).asFloat32()) > tolerance)
+                return false;
         }
     }
 
@@ -167,146 +140,41 @@ bool GetReadyToNav::setPosCtrlMode(const int part)
 }
 
 
-bool GetReadyToNav::setJointsSpeed(const int part)
+bool GetReadyToNav::isMotionDone()
 {
-    int NUMBER_OF_JOINTS;
-    std::vector<int>    joints;
-    std::vector<double> speeds;
-    m_iposctrl[part]->getAxes(&NUMBER_OF_JOINTS);
-    for (int i_joint=0; i_joint < NUMBER_OF_JOINTS; i_joint++)
-    { 
-        double start, goal;
-        m_iencoder[part]->getEncoder(i_joint,&start);
-
-        if (part == 0)
-            goal = m_right_arm_pos.get(i_joint).asFloat32();
-        else if (part == 1)
-            goal = m_left_arm_pos.get(i_joint).asFloat32();
-        else if (part == 2)
-            goal = m_head_pos.get(i_joint).asFloat32();
-        else if (part == 3)
-            goal = m_torso_pos.get(i_joint).asFloat32();
-
-        double disp = start - goal;
-        if(disp<0.0) disp *= -1;
-
-        joints.push_back(i_joint);
-        speeds.push_back(disp/m_time);
-    } 
-
-    return m_iposctrl[part]->setRefSpeeds(NUMBER_OF_JOINTS, joints.data(), speeds.data());
+    return m_body.isMotionDone();
 }
 
 
-bool GetReadyToNav::movePart(const int part)
+bool GetReadyToNav::waitSafeEnvelope(double timeout)
 {
-    int NUMBER_OF_JOINTS;
-    std::vector<int>    joints;
-    std::vector<double> positions;
-    m_iposctrl[part]->getAxes(&NUMBER_OF_JOINTS);
-    for (int i_joint=0; i_joint < NUMBER_OF_JOINTS; i_joint++)
-    { 
-        joints.push_back(i_joint);
-
-        if (part == 0)
-            positions.push_back(m_right_arm_pos.get(i_joint).asFloat32());
-        else if (part == 1)
-            positions.push_back(m_left_arm_pos.get(i_joint).asFloat32());
-        else if (part == 2)
-            positions.push_back(m_head_pos.get(i_joint).asFloat32());
-        else if (part == 3)
-            positions.push_back(m_torso_pos.get(i_joint).asFloat32());
-
-    } 
-
-    return m_iposctrl[part]->positionMove(NUMBER_OF_JOINTS, joints.data(), positions.data());
-}
-
-
-bool GetReadyToNav::navPosition()
-{    
-    //set all joints in position control mode
-    for (int i = 0 ; i<=3 ; i++)
-    {
-        if(!setPosCtrlMode(i))
+    //the parts keep moving towards the navigation position after this returns
+    double start = yarp::os::Time::now();
+    double deadline = start + timeout;
+    bool moving = false;
+    while (!isInSafeEnvelope())
+    {
+        //right after the command the motion could be reported as done because it has not started yet
+        if (!isMotionDone())
+            moving = true;
+        else if (moving || yarp::os::Time::now() - start > 0.5)
         {
-            yCError(GET_READY_TO_NAV, "Error while setting navigation position: setPosCtrlMode");
+            yCWarning(GET_READY_TO_NAV, "Motion completed out of the navigation position");
             return false;
         }
-    }
-    
-    //set the joints' speeds to get to final position at the same time
-    for (int i = 0 ; i<=3 ; i++)
-    {
-        if(!setJointsSpeed(i))
+        if (yarp::os::Time::now() > deadline)
         {
-            yCError(GET_READY_TO_NAV, "Error while setting navigation position: setJointsSpeed");
-            return false;
-        }
-    }
-
-    yCInfo(GET_READY_TO_NAV, "Setting navigation position");  
-      
-    for (int i = 0 ; i<=3 ; i++)
-    {
-        if(!movePart(i))
-        {
-            yCError(GET_READY_TO_NAV, "Error while setting navigation position: movePart");
+            yCWarning(GET_READY_TO_NAV, "Navigation position not reached in %.1f seconds", timeout);
             return false;
         }
+        yarp::os::Time::delay(0.05);
     }
 
     return true;
-
 }
 
 
-bool GetReadyToNav::areJointsOk()
-{
-    int mode=0;
-    for (int i = 0 ; i<4 ; i++) 
-    {
-        int NUMBER_OF_JOINTS;
-        m_iposctrl[i]->getAxes(&NUMBER_OF_JOINTS);
-        for (int i_joint=0; i_joint < NUMBER_OF_JOINTS; i_joint++)
-        { 
-            m_ictrlmode[i]->getControlMode(i_joint, &mode);
-            if (mode == VOCAB_CM_HW_FAULT)
-            {
-                yError() << "Error: hardware fault detected";
-                return false;
-            }
-            else if (mode == VOCAB_CM_IDLE)
-            {
-                yError() << "Error: idle joint detected";
-                return false;
-            }
-        }
-    }
-
-    return true;
-}
-
 void GetReadyToNav::close()
 {
-    if(m_drivers[0].isValid())
-    {
-        m_drivers[0].close();
-    }
-
-    if(m_drivers[1].isValid())
-    {
-        m_drivers[1].close();
-    }
-
-    if(m_drivers[2].isValid())
-    {
-        m_drivers[2].close();
-    }
-
-    if(m_drivers[3].isValid())
-    {
-        m_drivers[3].close();
-    }
+    m_body.close();
 }
-
@@ -27,15 +27,14 @@
 #include <yarp/os/RFModule.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <vector>
+#include <cmath>
+#include "poseController.h"
 
 class GetReadyToNav
 {
 private:
-    //Polydriver
-    yarp::dev::PolyDriver           m_drivers[4];
-    yarp::dev::IControlMode*        m_ictrlmode[4];     //to set the Position control mode
-    yarp::dev::IPositionControl*    m_iposctrl[4];      //to retrieve the number of joints of each part
-    yarp::dev::IEncoders*           m_iencoder[4];      //to retrieve joint position
+    //right_arm, left_arm, head, torso and the "navigation" pose
+    PoseController                  m_body;
 
     std::string                     m_set_nav_position_file;
     yarp::os::Bottle                m_right_arm_pos;
@@ -45,6 +44,11 @@ private:
 
     double                          m_time;
 
+    //max distance from the navigation position for the robot to be safe to navigate (degrees, torso in meters)
+    double                          m_arms_tolerance;
+    double                          m_head_tolerance;
+    double                          m_torso_tolerance;
+
 public:
     //Constructor/Distructor
     GetReadyToNav();
@@ -53,12 +57,15 @@ public:
     //Internal methods
     bool configure(yarp::os::ResourceFinder &rf);
     bool navPosition();
-    bool setPosCtrlMode(const int part);
-    bool setJointsSpeed(const int part);
-    bool movePart(const int part);
     bool areJointsOk();
+    bool isInSafeEnvelope();
+    bool isMotionDone();
+    bool waitSafeEnvelope(double timeout);
 
     void close();
+
+private:
+    const yarp::os::Bottle& partPosition(const int part);
 };
 
 #endif //GET_READY_TO_NAV_H
@@ -104,13 +104,27 @@ void GoAndFindIt::onRead(Bottle& b)
     
     yCInfo(GO_AND_FIND_IT,"Received:  %s",b.toString().c_str());
 
-    if(b.size() == 2)           //expected "<object> <location>"
+    if(b.size() == 2)           //expected "<object> <location>" or "(<object1> <object2> ...) <location>"
     {
-        string what = b.get(0).asString();
         string where = b.get(1).asString();
+        if (b.get(0).isList())
+        {
+            vector<string> whats;
+            getLabels(b.get(0), whats);
+            m_thread->setWhatsWhere(whats,where);
+        }
+        else
+        {
+            string what = b.get(0).asString();
+            m_thread->setWhatWhere(what,where);
+        }
 
-        m_thread->setWhatWhere(what,where);
-
+    }
+    else if(b.size() == 1 && b.get(0).isList())     //expected "(<object1> <object2> ...)"
+    {
+        vector<string> whats;
+        getLabels(b.get(0), whats);
+        m_thread->setWhats(whats);
     }
     else if(b.size() == 1)      //expected "<object>" or "stop"/"reset"/"resume"
     {
@@ -150,6 +164,8 @@ void GoAndFindIt::onRead(Bottle& b)
         yCError(GO_AND_FIND_IT,"Error: wrong bottle format received");
         return;
     }
+
+    m_thread->commandDone();
     
 }
 
@@ -165,6 +181,10 @@ bool GoAndFindIt::respond(const Bottle &cmd, Bottle &reply)
             reply.addVocab32("many");
             reply.addString("search <what> : starts to search for 'what'");
             reply.addString("search <what> <where>: starts searching for 'what' at location 'where'");
+            reply.addString("search (<what1> <what2> ...) [<where>]: searches for all the objects in the same tour, each one is reported as soon as it is found");
+            reply.addString("add <what>  : adds 'what' to the objects of the current search, without restarting it");
+            reply.addString("drop <what> : removes 'what' from the objects still to be found");
+            reply.addString("verify <where> : goes to location 'where' before the next one of the tour and searches there");
             reply.addString("status : returns the current status of the search");
             reply.addString("what   : returns the object of the current search");
             reply.addString("where  : returns the location of the current search");
@@ -225,12 +245,43 @@ bool GoAndFindIt::respond(const Bottle &cmd, Bottle &reply)
     }
     else if (cmd.size()==2)
     {
-        if (cmd_0=="search")
+        if (cmd_0=="search" && cmd.get(1).isList())
+        {
+            vector<string> whats;
+            getLabels(cmd.get(1), whats);
+            m_thread->setWhats(whats);
+            reply.addString("searching for '" + cmd.get(1).asList()->toString() + "'");
+        }
+        else if (cmd_0=="search")
         {
             string what=cmd.get(1).asString();
             m_thread->setWhat(what);
             reply.addString("searching for '" + what + "'");
         }
+        else if (cmd_0=="add")
+        {
+            string what=cmd.get(1).asString();
+            if (m_thread->addWhat(what))
+                reply.addString("added");
+            else
+                reply.addVocab32(Vocab32::encode("nack"));
+        }
+        else if (cmd_0=="drop")
+        {
+            string what=cmd.get(1).asString();
+            if (m_thread->dropWhat(what))
+                reply.addString("'" + what + "' dropped");
+            else
+                reply.addVocab32(Vocab32::encode("nack"));
+        }
+        else if (cmd_0=="verify")
+        {
+            string where=cmd.get(1).asString();
+            if (m_thread->verifyWhere(where))
+                reply.addString("going to '" + where + "'");
+            else
+                reply.addVocab32(Vocab32::encode("nack"));
+        }
         else
         {
             reply.addVocab32(Vocab32::encode("nack"));
@@ -239,7 +290,15 @@ bool GoAndFindIt::respond(const Bottle &cmd, Bottle &reply)
     }
     else if (cmd.size()==3)
     {
-        if (cmd_0=="search")
+        if (cmd_0=="search" && cmd.get(1).isList())
+        {
+            vector<string> whats;
+            getLabels(cmd.get(1), whats);
+            string where=cmd.get(2).asString();
+            m_thread->setWhatsWhere(whats,where);
+            reply.addString("searching for '" + cmd.get(1).asList()->toString() + "' at '" + where + "'");
+        }
+        else if (cmd_0=="search")
         {
             string what=cmd.get(1).asString();
             string where=cmd.get(2).asString();
@@ -261,5 +320,22 @@ bool GoAndFindIt::respond(const Bottle &cmd, Bottle &reply)
     if (reply.size()==0)
         reply.addVocab32(yarp::os::Vocab32::encode("ack")); 
 
+    //the new state is published before the reply is sent
+    if (cmd_0!="help" && cmd_0!="what" && cmd_0!="where" && cmd_0!="status")
+        m_thread->commandDone();
+
     return true;
 }
+
+/****************************************************************/
+void GoAndFindIt::getLabels(const Value& list, vector<string>& labels)
+{
+    labels.clear();
+    Bottle* b = list.asList();
+    for (size_t i=0; b && i<b->size(); i++)
+    {
+        string label = b->get(i).asString();
+        if (label != "" && find(labels.begin(), labels.end(), label) == labels.end())
+            labels.push_back(label);
+    }
+}
@@ -49,6 +49,10 @@ public:
     void onRead(Bottle& btl) override;
 
     bool respond(const Bottle &cmd, Bottle &reply);
+
+private:
+    //labels of a multi-object search, duplicates removed
+    void getLabels(const Value& list, vector<string>& labels);
 };
 
 #endif 
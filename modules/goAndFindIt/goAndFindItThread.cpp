@@ -29,16 +29,30 @@ GoAndFindItThread::GoAndFindItThread(yarp::os::ResourceFinder &rf) :
     m_where(""),
     m_where_specified(false),
     m_nowhere_else(false),
+    m_multi(false),
+    m_location_done(false),
+    m_next_valid(false),
     m_status(GaFI_IDLE),
-    m_in_nav_position(false)
+    m_in_nav_position(false),
+    m_navPos_failures(0),
+    m_navPos_next_try(0.0),
+    m_search_start(0.0),
+    m_status_seq(0),
+    m_cmd_count(0),
+    m_last_published(""),
+    m_last_publish_time(0.0)
 {
     m_nextLoc_rpc_port_name = "/goAndFindIt/nextLocPlanner:rpc";
     m_lookObject_port_name  = "/goAndFindIt/lookForObject/object:o";
     m_objectFound_port_name = "/goAndFindIt/lookForObject/result:i";
     m_output_port_name      = "/goAndFindIt/output:o";
+    m_status_port_name      = "/goAndFindIt/status:o";
     m_max_nav_time          = 300.0;
     m_max_search_time       = 120.0;
     m_setNavPos_time        = 3.0;
+    m_navPos_attempts       = 3;
+    m_navPos_retry_delay    = 2.0;
+    m_heartbeat_period      = 1.0;
 }
 
 /****************************************************************/
@@ -51,6 +65,10 @@ bool GoAndFindItThread::threadInit()
         m_max_search_time = m_rf.find("max_search_time").asFloat32();
     if(m_rf.check("set_nav_pos_time"))
         m_setNavPos_time = m_rf.find("set_nav_pos_time").asFloat32();
+    if(m_rf.check("set_nav_pos_attempts"))
+        m_navPos_attempts = m_rf.find("set_nav_pos_attempts").asInt32();
+    if(m_rf.check("set_nav_pos_retry_delay"))
+        m_navPos_retry_delay = m_rf.find("set_nav_pos_retry_delay").asFloat32();
 
     //Open ports
     if(m_rf.check("nextLoc_rpc_port"))
@@ -86,6 +104,16 @@ bool GoAndFindItThread::threadInit()
     else
         yCInfo(GO_AND_FIND_IT_THREAD) << "opened port" << m_output_port_name;
 
+
+    if(m_rf.check("status_port"))
+        m_status_port_name = m_rf.find("status_port").asString();
+    if(m_rf.check("status_heartbeat_period"))
+        m_heartbeat_period = m_rf.find("status_heartbeat_period").asFloat32();
+    if(!m_status_port.open(m_status_port_name))
+        yCError(GO_AND_FIND_IT_THREAD) << "Cannot open port" << m_status_port_name; 
+    else
+        yCInfo(GO_AND_FIND_IT_THREAD) << "opened port" << m_status_port_name;
+
     //Navigation2DClient config 
     yarp::os::Property nav2DProp;
     //Defaults
@@ -119,6 +147,23 @@ bool GoAndFindItThread::threadInit()
         return false;
     }
 
+    // --------- Navigation status --------- //
+    string navStatusPort = m_rf.check("nav_status_port") ? m_rf.find("nav_status_port").asString() : "/navStatusBroadcaster/status:o";
+    m_navStatus = new NavStatusCache(m_iNav2D);
+    if(!m_navStatus->open("/goAndFindIt/navStatus:i", navStatusPort))
+        return false;
+
+    // --------- Locations --------- //
+    string locationsPort = m_rf.check("locations_port") ? m_rf.find("locations_port").asString() : "/nextLocPlanner/locations:o";
+    m_locations = new LocationCatalogue(m_nextLoc_rpc_port);
+    if(!m_locations->open("/goAndFindIt/locations:i", locationsPort))
+        return false;
+
+    // --------- Telemetry --------- //
+    m_telemetry = new SearchTelemetry("goAndFindIt");
+    if(!m_telemetry->configure(m_rf))
+        return false;
+
     // --------- getReadyToNav config --------- //
     m_getReadyToNav = new GetReadyToNav();
     bool ok{m_getReadyToNav->configure(m_rf)};
@@ -147,10 +192,34 @@ void GoAndFindItThread::threadRelease()
     if (!m_output_port.isClosed())
         m_output_port.close();
 
+    if (!m_status_port.isClosed())
+        m_status_port.close();
+
+    if(m_navStatus)
+    {
+        m_navStatus->close();
+        delete m_navStatus;
+        m_navStatus = nullptr;
+    }
+
+    if(m_locations)
+    {
+        m_locations->close();
+        delete m_locations;
+        m_locations = nullptr;
+    }
+
     if(m_nav2DPoly.isValid())
         m_nav2DPoly.close();
     
     m_getReadyToNav->close();
+
+    if(m_telemetry)
+    {
+        m_telemetry->close();
+        delete m_telemetry;
+        m_telemetry = nullptr;
+    }
     
     yCInfo(GO_AND_FIND_IT_THREAD, "Thread released");
 
@@ -163,6 +232,7 @@ void GoAndFindItThread::run()
 
     while (true)
     {
+        GaFI_status prevStatus = m_status;
 
         if (m_status == GaFI_NEW_SEARCH)
         {
@@ -197,13 +267,17 @@ void GoAndFindItThread::run()
         else if (m_status == GaFI_SEARCHING && Time::now() - m_searching_time > m_max_search_time) //two minutes to find "m_what"
         {
             yCError(GO_AND_FIND_IT_THREAD,"Too much time has passed waiting for '%s' to be found.",m_what.c_str());
+            m_telemetry->increment("search_timeouts");
             m_status = GaFI_OBJECT_NOT_FOUND;
         } 
 
         else if (m_status == GaFI_OBJECT_FOUND)
         {
             lock_guard<mutex> lock(m_mutex);
-            objFound();   
+            if (m_multi)
+                objectsFound();
+            else
+                objFound();   
         } 
 
         else if (m_status == GaFI_OBJECT_NOT_FOUND)
@@ -222,7 +296,11 @@ void GoAndFindItThread::run()
             break;
         }
 
-        Time::delay(0.2);
+        publishStatus();
+
+        //a search that continues with a prefetched location goes on without waiting
+        if (!(prevStatus == GaFI_OBJECT_NOT_FOUND && m_status == GaFI_NAVIGATING))
+            Time::delay(0.2);
 
     }
 
@@ -231,63 +309,72 @@ void GoAndFindItThread::run()
 /****************************************************************/
 void GoAndFindItThread::setWhat(string& what)
 { 
-    
+    vector<string> whats{what};
+    setWhats(whats);
+}
+
+/****************************************************************/
+void GoAndFindItThread::setWhatWhere(string& what, string& where)
+{
+    vector<string> whats{what};
+    setWhatsWhere(whats, where);
+}
+
+/****************************************************************/
+void GoAndFindItThread::setWhats(vector<string>& whats)
+{ 
+    string what = joinLabels(whats);
     if (what == m_what && m_status != GaFI_IDLE && m_where_specified == false)
     {
         yCWarning(GO_AND_FIND_IT_THREAD, "Already looking for %s. If you want to perform a new search, please send reset command.", m_what.c_str());
     }
     else 
     {
-        if (m_status == GaFI_NAVIGATING)
-        {
-            resetSearch();
-            Time::delay(1.0);
-        }
-        else
-            resetSearch();
+        resetSearch();
+        //an interrupted navigation releases the lock as soon as it has seen the stop
+        lock_guard<mutex> lock(m_mutex);
  
         m_where_specified = false;
         m_where = "";
         
         m_status = GaFI_NEW_SEARCH;  
+        m_labels = whats;
+        m_multi = whats.size() > 1;
         m_what = what;    
+        m_search_start = m_telemetry->startTime();
+        m_telemetry->increment("searches");
 
         Time::delay(0.1);
-        Bottle&  l = m_lookObject_port.prepare();
-        l.clear();
-        l.addString("label"); l.addString(what);
-        m_lookObject_port.write();
+        sendLabels();
     }  
 }
 
 /****************************************************************/
-void GoAndFindItThread::setWhatWhere(string& what, string& where)
+void GoAndFindItThread::setWhatsWhere(vector<string>& whats, string& where)
 {
+    string what = joinLabels(whats);
     if (what == m_what && where == m_where && m_status != GaFI_IDLE && m_where_specified == true)
     {
         yCWarning(GO_AND_FIND_IT_THREAD, "Already looking for %s in location %s. If you want to perform a new search, please send reset command.", m_what.c_str(), m_where.c_str());
     }
     else 
     {
-        if (m_status == GaFI_NAVIGATING)
-        {
-            resetSearch();
-            Time::delay(1.0);
-        }
-        else
-            resetSearch();
+        resetSearch();
+        //an interrupted navigation releases the lock as soon as it has seen the stop
+        lock_guard<mutex> lock(m_mutex);
         
         m_where_specified = true;
 
         m_status = GaFI_NAVIGATING;
         m_where = where;
+        m_labels = whats;
+        m_multi = whats.size() > 1;
         m_what = what;   
+        m_search_start = m_telemetry->startTime();
+        m_telemetry->increment("searches");
 
         Time::delay(0.1);
-        Bottle&  l = m_lookObject_port.prepare();
-        l.clear();
-        l.addString("label"); l.addString(what);
-        m_lookObject_port.write();
+        sendLabels();
 
         Bottle request,_rep_;
         request.fromString("set " + m_where + " checking");
@@ -295,12 +382,128 @@ void GoAndFindItThread::setWhatWhere(string& what, string& where)
     }
 }
 
+/****************************************************************/
+bool GoAndFindItThread::addWhat(string& what)
+{
+    //same order of dropWhat: the search, then the found objects
+    lock_guard<mutex> lock(m_mutex);
+    lock_guard<mutex> foundLock(m_found_mutex);
+    if (m_status == GaFI_IDLE || m_status == GaFI_STOP || (m_status == GaFI_OBJECT_FOUND && !m_multi))
+    {
+        yCWarning(GO_AND_FIND_IT_THREAD, "No search in progress, %s cannot be added", what.c_str());
+        return false;
+    }
+    if (find(m_labels.begin(), m_labels.end(), what) != m_labels.end())
+        return true;
+    m_labels.push_back(what);
+    m_what = joinLabels(m_labels);
+    if (!m_multi)
+    {
+        m_multi = true;
+        sendLabels();
+    }
+    yCInfo(GO_AND_FIND_IT_THREAD, "%s added to the objects to find", what.c_str());
+
+    //the current location is looked at again with all the objects, by the run loop
+    if (m_status == GaFI_SEARCHING)
+        m_status = GaFI_ARRIVED;
+
+    return true;
+}
+
+/****************************************************************/
+bool GoAndFindItThread::dropWhat(string& what)
+{
+    //m_what is used by the search under m_mutex: same order of the search, then the found objects
+    lock_guard<mutex> lock(m_mutex);
+    lock_guard<mutex> foundLock(m_found_mutex);
+    auto it = find(m_labels.begin(), m_labels.end(), what);
+    if (it == m_labels.end())
+    {
+        yCWarning(GO_AND_FIND_IT_THREAD, "%s is not among the objects to find", what.c_str());
+        return false;
+    }
+
+    m_labels.erase(it);
+    m_what = joinLabels(m_labels);
+    yCInfo(GO_AND_FIND_IT_THREAD, "%s removed from the objects to find", what.c_str());
+
+    if (m_labels.empty())
+        stopSearch();
+
+    return true;
+}
+
+/****************************************************************/
+bool GoAndFindItThread::verifyWhere(string& where)
+{
+    //with a location specified there is no tour to change
+    if ((m_status != GaFI_NAVIGATING && m_status != GaFI_NEW_SEARCH) || m_where_specified)
+    {
+        yCWarning(GO_AND_FIND_IT_THREAD, "Not navigating in a tour, cannot go to %s", where.c_str());
+        return false;
+    }
+
+    lock_guard<mutex> lock(m_detour_mutex);
+    m_detour = where;
+
+    return true;
+}
+
+/****************************************************************/
+string GoAndFindItThread::takeDetour()
+{
+    lock_guard<mutex> lock(m_detour_mutex);
+    string detour = m_detour;
+    m_detour = "";
+
+    return detour;
+}
+
+/****************************************************************/
+void GoAndFindItThread::sendLabels()
+{
+    Bottle&  l = m_lookObject_port.prepare();
+    l.clear();
+    if (m_multi)
+        l.addString("detect");  //the detections have to contain all the labels
+    else
+    {
+        l.addString("label"); l.addString(m_what);
+    }
+    m_lookObject_port.write();
+}
+
+/****************************************************************/
+string GoAndFindItThread::joinLabels(const vector<string>& labels)
+{
+    string joined;
+    for (const auto& label : labels)
+        joined += (joined.empty() ? "" : " ") + label;
+    return joined;
+}
+
 /****************************************************************/
 void GoAndFindItThread::nextWhere()
 {
+    //a location requested at the start of the search comes first
+    string detour = takeDetour();
+    if (detour != "")
+    {
+        Bottle request,_rep_;
+        request.fromString("set " + detour + " checking");
+        m_nextLoc_rpc_port.write(request,_rep_);
+        m_where = detour;
+        m_status = GaFI_NAVIGATING;
+        return;
+    }
+
     Bottle request,reply;
     request.addString("next");
-    if(m_nextLoc_rpc_port.write(request,reply))
+    SearchTelemetry::Timer rpcTimer(m_telemetry, "planner_rpc");
+    bool ok = m_nextLoc_rpc_port.write(request,reply);
+    rpcTimer.stop();
+    if(ok)
     {
         string loc = reply.get(0).asString(); 
         if (loc != "noLocation")
@@ -323,15 +526,57 @@ void GoAndFindItThread::nextWhere()
 }
 
 
+/****************************************************************/
+void GoAndFindItThread::prefetchNextWhere()
+{
+    m_next_valid = false;
+
+    //the robot is not moving while searching, so the planner order is the one it will have when the search ends
+    Bottle request,reply;
+    request.addString("peek");
+    SearchTelemetry::Timer rpcTimer(m_telemetry, "planner_rpc");
+    if(!m_nextLoc_rpc_port.write(request,reply))
+        return;
+    rpcTimer.stop();
+
+    string loc = reply.get(0).asString();
+    if (loc == "noLocation" || loc == "")
+        return;
+
+    bool locOk = m_locations->getLocation(loc, m_next_loc);
+    if (!locOk)
+    {
+        SearchTelemetry::Timer locTimer(m_telemetry, "location_rpc");
+        locOk = m_iNav2D->getLocation(loc, m_next_loc);
+    }
+    if (!locOk)
+    {
+        yCWarning(GO_AND_FIND_IT_THREAD,"Cannot get the pose of location %s", loc.c_str());
+        return;
+    }
+
+    m_next_where = loc;
+    m_next_valid = true;
+    yCDebug(GO_AND_FIND_IT_THREAD,"Next location to search, if needed: %s", m_next_where.c_str());
+}
+
+
 /****************************************************************/
 bool GoAndFindItThread::setNavigationPosition()
 {
     if(m_getReadyToNav->areJointsOk())
     {
+        SearchTelemetry::Timer navPosTimer(m_telemetry, "set_nav_position");
         if(!m_getReadyToNav->navPosition())
             return false;
             
-        Time::delay(m_setNavPos_time);
+        //navigation can start as soon as the parts are close enough to the navigation position,
+        //they reach it while the robot is already moving
+        if(!m_getReadyToNav->waitSafeEnvelope(m_setNavPos_time))
+        {
+            yCError(GO_AND_FIND_IT_THREAD,"The robot is not in navigation position: not navigating");
+            return false;
+        }
         m_in_nav_position = true;
         return true;
     }
@@ -346,10 +591,14 @@ bool GoAndFindItThread::setNavigationPosition()
 /****************************************************************/
 bool GoAndFindItThread::goThere()
 {   
-    //check if "m_where" is a valid location
-    Bottle request,reply;
-    request.fromString("find " + m_where);
-    if(m_nextLoc_rpc_port.write(request,reply))
+    //a prefetched location has already been validated while searching the previous one
+    bool prefetched = m_next_valid && m_next_where == m_where;
+    m_next_valid = false;
+
+    //check if "m_where" is a valid location, in the replica of the planner locations
+    Bottle reply;
+    bool findOk = !prefetched && m_locations->find(m_where, reply);
+    if(findOk)
     {
         if (reply.get(0).asString() == "ok" && reply.get(1).asString() == "checked")
         {
@@ -365,22 +614,50 @@ bool GoAndFindItThread::goThere()
         }   
     }
 
-    //setting navigation position, if needed
+    //setting navigation position, if needed. After a failure it is commanded again only once the retry delay has passed
     if(!m_in_nav_position)
     {
+        if(Time::now() < m_navPos_next_try)
+            return false;
+
         if(!setNavigationPosition())
+        {
+            if(m_status != GaFI_NAVIGATING)
+                return false;
+
+            m_navPos_failures++;
+            if(m_navPos_failures >= m_navPos_attempts)
+            {
+                yCError(GO_AND_FIND_IT_THREAD,"Navigation position not reached in %d attempts: search ended", m_navPos_failures);
+                m_navPos_failures = 0;
+                m_navPos_next_try = 0.0;
+                m_status = GaFI_IDLE;
+            }
+            else
+                m_navPos_next_try = Time::now() + m_navPos_retry_delay;
             return false;
+        }
+        m_navPos_failures = 0;
+        m_navPos_next_try = 0.0;
     }
 
     if (m_status != GaFI_NAVIGATING)
         return false; //possible external stop during setNavigationPosition
 
     //navigating to "m_where"
-    m_iNav2D->gotoTargetByLocationName(m_where);
+    double navStart = m_telemetry->startTime();
+    m_navStatus->goalSent();
+    bool goalLost;
+    if (prefetched)
+        goalLost = !m_iNav2D->gotoTargetByAbsoluteLocation(m_next_loc);
+    else
+        goalLost = !m_iNav2D->gotoTargetByLocationName(m_where);
+    if (goalLost)
+        m_navStatus->goalFailed();
     yCInfo(GO_AND_FIND_IT_THREAD, "Going to location %s", m_where.c_str());
 
     Nav2D::NavigationStatusEnum currentStatus;
-    m_iNav2D->getNavigationStatus(currentStatus);
+    m_navStatus->getNavigationStatus(currentStatus);
     double toomuchtime = Time::now() + m_max_nav_time; //five minutes to reach "m_where"
 
     while (currentStatus != Nav2D::navigation_status_goal_reached)
@@ -388,6 +665,7 @@ bool GoAndFindItThread::goThere()
         if (currentStatus == Nav2D::navigation_status_aborted || m_status != GaFI_NAVIGATING)
         {
             yCWarning(GO_AND_FIND_IT_THREAD,"Navigation has been interrupted. Location not reached.");
+            m_telemetry->increment("navigation_failures");
             m_status = GaFI_IDLE;
             return false;
         }
@@ -397,10 +675,32 @@ bool GoAndFindItThread::goThere()
             yCError(GO_AND_FIND_IT_THREAD,"Too much time has passed to navigate to %s.",m_where.c_str());
             stopSearch();
         }
-        Time::delay(0.2);
-        m_iNav2D->getNavigationStatus(currentStatus);
-        
+
+        string detour = takeDetour();
+        if (detour != "" && detour != m_where)
+        {
+            //the new goal replaces the current one without stopping the robot, the current location is visited later
+            Bottle request,_rep_;
+            request.fromString("set " + m_where + " unchecked");
+            m_nextLoc_rpc_port.write(request,_rep_);
+            request.fromString("set " + detour + " checking");
+            m_nextLoc_rpc_port.write(request,_rep_);
+
+            m_where = detour;
+            m_navStatus->goalSent();
+            if (!m_iNav2D->gotoTargetByLocationName(m_where))
+                m_navStatus->goalFailed();
+            m_navStatus->getNavigationStatus(currentStatus);
+            toomuchtime = Time::now() + m_max_nav_time;
+            m_telemetry->increment("detours");
+            yCInfo(GO_AND_FIND_IT_THREAD, "Going to verification location %s", m_where.c_str());
+            continue;
+        }
+
+        m_navStatus->waitForStatusChange(currentStatus, 0.2);
+        publishStatus();
     }
+    m_telemetry->addSample("navigation", navStart);
     m_status = GaFI_ARRIVED;
     yCInfo(GO_AND_FIND_IT_THREAD, "Arrived at location %s." , m_where.c_str() ) ;
 
@@ -411,33 +711,89 @@ bool GoAndFindItThread::goThere()
 bool GoAndFindItThread::search()
 {
     //looking for "m_what"
+    if (m_multi)
+    {
+        lock_guard<mutex> lock(m_found_mutex);
+        m_found.clear();
+        m_location_done = false;
+    }
+
     Bottle&  ask = m_lookObject_port.prepare();
     ask.clear();
-    ask.addString(m_what);
+    if (m_multi)
+    {
+        Bottle& labels = ask.addList();
+        for (const auto& label : m_labels)
+            labels.addString(label);
+    }
+    else
+        ask.addString(m_what);
     m_lookObject_port.write();
     yCInfo(GO_AND_FIND_IT_THREAD, "Started looking for %s at location %s", m_what.c_str(), m_where.c_str());
 
     m_searching_time = Time::now();
     m_status = GaFI_SEARCHING;
 
+    if (!m_where_specified)
+        prefetchNextWhere();
+
     return false;
 }
 
 /****************************************************************/
 void GoAndFindItThread::onRead(Bottle& b)
 {
+    string result = b.get(0).asString();
+    lock_guard<mutex> lock(m_found_mutex);
+
+    //in a multi-object search every object is reported as soon as it is seen and lookForObject
+    //goes on with the others: only "object not found" ends the search at the current location
+    if (m_multi)
+    {
+        if (m_status != GaFI_SEARCHING && m_status != GaFI_OBJECT_FOUND)
+            return;
+
+        if (result == "object not found")
+        {
+            yCInfo(GO_AND_FIND_IT_THREAD,"Search at location %s finished",m_where.c_str());
+            m_telemetry->addSample("location_search", m_searching_time);
+            m_telemetry->increment("locations_searched");
+            m_location_done = true;
+        }
+        else
+        {
+            FoundObject found;
+            found.label = result;
+            Bottle* coords = b.get(1).asList();
+            if (coords)
+                found.coords.copy(*coords);
+            m_objectFound_port.getEnvelope(found.stamp);
+            m_found.push_back(found);
+        }
+        m_status = GaFI_OBJECT_FOUND;
+        publishStatus();
+        return;
+    }
+
     yCInfo(GO_AND_FIND_IT_THREAD,"Search at location %s finished",m_where.c_str());
 
-    string result = b.get(0).asString();
     if (m_status == GaFI_SEARCHING)
     {
+        m_telemetry->addSample("location_search", m_searching_time);
+        m_telemetry->increment("locations_searched");
         if (result == "object not found")
             m_status = GaFI_OBJECT_NOT_FOUND;   
         else 
         {
-            m_coords = b.get(1).asList();
+            //"b" is reused by the port for the next message: the coordinates are copied
+            Bottle* coords = b.get(1).asList();
+            m_coords.clear();
+            if (coords)
+                m_coords.copy(*coords);
+            m_objectFound_port.getEnvelope(m_coords_stamp);
             m_status = GaFI_OBJECT_FOUND;
         }    
+        publishStatus();
     }
 }
 
@@ -450,9 +806,13 @@ bool GoAndFindItThread::objFound()
     toSend.clear();
     toSend.addString(m_what);  
     Bottle&  coords = toSend.addList();
-    coords = *m_coords;      
+    coords = m_coords;      
+    if (m_coords_stamp.isValid())
+        m_output_port.setEnvelope(m_coords_stamp);
     m_output_port.write();
     m_status = GaFI_IDLE;
+    m_telemetry->addSample("search_total", m_search_start);
+    m_telemetry->increment("objects_found");
     
     
     Bottle request,_rep_;
@@ -464,9 +824,77 @@ bool GoAndFindItThread::objFound()
     return true;
 }
 
+/****************************************************************/
+bool GoAndFindItThread::objectsFound()
+{
+    lock_guard<mutex> lock(m_found_mutex);
+
+    for (auto& obj : m_found)
+    {
+        auto it = find(m_labels.begin(), m_labels.end(), obj.label);
+        if (it == m_labels.end())
+            continue;   //already reported or dropped
+        m_labels.erase(it);
+
+        yCInfo(GO_AND_FIND_IT_THREAD,"%s found at %s!", obj.label.c_str(), m_where.c_str());
+        Bottle&  toSend = m_output_port.prepare();
+        toSend.clear();
+        toSend.addString(obj.label);
+        Bottle&  coords = toSend.addList();
+        coords = obj.coords;
+        if (obj.stamp.isValid())
+            m_output_port.setEnvelope(obj.stamp);
+        m_output_port.write();
+        m_telemetry->increment("objects_found");
+    }
+    m_found.clear();
+    m_what = joinLabels(m_labels);
+
+    if (m_labels.empty())
+    {
+        yCInfo(GO_AND_FIND_IT_THREAD,"All the objects have been found");
+        Bottle&  toSend = m_output_port.prepare();
+        toSend.clear();
+        toSend.addString("all found");
+        m_output_port.write();
+        m_telemetry->addSample("search_total", m_search_start);
+
+        if (!m_location_done)
+        {
+            Bottle&  ask = m_lookObject_port.prepare();
+            ask.clear();
+            ask.addString("stop");
+            m_lookObject_port.write();
+        }
+
+        Bottle request,_rep_;
+        request.fromString("set " + m_where + " checked");
+        m_nextLoc_rpc_port.write(request,_rep_);
+
+        m_in_nav_position = false;
+        m_location_done = false;
+        m_status = GaFI_IDLE;
+    }
+    else if (m_location_done)
+    {
+        m_location_done = false;
+        m_status = GaFI_OBJECT_NOT_FOUND;
+    }
+    else
+        m_status = GaFI_SEARCHING;   //lookForObject goes on with the remaining objects
+
+    return true;
+}
+
 /****************************************************************/
 bool GoAndFindItThread::objNotFound()
 {
+    Bottle request,_rep_;
+    request.fromString("set " + m_where + " checked");
+    m_nextLoc_rpc_port.write(request,_rep_);
+
+    m_in_nav_position = false;
+
     if(m_where_specified || m_nowhere_else)
     {
         if (m_nowhere_else)
@@ -477,7 +905,15 @@ bool GoAndFindItThread::objNotFound()
         Bottle&  toSend = m_output_port.prepare();
         toSend.clear();
         toSend.addString("not found");      //Search failed
+        if (m_multi)
+        {
+            Bottle& missing = toSend.addList();
+            for (const auto& label : m_labels)
+                missing.addString(label);
+        }
         m_output_port.write();
+        m_telemetry->addSample("search_total", m_search_start);
+        m_telemetry->increment("objects_not_found");
 
         m_status = GaFI_IDLE;
     }
@@ -485,15 +921,17 @@ bool GoAndFindItThread::objNotFound()
     {
         yCInfo(GO_AND_FIND_IT_THREAD,"%s not found at %s. Continuing search", m_what.c_str(), m_where.c_str());
         
-        m_status = GaFI_NEW_SEARCH;
-        
+        if (m_next_valid)
+        {
+            //same effect of "next" on the planner, without asking for the location again
+            request.fromString("set " + m_next_where + " checking");
+            m_nextLoc_rpc_port.write(request,_rep_);
+            m_where = m_next_where;
+            m_status = GaFI_NAVIGATING;
+        }
+        else
+            m_status = GaFI_NEW_SEARCH;
     }
-    
-    Bottle request,_rep_;
-    request.fromString("set " + m_where + " checked");
-    m_nextLoc_rpc_port.write(request,_rep_);
-
-    m_in_nav_position = false;
 
     return true;
 }
@@ -501,10 +939,13 @@ bool GoAndFindItThread::objNotFound()
 /****************************************************************/
 bool GoAndFindItThread::stopSearch()
 {
+    m_next_valid = false;
+    takeDetour();
+
     if (m_status == GaFI_NAVIGATING)
     {        
         Nav2D::NavigationStatusEnum currentStatus;
-        m_iNav2D->getNavigationStatus(currentStatus);
+        m_navStatus->getNavigationStatus(currentStatus);
         if (currentStatus == Nav2D::navigation_status_moving)
             m_iNav2D->stopNavigation();
         yCInfo(GO_AND_FIND_IT_THREAD, "Navigation and search stopped");
@@ -534,8 +975,7 @@ bool GoAndFindItThread::resumeSearch()
     if (m_where != "")
     {
         Bottle request,reply,btl;
-        request.fromString("find " + m_where);
-        m_nextLoc_rpc_port.write(request,reply);
+        m_locations->find(m_where, reply);
         
         btl.fromString("ok checking") ;
         if (reply == btl)
@@ -556,10 +996,19 @@ bool GoAndFindItThread::resetSearch()
     stopSearch();
 
     m_in_nav_position = false;
+    m_navPos_failures = 0;
+    m_navPos_next_try = 0.0;
     m_where_specified = false;
     m_nowhere_else = false;
     m_what = "";
     m_where = "";
+    {
+        lock_guard<mutex> lock(m_found_mutex);
+        m_labels.clear();
+        m_found.clear();
+        m_location_done = false;
+        m_multi = false;
+    }
 
     Bottle request,reply;
     request.fromString("set all unchecked");
@@ -623,6 +1072,48 @@ string GoAndFindItThread::getStatus()
     return str;
 }
 
+/****************************************************************/
+void GoAndFindItThread::publishStatus(bool force)
+{
+    lock_guard<mutex> lock(m_publish_mutex);
+    if (m_status_port.isClosed())
+        return;
+
+    string status = getStatus();
+    string what = m_what;
+    string where = m_where;
+    string current = status + " " + what + " " + where;
+    double now = Time::now();
+    if (!force && current == m_last_published && now - m_last_publish_time < m_heartbeat_period)
+        return;
+
+    //<seq> <commands handled> <status> <what> <where>
+    m_status_seq++;
+    Bottle& b = m_status_port.prepare();
+    b.clear();
+    b.addInt32(m_status_seq);
+    b.addInt32(m_cmd_count);
+    b.addString(status);
+    b.addString(what);
+    b.addString(where);
+    Stamp stamp(m_status_seq, now);
+    m_status_port.setEnvelope(stamp);
+    m_status_port.write();
+
+    m_last_published = current;
+    m_last_publish_time = now;
+}
+
+/****************************************************************/
+void GoAndFindItThread::commandDone()
+{
+    {
+        lock_guard<mutex> lock(m_publish_mutex);
+        m_cmd_count++;
+    }
+    publishStatus(true);
+}
+
 /****************************************************************/
 void GoAndFindItThread::onStop()
 {
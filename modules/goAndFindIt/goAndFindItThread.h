@@ -23,7 +23,12 @@
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/INavigation2D.h>
 #include <yarp/os/all.h>
+#include <vector>
+#include <algorithm>
 #include "getReadyToNav.h"
+#include "navStatusCache.h"
+#include "locationCatalogue.h"
+#include "searchTelemetry.h"
 
 using namespace std;
 using namespace yarp::os;
@@ -49,15 +54,19 @@ private:
     BufferedPort<Bottle>    m_lookObject_port;      //object research
     BufferedPort<Bottle>    m_objectFound_port;     //object research result
     BufferedPort<Bottle>    m_output_port;
+    BufferedPort<Bottle>    m_status_port;          //state of the search, pushed at every change
         
     string                  m_nextLoc_rpc_port_name; 
     string                  m_lookObject_port_name; 
     string                  m_objectFound_port_name;
     string                  m_output_port_name;
+    string                  m_status_port_name;
 
     //Devices
     PolyDriver              m_nav2DPoly;
     Nav2D::INavigation2D*   m_iNav2D{nullptr};
+    NavStatusCache*         m_navStatus{nullptr};
+    LocationCatalogue*      m_locations{nullptr};   //replica of the locations of the planner
 
     //ResourceFinder
     ResourceFinder&         m_rf;
@@ -70,13 +79,51 @@ private:
     double                  m_searching_time;
     string                  m_what;
     string                  m_where;
-    Bottle*                 m_coords;
+    Bottle                  m_coords;           //copy of the coordinates received from lookForObject
+    Stamp                   m_coords_stamp;
     bool                    m_where_specified;
     bool                    m_nowhere_else;
 
+    //multi-object search: the labels still to be found share the same tour
+    struct FoundObject
+    {
+        string              label;
+        Bottle              coords;
+        Stamp               stamp;
+    };
+    vector<string>          m_labels;
+    bool                    m_multi;
+    mutex                   m_found_mutex;
+    vector<FoundObject>     m_found;            //objects reported by lookForObject, not handled yet
+    bool                    m_location_done;    //lookForObject has finished the current location
+
+    //next location, fetched while the current one is being searched
+    string                  m_next_where;
+    Nav2D::Map2DLocation    m_next_loc;
+    bool                    m_next_valid;
+
+    //verification location requested while navigating, reached before the current one
+    mutex                   m_detour_mutex;
+    string                  m_detour;
+
     GetReadyToNav*          m_getReadyToNav;
     bool                    m_in_nav_position;
     double                  m_setNavPos_time;
+    int                     m_navPos_attempts;      //max consecutive failures before the search is ended
+    double                  m_navPos_retry_delay;
+    int                     m_navPos_failures;
+    double                  m_navPos_next_try;
+
+    //status stream
+    mutex                   m_publish_mutex;
+    int                     m_status_seq;       //sequence number of the published messages
+    int                     m_cmd_count;        //number of external commands handled
+    string                  m_last_published;
+    double                  m_last_publish_time;
+    double                  m_heartbeat_period;
+
+    SearchTelemetry*        m_telemetry{nullptr};
+    double                  m_search_start;     //start of the whole search, for telemetry
 
 public:
     //Contructor and distructor
@@ -96,11 +143,18 @@ public:
     //member functions
     void setWhat(string& what);
     void setWhatWhere(string& what, string& where);
+    void setWhats(vector<string>& whats);
+    void setWhatsWhere(vector<string>& whats, string& where);
+    bool addWhat(string& what);
+    bool dropWhat(string& what);
+    bool verifyWhere(string& where);
     void nextWhere();
+    void prefetchNextWhere();
     bool setNavigationPosition();
     bool goThere();
     bool search();
     bool objFound();
+    bool objectsFound();
     bool objNotFound();
     bool stopSearch();
     bool resumeSearch();
@@ -110,6 +164,16 @@ public:
     string getWhere();
     string getStatus();
 
+    //publishes the state of the search if changed, or if "force" is true or the heartbeat period has passed
+    void publishStatus(bool force = false);
+    //to be called after an external command has been handled
+    void commandDone();
+
+private:
+    void sendLabels();
+    string joinLabels(const vector<string>& labels);
+    string takeDetour();
+
 };
 
 #endif
@@ -0,0 +1,536 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "keyframeArchive.h"
+
+
+YARP_LOG_COMPONENT(KEYFRAME_ARCHIVE, "r1_obr.keyframeArchive")
+
+
+/****************************************************************/
+KeyframeArchive::KeyframeArchive() :
+    m_period(1.0),
+    m_capacity(2000),
+    m_downsample(4),
+    m_min_distance(0.5),
+    m_min_rotation(20.0 / 180 * M_PI),
+    m_has_last(false),
+    m_horizontal_fov(69.0 / 180 * M_PI),
+    m_batch_size(8),
+    m_max_query_frames(200),
+    m_min_confidence(0.85),
+    m_cluster_radius(1.0),
+    m_max_nominations(5)
+{
+    m_image_port_name           = "/keyframeArchive/image:i";
+    m_rpc_server_port_name      = "/keyframeArchive/rpc";
+    m_detector_rpc_port_name    = "/keyframeArchive/detector:rpc";
+    m_detector_image_port_name  = "/keyframeArchive/detector/image:o";
+    m_camera_frame_id           = "depth_center";
+    m_world_frame_id            = "map";
+    m_file                      = "keyframes.ring";
+}
+
+
+/****************************************************************/
+bool KeyframeArchive::configure(ResourceFinder &rf)
+{
+    // ------------ Generic config ------------ //
+    if(rf.check("period"))              {m_period = rf.find("period").asFloat32();}
+    if(rf.check("camera_frame_id"))     {m_camera_frame_id = rf.find("camera_frame_id").asString();}
+    if(rf.check("world_frame_id"))      {m_world_frame_id = rf.find("world_frame_id").asString();}
+    if(rf.check("file"))                {m_file = rf.find("file").asString();}
+    if(rf.check("capacity"))            {m_capacity = rf.find("capacity").asInt32();}
+    if(rf.check("downsample"))          {m_downsample = max(1, rf.find("downsample").asInt32());}
+    if(rf.check("min_distance"))        {m_min_distance = rf.find("min_distance").asFloat32();}
+    if(rf.check("min_rotation"))        {m_min_rotation = rf.find("min_rotation").asFloat32() / 180 * M_PI;}
+    if(rf.check("horizontal_fov"))      {m_horizontal_fov = rf.find("horizontal_fov").asFloat32() / 180 * M_PI;}
+    if(rf.check("batch_size"))          {m_batch_size = max(1, rf.find("batch_size").asInt32());}
+    if(rf.check("max_query_frames"))    {m_max_query_frames = rf.find("max_query_frames").asInt32();}
+    if(rf.check("min_confidence"))      {m_min_confidence = rf.find("min_confidence").asFloat32();}
+    if(rf.check("cluster_radius"))      {m_cluster_radius = rf.find("cluster_radius").asFloat32();}
+    if(rf.check("max_nominations"))     {m_max_nominations = rf.find("max_nominations").asInt32();}
+
+    int imageWidth = rf.check("image_width") ? rf.find("image_width").asInt32() : 640;
+    int imageHeight = rf.check("image_height") ? rf.find("image_height").asInt32() : 480;
+
+
+    // ------------ TransformClient config ------------ //
+    Property tcProp;
+    //default
+    tcProp.put("device", "frameTransformClient");
+    tcProp.put("ft_client_prefix", "/keyframeArchive");
+    tcProp.put("local_rpc", "/keyframeArchive/ftClient.rpc");
+    bool okTransformRf = rf.check("TRANSFORM_CLIENT");
+    if(!okTransformRf)
+    {
+        yCWarning(KEYFRAME_ARCHIVE,"TRANSFORM_CLIENT section missing in ini file Using default values");
+        tcProp.put("filexml_option","ftc_yarp_only.xml");
+    }
+    else {
+        Searchable &tf_config = rf.findGroup("TRANSFORM_CLIENT");
+        if (tf_config.check("ft_client_prefix")) {
+            tcProp.put("ft_client_prefix", tf_config.find("ft_client_prefix").asString());
+        }
+        if (tf_config.check("ft_server_prefix")) {
+            tcProp.put("ft_server_prefix", tf_config.find("ft_server_prefix").asString());
+        }
+        if(tf_config.check("filexml_option") && !(tf_config.check("testxml_from") || tf_config.check("testxml_context")))
+        {
+            tcProp.put("filexml_option", tf_config.find("filexml_option").asString());
+        }
+        else if(!tf_config.check("filexml_option") && (tf_config.check("testxml_from") && tf_config.check("testxml_context")))
+        {
+            tcProp.put("testxml_from", tf_config.find("testxml_from").asString());
+            tcProp.put("testxml_context", tf_config.find("testxml_context").asString());
+        }
+        else
+        {
+            yCError(KEYFRAME_ARCHIVE,"TRANSFORM_CLIENT is missing information about the frameTransformClient device configuration. Check your config. RETURNING");
+            return false;
+        }
+    }
+    m_tcPoly.open(tcProp);
+    if(!m_tcPoly.isValid())
+    {
+        yCError(KEYFRAME_ARCHIVE,"Error opening PolyDriver check parameters");
+        return false;
+    }
+    m_tcPoly.view(m_iTc);
+    if(!m_iTc)
+    {
+        yCError(KEYFRAME_ARCHIVE,"Error opening iFrameTransform interface. Device not available");
+        return false;
+    }
+
+
+    // ------------ Keyframes ring ------------ //
+    if(!m_ring.open(m_file, imageWidth / m_downsample, imageHeight / m_downsample, m_capacity))
+    {
+        yCError(KEYFRAME_ARCHIVE) << "Cannot open the keyframes file" << m_file;
+        return false;
+    }
+
+
+    // ------------ Open ports ------------ //
+    if(rf.check("detector_rpc_port")) {m_detector_rpc_port_name = rf.find("detector_rpc_port").asString();}
+    if(!m_detector_rpc_port.open(m_detector_rpc_port_name))
+    {
+        yCError(KEYFRAME_ARCHIVE) << "Cannot open port" << m_detector_rpc_port_name;
+        return false;
+    }
+
+    if(rf.check("detector_image_port")) {m_detector_image_port_name = rf.find("detector_image_port").asString();}
+    if(!m_detector_image_port.open(m_detector_image_port_name))
+    {
+        yCError(KEYFRAME_ARCHIVE) << "Cannot open port" << m_detector_image_port_name;
+        return false;
+    }
+
+    if(rf.check("rpc_port")) {m_rpc_server_port_name = rf.find("rpc_port").asString();}
+    if (!m_rpc_server_port.open(m_rpc_server_port_name))
+    {
+        yCError(KEYFRAME_ARCHIVE, "open() error could not open rpc port %s, check network", m_rpc_server_port_name.c_str());
+        return false;
+    }
+    if (!attach(m_rpc_server_port))
+    {
+        yCError(KEYFRAME_ARCHIVE, "attach() error with rpc port %s", m_rpc_server_port_name.c_str());
+        return false;
+    }
+
+    if(rf.check("image_port")) {m_image_port_name = rf.find("image_port").asString();}
+    m_image_port.useCallback(*this);
+    if(!m_image_port.open(m_image_port_name))
+    {
+        yCError(KEYFRAME_ARCHIVE) << "Cannot open port" << m_image_port_name;
+        return false;
+    }
+    else
+        yCInfo(KEYFRAME_ARCHIVE) << "opened port" << m_image_port_name;
+
+
+    return true;
+}
+
+
+/****************************************************************/
+bool KeyframeArchive::close()
+{
+    if (!m_image_port.isClosed())
+        m_image_port.close();
+
+    if (m_rpc_server_port.asPort().isOpen())
+        m_rpc_server_port.close();
+
+    if (m_detector_rpc_port.asPort().isOpen())
+        m_detector_rpc_port.close();
+
+    if (!m_detector_image_port.isClosed())
+        m_detector_image_port.close();
+
+    m_ring.close();
+
+    if(m_tcPoly.isValid())
+        m_tcPoly.close();
+
+    return true;
+}
+
+
+/****************************************************************/
+double KeyframeArchive::getPeriod()
+{
+    return m_period;
+}
+
+
+/****************************************************************/
+bool KeyframeArchive::updateModule()
+{
+    return true;
+}
+
+
+/****************************************************************/
+void KeyframeArchive::onRead(ImageOf<PixelRgb>& image)
+{
+    KeyframeRing::Keyframe now;
+    if (getCameraPose(now))
+    {
+        now.time = Time::now();
+        m_poses.push_back(now);
+        while (now.time - m_poses.front().time > 2.0)
+            m_poses.pop_front();
+    }
+
+    //the pose of the camera when the image has been taken, not when it has been received
+    Stamp stamp;
+    m_image_port.getEnvelope(stamp);
+    KeyframeRing::Keyframe pose;
+    if (!poseAt(stamp.isValid() ? stamp.getTime() : Time::now(), pose))
+        return;
+
+    //a keyframe is recorded only if the camera has moved or turned enough since the last one
+    if (m_has_last)
+    {
+        double dist = sqrt(pow(pose.x - m_last.x, 2) + pow(pose.y - m_last.y, 2));
+        double rot = fabs(atan2(sin(pose.yaw - m_last.yaw), cos(pose.yaw - m_last.yaw)));
+        if (dist < m_min_distance && rot < m_min_rotation)
+            return;
+    }
+
+    downsample(image, m_small);
+    if (m_ring.append(m_small, pose))
+    {
+        m_last = pose;
+        m_has_last = true;
+    }
+}
+
+
+/****************************************************************/
+bool KeyframeArchive::getCameraPose(KeyframeRing::Keyframe& pose)
+{
+    Matrix camera2world;
+    if (!m_iTc->getTransform(m_camera_frame_id, m_world_frame_id, camera2world))
+        return false;
+
+    pose.seq = 0;
+    pose.x = camera2world(0,3);
+    pose.y = camera2world(1,3);
+    pose.z = camera2world(2,3);
+    //the optical axis is the z axis of the camera frame
+    pose.yaw = atan2(camera2world(1,2), camera2world(0,2));
+
+    return true;
+}
+
+
+/****************************************************************/
+bool KeyframeArchive::poseAt(double time, KeyframeRing::Keyframe& pose)
+{
+    //interpolated between the poses read before and after the time
+    if (m_poses.empty() || time < m_poses.front().time)
+        return false;
+
+    if (time >= m_poses.back().time)
+    {
+        //the transform cannot be newer than the image by much
+        if (time - m_poses.back().time > 0.2)
+            return false;
+        pose = m_poses.back();
+        pose.time = time;
+        return true;
+    }
+
+    size_t i = 1;
+    while (m_poses[i].time < time)
+        i++;
+    const KeyframeRing::Keyframe& a = m_poses[i-1];
+    const KeyframeRing::Keyframe& b = m_poses[i];
+    double t = b.time > a.time ? (time - a.time) / (b.time - a.time) : 0.0;
+    pose.seq = 0;
+    pose.time = time;
+    pose.x = a.x + t * (b.x - a.x);
+    pose.y = a.y + t * (b.y - a.y);
+    pose.z = a.z + t * (b.z - a.z);
+    pose.yaw = a.yaw + t * atan2(sin(b.yaw - a.yaw), cos(b.yaw - a.yaw));
+
+    return true;
+}
+
+
+/****************************************************************/
+void KeyframeArchive::downsample(const ImageOf<PixelRgb>& image, ImageOf<PixelRgb>& small)
+{
+    //each pixel is the mean of a block of downsample x downsample pixels
+    int w = m_ring.width();
+    int h = m_ring.height();
+    int f = m_downsample;
+    small.resize(w, h);
+    int n = f * f;
+    for (int v=0; v<h; v++)
+    {
+        for (int u=0; u<w; u++)
+        {
+            int r = 0, g = 0, b = 0;
+            for (int dv=0; dv<f; dv++)
+            {
+                int sv = min(v*f + dv, (int)image.height() - 1);
+                for (int du=0; du<f; du++)
+                {
+                    const PixelRgb& p = image.pixel(min(u*f + du, (int)image.width() - 1), sv);
+                    r += p.r;
+                    g += p.g;
+                    b += p.b;
+                }
+            }
+            PixelRgb& out = small.pixel(u, v);
+            out.r = r / n;
+            out.g = g / n;
+            out.b = b / n;
+        }
+    }
+}
+
+
+/****************************************************************/
+bool KeyframeArchive::respond(const Bottle &cmd, Bottle &reply)
+{
+    reply.clear();
+    string cmd_0=cmd.get(0).asString();
+    if (cmd_0=="help")
+    {
+        reply.addVocab32("many");
+        reply.addString("query <text> : looks for 'text' in the keyframes, returns the poses from which it has been seen: ((<x> <y> <theta> <confidence> <time> <keyframes>) ...)");
+        reply.addString("near <x> <y> <radius> : returns the keyframes taken within 'radius' meters: ((<seq> <time> <x> <y> <theta>) ...)");
+        reply.addString("info : returns the number of keyframes and their size");
+        reply.addString("help : gets this list");
+    }
+    else if (cmd_0=="query" && cmd.size()==2)
+    {
+        //one query at a time, the detector is shared
+        lock_guard<mutex> lock(m_query_mutex);
+        Bottle& nominations = reply.addList();
+        if (!query(cmd.get(1).asString(), nominations))
+        {
+            reply.clear();
+            reply.addVocab32(Vocab32::encode("nack"));
+        }
+    }
+    else if (cmd_0=="near" && cmd.size()==4)
+    {
+        vector<KeyframeRing::Keyframe> keyframes;
+        m_ring.nearby(cmd.get(1).asFloat64(), cmd.get(2).asFloat64(), cmd.get(3).asFloat64(), keyframes);
+        Bottle& list = reply.addList();
+        for (const auto& kf : keyframes)
+        {
+            Bottle& b = list.addList();
+            b.addInt64(kf.seq);
+            b.addFloat64(kf.time);
+            b.addFloat64(kf.x);
+            b.addFloat64(kf.y);
+            b.addFloat64(kf.yaw / M_PI * 180);
+        }
+    }
+    else if (cmd_0=="info")
+    {
+        vector<KeyframeRing::Keyframe> keyframes;
+        m_ring.keyframes(keyframes);
+        reply.addString("keyframes");
+        reply.addInt32(keyframes.size());
+        reply.addString("of");
+        reply.addInt32(m_capacity);
+        reply.addString("size");
+        reply.addInt32(m_ring.width());
+        reply.addInt32(m_ring.height());
+    }
+    else
+    {
+        reply.addVocab32(Vocab32::encode("nack"));
+        yCWarning(KEYFRAME_ARCHIVE,"Error: wrong RPC command. Type 'help'");
+    }
+
+    if (reply.size()==0)
+        reply.addVocab32(Vocab32::encode("ack"));
+
+    return true;
+}
+
+
+/****************************************************************/
+bool KeyframeArchive::query(const string& text, Bottle& nominations)
+{
+    struct Nomination
+    {
+        double  x, y, theta;    //camera position, heading towards the detection
+        double  conf;
+        double  time;
+        int     keyframes;
+    };
+
+    vector<KeyframeRing::Keyframe> keyframes;
+    m_ring.keyframes(keyframes);
+    if (m_max_query_frames > 0 && (int)keyframes.size() > m_max_query_frames)
+        keyframes.resize(m_max_query_frames);   //the most recent ones
+    if (keyframes.empty())
+        return true;
+
+    if (m_detector_rpc_port.getOutputCount() == 0)
+    {
+        yCError(KEYFRAME_ARCHIVE, "The detector is not connected to %s", m_detector_rpc_port_name.c_str());
+        return false;
+    }
+
+    double start = Time::now();
+    double half_width = m_ring.width() / 2.0;
+    double focal = half_width / tan(m_horizontal_fov / 2);
+    vector<Nomination> found;
+    for (size_t first=0; first<keyframes.size(); first+=m_batch_size)
+    {
+        vector<KeyframeRing::Keyframe> batch(keyframes.begin() + first, keyframes.begin() + min(first + m_batch_size, keyframes.size()));
+        Bottle detections;
+        if (!detectBatch(text, batch, detections))
+            return false;
+
+        for (size_t i=0; i<batch.size(); i++)
+        {
+            //the most confident detection of each keyframe
+            Bottle* dets = detections.get(i).asList();
+            double conf = m_min_confidence;
+            double u = -1.0;
+            for (size_t d=0; dets && d<dets->size(); d++)
+            {
+                Bottle* det = dets->get(d).asList();
+                if (det && det->get(1).asFloat64() >= conf)
+                {
+                    conf = det->get(1).asFloat64();
+                    u = det->get(2).asFloat64();
+                }
+            }
+            if (u < 0)
+                continue;
+
+            const KeyframeRing::Keyframe& kf = batch[i];
+            double theta = kf.yaw - atan((u - half_width) / focal);
+
+            //keyframes taken close to each other, looking in the same direction, nominate the same pose
+            bool merged = false;
+            for (auto& nom : found)
+            {
+                if (sqrt(pow(nom.x - kf.x, 2) + pow(nom.y - kf.y, 2)) < m_cluster_radius && 
+                    fabs(atan2(sin(nom.theta - theta), cos(nom.theta - theta))) < M_PI / 4)
+                {
+                    if (conf > nom.conf)
+                    {
+                        nom.x = kf.x;
+                        nom.y = kf.y;
+                        nom.theta = theta;
+                        nom.conf = conf;
+                        nom.time = kf.time;
+                    }
+                    nom.keyframes++;
+                    merged = true;
+                    break;
+                }
+            }
+            if (!merged)
+                found.push_back({kf.x, kf.y, theta, conf, kf.time, 1});
+        }
+    }
+
+    sort(found.begin(), found.end(), [](const Nomination& a, const Nomination& b)
+    {
+        return a.conf > b.conf;
+    });
+    if (m_max_nominations > 0 && (int)found.size() > m_max_nominations)
+        found.resize(m_max_nominations);
+
+    for (const auto& nom : found)
+    {
+        Bottle& b = nominations.addList();
+        b.addFloat64(nom.x);
+        b.addFloat64(nom.y);
+        b.addFloat64(nom.theta / M_PI * 180);
+        b.addFloat64(nom.conf);
+        b.addFloat64(nom.time);
+        b.addInt32(nom.keyframes);
+    }
+
+    yCInfo(KEYFRAME_ARCHIVE, "Query '%s': %d keyframes checked in %.1f seconds, %d poses nominated", text.c_str(), (int)keyframes.size(), Time::now() - start, (int)found.size());
+
+    return true;
+}
+
+
+/****************************************************************/
+bool KeyframeArchive::detectBatch(const string& text, vector<KeyframeRing::Keyframe>& batch, Bottle& detections)
+{
+    //the images are queued by the detector, then it is asked to process all of them together
+    vector<KeyframeRing::Keyframe> sent;
+    for (const auto& kf : batch)
+    {
+        ImageOf<PixelRgb>& image = m_detector_image_port.prepare();
+        if (!m_ring.read(kf.seq, image))
+        {
+            m_detector_image_port.unprepare();  //overwritten meanwhile
+            continue;
+        }
+        Stamp stamp((int)kf.seq, kf.time);
+        m_detector_image_port.setEnvelope(stamp);
+        m_detector_image_port.write(true);
+        sent.push_back(kf);
+    }
+    m_detector_image_port.waitForWrite();
+    batch = sent;
+    if (sent.empty())
+        return true;
+
+    Bottle cmd;
+    cmd.addString("batch");
+    cmd.addString(text);
+    cmd.addInt32(sent.size());
+    if (!m_detector_rpc_port.write(cmd, detections) || detections.size() != sent.size())
+    {
+        yCError(KEYFRAME_ARCHIVE, "Wrong reply from the detector to: %s", cmd.toString().c_str());
+        return false;
+    }
+
+    return true;
+}
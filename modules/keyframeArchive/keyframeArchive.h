@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef KEYFRAME_ARCHIVE_H
+#define KEYFRAME_ARCHIVE_H
+
+#include <yarp/os/all.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/IFrameTransform.h>
+#include <yarp/sig/Image.h>
+#include <yarp/math/Math.h>
+#include <cmath>
+#include <algorithm>
+#include <deque>
+
+#include "keyframeRing.h"
+
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::sig;
+using namespace yarp::math;
+
+class KeyframeArchive : public RFModule, public TypedReaderCallback<ImageOf<PixelRgb>>
+{
+private:
+    double                          m_period;
+
+    //Ports
+    BufferedPort<ImageOf<PixelRgb>> m_image_port;
+    string                          m_image_port_name;
+    RpcServer                       m_rpc_server_port;
+    string                          m_rpc_server_port_name;
+    RpcClient                       m_detector_rpc_port;
+    string                          m_detector_rpc_port_name;
+    BufferedPort<ImageOf<PixelRgb>> m_detector_image_port;
+    string                          m_detector_image_port_name;
+
+    //Devices
+    PolyDriver                      m_tcPoly;
+    IFrameTransform*                m_iTc{nullptr};
+    string                          m_camera_frame_id;
+    string                          m_world_frame_id;
+
+    //Recording
+    KeyframeRing                    m_ring;
+    string                          m_file;
+    int                             m_capacity;
+    int                             m_downsample;
+    double                          m_min_distance;
+    double                          m_min_rotation;
+    bool                            m_has_last;
+    KeyframeRing::Keyframe          m_last;             //pose of the last keyframe recorded
+    deque<KeyframeRing::Keyframe>   m_poses;            //recent camera poses, with the time they have been read
+    ImageOf<PixelRgb>               m_small;
+
+    //Queries
+    double                          m_horizontal_fov;
+    int                             m_batch_size;
+    int                             m_max_query_frames;
+    double                          m_min_confidence;
+    double                          m_cluster_radius;
+    int                             m_max_nominations;
+    mutex                           m_query_mutex;
+
+public:
+    KeyframeArchive();
+    virtual bool configure(ResourceFinder &rf);
+    virtual bool close();
+    virtual double getPeriod();
+    virtual bool updateModule();
+    bool respond(const Bottle &cmd, Bottle &reply);
+
+    using TypedReaderCallback<ImageOf<PixelRgb>>::onRead;
+    void onRead(ImageOf<PixelRgb>& image) override;
+
+private:
+    bool getCameraPose(KeyframeRing::Keyframe& pose);
+    bool poseAt(double time, KeyframeRing::Keyframe& pose);
+    void downsample(const ImageOf<PixelRgb>& image, ImageOf<PixelRgb>& small);
+    bool query(const string& text, Bottle& nominations);
+    bool detectBatch(const string& text, vector<KeyframeRing::Keyframe>& batch, Bottle& detections);
+};
+
+#endif
@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "keyframeRing.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+YARP_LOG_COMPONENT(KEYFRAME_RING, "r1_obr.keyframeArchive.keyframeRing")
+
+static const char       RING_MAGIC[8] = {'R','1','K','F','R','I','N','G'};
+static const uint32_t   RING_VERSION = 1;
+
+
+/****************************************************************/
+KeyframeRing::KeyframeRing() :
+    m_fd(-1),
+    m_map(nullptr),
+    m_map_size(0),
+    m_slot_size(0),
+    m_header(nullptr)
+{
+}
+
+
+/****************************************************************/
+KeyframeRing::~KeyframeRing()
+{
+    close();
+}
+
+
+/****************************************************************/
+bool KeyframeRing::open(const string& path, int width, int height, int capacity)
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (width <= 0 || height <= 0 || capacity <= 0)
+        return false;
+
+    m_slot_size = sizeof(Keyframe) + (size_t)width * height * 3;
+    m_map_size = sizeof(FileHeader) + m_slot_size * capacity;
+
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (m_fd < 0)
+    {
+        yCError(KEYFRAME_RING) << "Cannot open" << path;
+        return false;
+    }
+
+    struct ::stat st;
+    bool reuse = ::fstat(m_fd, &st) == 0 && (size_t)st.st_size == m_map_size;
+    if (!reuse && ::ftruncate(m_fd, m_map_size) != 0)
+    {
+        yCError(KEYFRAME_RING) << "Cannot resize" << path;
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+
+    void* map = ::mmap(nullptr, m_map_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED)
+    {
+        yCError(KEYFRAME_RING) << "Cannot map" << path;
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    m_map = (uint8_t*)map;
+    m_header = (FileHeader*)m_map;
+
+    reuse = reuse && memcmp(m_header->magic, RING_MAGIC, sizeof(RING_MAGIC)) == 0 && m_header->version == RING_VERSION &&
+            m_header->width == (uint32_t)width && m_header->height == (uint32_t)height && m_header->capacity == (uint32_t)capacity;
+    if (!reuse)
+    {
+        //a new ring: all the slots are empty
+        memset(m_map, 0, m_map_size);
+        memcpy(m_header->magic, RING_MAGIC, sizeof(RING_MAGIC));
+        m_header->version = RING_VERSION;
+        m_header->width = width;
+        m_header->height = height;
+        m_header->capacity = capacity;
+        m_header->next_seq = 1;
+        msync(m_map, m_map_size, MS_ASYNC);
+    }
+
+    //pose index
+    m_index.resize(capacity);
+    int used = 0;
+    for (size_t slot=0; slot<(size_t)capacity; slot++)
+    {
+        memcpy(&m_index[slot], slotPose(slot), sizeof(Keyframe));
+        if (m_index[slot].seq != 0)
+            used++;
+    }
+
+    yCInfo(KEYFRAME_RING, "Keyframe ring %s: %d of %d keyframes of %dx%d pixels", path.c_str(), used, capacity, width, height);
+
+    return true;
+}
+
+
+/****************************************************************/
+void KeyframeRing::close()
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_map)
+    {
+        msync(m_map, m_map_size, MS_SYNC);
+        munmap(m_map, m_map_size);
+        m_map = nullptr;
+        m_header = nullptr;
+    }
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_index.clear();
+}
+
+
+/****************************************************************/
+int KeyframeRing::width()
+{
+    return m_header ? m_header->width : 0;
+}
+
+
+/****************************************************************/
+int KeyframeRing::height()
+{
+    return m_header ? m_header->height : 0;
+}
+
+
+/****************************************************************/
+KeyframeRing::Keyframe* KeyframeRing::slotPose(size_t slot)
+{
+    return (Keyframe*)(m_map + sizeof(FileHeader) + slot * m_slot_size);
+}
+
+
+/****************************************************************/
+uint8_t* KeyframeRing::slotPixels(size_t slot)
+{
+    return m_map + sizeof(FileHeader) + slot * m_slot_size + sizeof(Keyframe);
+}
+
+
+/****************************************************************/
+bool KeyframeRing::append(const ImageOf<PixelRgb>& image, const Keyframe& pose)
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_map || image.width() != m_header->width || image.height() != m_header->height)
+        return false;
+
+    uint64_t seq = m_header->next_seq;
+    size_t slot = (seq - 1) % m_header->capacity;
+
+    //the slot is marked as empty while being written, so that a crash never leaves a half-written keyframe
+    Keyframe* kf = slotPose(slot);
+    kf->seq = 0;
+    uint8_t* pixels = slotPixels(slot);
+    size_t row_size = (size_t)m_header->width * 3;
+    for (size_t r=0; r<m_header->height; r++)
+        memcpy(pixels + r * row_size, image.getRow(r), row_size);
+
+    Keyframe saved = pose;
+    saved.seq = seq;
+    memcpy(kf, &saved, sizeof(Keyframe));
+    m_header->next_seq = seq + 1;
+    m_index[slot] = saved;
+
+    msync(m_map, m_map_size, MS_ASYNC);
+
+    return true;
+}
+
+
+/****************************************************************/
+bool KeyframeRing::read(uint64_t seq, ImageOf<PixelRgb>& image)
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_map || seq == 0)
+        return false;
+
+    size_t slot = (seq - 1) % m_header->capacity;
+    if (m_index[slot].seq != seq)
+        return false;   //overwritten meanwhile
+
+    image.resize(m_header->width, m_header->height);
+    const uint8_t* pixels = slotPixels(slot);
+    size_t row_size = (size_t)m_header->width * 3;
+    for (size_t r=0; r<m_header->height; r++)
+        memcpy(image.getRow(r), pixels + r * row_size, row_size);
+
+    return true;
+}
+
+
+/****************************************************************/
+void KeyframeRing::keyframes(vector<Keyframe>& keyframes)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        keyframes.clear();
+        for (const auto& kf : m_index)
+        {
+            if (kf.seq != 0)
+                keyframes.push_back(kf);
+        }
+    }
+
+    sort(keyframes.begin(), keyframes.end(), [](const Keyframe& a, const Keyframe& b)
+    {
+        return a.seq > b.seq;
+    });
+}
+
+
+/****************************************************************/
+void KeyframeRing::nearby(double x, double y, double radius, vector<Keyframe>& keyframes)
+{
+    this->keyframes(keyframes);
+    keyframes.erase(remove_if(keyframes.begin(), keyframes.end(), [&](const Keyframe& kf)
+    {
+        return sqrt(pow(kf.x - x, 2) + pow(kf.y - y, 2)) > radius;
+    }), keyframes.end());
+}
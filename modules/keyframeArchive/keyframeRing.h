@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef KEYFRAME_RING_H
+#define KEYFRAME_RING_H
+
+#include <yarp/os/all.h>
+#include <yarp/sig/Image.h>
+#include <vector>
+#include <mutex>
+#include <cstdint>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+// Ring of keyframes in a memory-mapped file: when the ring is full the oldest keyframe is overwritten.
+// The file starts with a header, followed by "capacity" slots of the same size, each one made of the
+// camera pose and timestamp of the keyframe and of its RGB pixels.
+// The poses are also kept in memory (pose index), so that the keyframes can be selected without reading the file.
+class KeyframeRing
+{
+public:
+    struct Keyframe
+    {
+        uint64_t        seq;            //0 if the slot is empty
+        double          time;
+        double          x, y, z;        //camera position in the world frame
+        double          yaw;            //heading of the optical axis in the world frame, radians
+    };
+
+private:
+    struct FileHeader
+    {
+        char            magic[8];
+        uint32_t        version;
+        uint32_t        width;
+        uint32_t        height;
+        uint32_t        capacity;
+        uint64_t        next_seq;
+    };
+
+    int                 m_fd;
+    uint8_t*            m_map;
+    size_t              m_map_size;
+    size_t              m_slot_size;
+    FileHeader*         m_header;
+    vector<Keyframe>    m_index;        //one element per slot
+    mutex               m_mutex;
+
+    Keyframe*           slotPose(size_t slot);
+    uint8_t*            slotPixels(size_t slot);
+
+public:
+    KeyframeRing();
+    ~KeyframeRing();
+
+    //an existing file with a different size of images or capacity is overwritten
+    bool open(const string& path, int width, int height, int capacity);
+    void close();
+
+    int  width();
+    int  height();
+
+    //"image" must have the size of the ring
+    bool append(const ImageOf<PixelRgb>& image, const Keyframe& pose);
+    bool read(uint64_t seq, ImageOf<PixelRgb>& image);
+
+    //the keyframes in the ring, the most recent first
+    void keyframes(vector<Keyframe>& keyframes);
+    //the keyframes taken within "radius" from the given position on the floor, the most recent first
+    void nearby(double x, double y, double radius, vector<Keyframe>& keyframes);
+};
+
+#endif
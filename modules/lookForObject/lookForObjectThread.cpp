@@ -26,6 +26,7 @@ LookForObjectThread::LookForObjectThread(yarp::os::ResourceFinder &rf):
     TypedReaderCallback(),
     m_rf(rf),
     m_ext_stop(false),
+    m_multi(false),
     m_status(LfO_IDLE)
 {
     //Defaults
@@ -34,6 +35,7 @@ LookForObjectThread::LookForObjectThread(yarp::os::ResourceFinder &rf):
     m_gazeTargetOutPortName = "/lookForObject/gazeControllerTarget:o";
     m_objectCoordsPortName = "/lookForObject/objectCoordinates:i";
     m_wait_for_search = 4.0;
+    m_detections_wait = 1.0;
     m_object = "";
 }
 
@@ -54,6 +56,7 @@ bool LookForObjectThread::threadInit()
     }
     
     if (m_rf.check("wait_for_search")) {m_wait_for_search = m_rf.find("wait_for_search").asFloat32();}
+    if (m_rf.check("detections_wait")) {m_detections_wait = m_rf.find("detections_wait").asFloat32();}
     
     // --------- Navigation2DClient config --------- //
     yarp::os::Property nav2DProp;
@@ -87,6 +90,17 @@ bool LookForObjectThread::threadInit()
         yCError(LOOK_FOR_OBJECT_THREAD,"Error opening INavigation2D interface. Device not available");
         return false;
     }
+
+    // --------- Navigation status --------- //
+    std::string navStatusPort = m_rf.check("nav_status_port") ? m_rf.find("nav_status_port").asString() : "/navStatusBroadcaster/status:o";
+    m_navStatus = new NavStatusCache(m_iNav2D);
+    if(!m_navStatus->open("/lookForObject/navStatus:i", navStatusPort))
+        return false;
+    
+    // --------- Telemetry --------- //
+    m_telemetry = new SearchTelemetry("lookForObject");
+    if(!m_telemetry->configure(m_rf))
+        return false;
     
     // --------- open ports --------- //
     if(!m_outPort.open(m_outPortName)){
@@ -131,6 +145,20 @@ void LookForObjectThread::threadRelease()
     }
 
     m_robotOrient->close();
+
+    if(m_navStatus)
+    {
+        m_navStatus->close();
+        delete m_navStatus;
+        m_navStatus = nullptr;
+    }
+
+    if(m_telemetry)
+    {
+        m_telemetry->close();
+        delete m_telemetry;
+        m_telemetry = nullptr;
+    }
     
     yCInfo(LOOK_FOR_OBJECT_THREAD, "Thread released");
 
@@ -212,6 +240,17 @@ void LookForObjectThread::onRead(yarp::os::Bottle &b)
         }
         else
         {
+            //"(<object1> <object2> ...)" starts a multi-object search
+            std::vector<std::string> objects;
+            Bottle* list = b.get(0).asList();
+            if (list)
+            {
+                for (size_t i=0; i<list->size(); i++)
+                    objects.push_back(list->get(i).asString());
+            }
+            else
+                objects.push_back(obj);
+
             if (m_status == LfO_SEARCHING)
             {
                 m_ext_stop = true;
@@ -219,7 +258,9 @@ void LookForObjectThread::onRead(yarp::os::Bottle &b)
             }
             m_ext_stop = false;
             m_robotOrient->resetTurns();
-            m_object = obj;
+            m_multi = objects.size() > 1;
+            m_objects = objects;
+            m_object = m_multi ? b.get(0).asList()->toString() : obj;
             m_status = LfO_SEARCHING;
         }
         
@@ -238,6 +279,7 @@ void LookForObjectThread::onStop()
 bool LookForObjectThread::lookAround(std::string& ob)
 {
     m_robotOrient->resetOrients();
+    SearchTelemetry::Timer lookTimer(m_telemetry, "look_around");
 
     bool objectFound {false};
     int idx {1};
@@ -248,6 +290,8 @@ bool LookForObjectThread::lookAround(std::string& ob)
         if (m_robotOrient->next(replyOrient))
         {                        
             yCInfo(LOOK_FOR_OBJECT_THREAD) << "Checking head orientation: pos" + (std::string)(idx<10?"0":"") + std::to_string(idx);
+            m_telemetry->increment("head_orientations");
+            double gazeStart = m_telemetry->startTime();
             //gaze target output
             yarp::os::Bottle&  toSend1 = m_gazeTargetOutPort.prepare();
             toSend1.clear();
@@ -263,13 +307,30 @@ bool LookForObjectThread::lookAround(std::string& ob)
             m_gazeTargetOutPort.write(); //sending output command to gaze-controller 
 
             yarp::os::Time::delay(m_wait_for_search);  //waiting for the robot tilting its head
+            m_telemetry->addSample("head_settle", gazeStart);
+
+            //every object still to be found is checked in the same frame
+            if (m_multi)
+            {
+                if (lookInFrame())
+                {
+                    objectFound = true;
+                    break;
+                }
+                idx++;
+                yarp::os::Time::delay(0.2);
+                continue;
+            }
 
             //search for object
             Bottle request, reply;
             request.addString("where");
             request.addString(ob); 
             yCDebug(LOOK_FOR_OBJECT_THREAD, "Request to object finder: %s", request.toString().c_str());
-            if (m_findObjectPort.write(request,reply))
+            SearchTelemetry::Timer detectorTimer(m_telemetry, "detector_reply");
+            bool replied = m_findObjectPort.write(request,reply);
+            detectorTimer.stop();
+            if (replied)
             {
                 if (reply.get(0).asString()!="not found")
                 {
@@ -280,6 +341,7 @@ bool LookForObjectThread::lookAround(std::string& ob)
             else
             {
                 yCError(LOOK_FOR_OBJECT_THREAD,"Unable to communicate with findObject");
+                m_telemetry->increment("detector_errors");
             }
 
             idx++;
@@ -295,7 +357,14 @@ bool LookForObjectThread::lookAround(std::string& ob)
     
 
     
-    if (objectFound)
+    if (objectFound && m_multi)
+    {
+        yCInfo(LOOK_FOR_OBJECT_THREAD, "All the objects have been found");
+        m_robotOrient->home();
+        m_object = "";
+        m_status = LfO_IDLE;
+    }
+    else if (objectFound)
         m_status = LfO_OBJECT_FOUND;
     else if (!m_ext_stop)
         m_status = LfO_TURNING;
@@ -315,16 +384,19 @@ bool LookForObjectThread::turn()
     {
         double theta = reply.get(0).asFloat32();
         yCInfo(LOOK_FOR_OBJECT_THREAD) << "Turning" << theta << "degrees";
+        m_telemetry->increment("turns");
+        SearchTelemetry::Timer turnTimer(m_telemetry, "turn");
         yarp::dev::Nav2D::Map2DLocation loc;
-        m_iNav2D->getCurrentPosition(loc);
+        m_navStatus->getCurrentPosition(loc);
         loc.theta += theta; // <===
-        m_iNav2D->gotoTargetByAbsoluteLocation(loc);
+        m_navStatus->goalSent();
+        if (!m_iNav2D->gotoTargetByAbsoluteLocation(loc))
+            m_navStatus->goalFailed();
         yarp::dev::Nav2D::NavigationStatusEnum currentStatus;
-        m_iNav2D->getNavigationStatus(currentStatus);
+        m_navStatus->getNavigationStatus(currentStatus);
         while (currentStatus != yarp::dev::Nav2D::navigation_status_goal_reached  && !m_ext_stop  )
         {
-            yarp::os::Time::delay(0.2);
-            m_iNav2D->getNavigationStatus(currentStatus);
+            m_navStatus->waitForStatusChange(currentStatus, 0.2);
         }
 
         if (!m_ext_stop)
@@ -336,14 +408,78 @@ bool LookForObjectThread::turn()
 }    
 
 /****************************************************************/
-bool LookForObjectThread::getObjCoordinates(Bottle* btl, Bottle& out)
+bool LookForObjectThread::lookInFrame()
+{
+    SearchTelemetry::Timer detectorTimer(m_telemetry, "detector_reply");
+    Bottle* detections = readDetections();
+    detectorTimer.stop();
+    if (!detections)
+    {
+        yCError(LOOK_FOR_OBJECT_THREAD,"No detections received from the Object Finder");
+        m_telemetry->increment("detector_errors");
+        return false;
+    }
+
+    Stamp stamp;
+    m_objectCoordsPort.getEnvelope(stamp);
+    for (auto it = m_objects.begin(); it != m_objects.end(); )
+    {
+        Bottle coords;
+        if (getObjCoordinates(detections, *it, coords))
+        {
+            reportObject(*it, coords, stamp);
+            it = m_objects.erase(it);
+        }
+        else
+            ++it;
+    }
+
+    return m_objects.empty();
+}
+
+/****************************************************************/
+Bottle* LookForObjectThread::readDetections()
+{
+    //what has been received while the head was moving is discarded
+    while (m_objectCoordsPort.getPendingReads() > 0)
+        m_objectCoordsPort.read(false);
+
+    double timeout = Time::now() + m_detections_wait;
+    while (Time::now() < timeout && !m_ext_stop)
+    {
+        Bottle* detections = m_objectCoordsPort.read(false);
+        if (detections)
+            return detections;
+        Time::delay(0.02);
+    }
+
+    return nullptr;
+}
+
+/****************************************************************/
+void LookForObjectThread::reportObject(const std::string& label, Bottle& coords, Stamp& stamp)
+{
+    yCInfo(LOOK_FOR_OBJECT_THREAD, "%s found", label.c_str());
+
+    yarp::os::Bottle&  toSendOut = m_outPort.prepare();
+    toSendOut.clear();
+    toSendOut.addString(label);
+    Bottle& coordList = toSendOut.addList();
+    coordList = coords;
+    if (stamp.isValid())
+        m_outPort.setEnvelope(stamp);
+    m_outPort.write();
+}
+
+/****************************************************************/
+bool LookForObjectThread::getObjCoordinates(Bottle* btl, const std::string& label, Bottle& out)
 {
     double max_conf = 0.0;
     double x = -1.0, y;
     for (int i=0; i<btl->size(); i++)
     {
         Bottle* b = btl->get(i).asList();
-        if (b->get(0).asString() != m_object) //skip objects with another label
+        if (!b || b->get(0).asString() != label) //skip "nothing" and objects with another label
             continue;
         
         if(b->get(1).asFloat32() > max_conf) //get the object with the max confidence
@@ -375,7 +511,12 @@ bool LookForObjectThread::writeResult(bool objFound)
         Bottle* finderResult= m_objectCoordsPort.read(false); 
         if(finderResult != nullptr)
         {
-            if (!getObjCoordinates(finderResult, coordList))
+            //forwarding the timestamp of the image where the object has been detected
+            Stamp finderStamp;
+            if (m_objectCoordsPort.getEnvelope(finderStamp) && finderStamp.isValid())
+                m_outPort.setEnvelope(finderStamp);
+
+            if (!getObjCoordinates(finderResult, m_object, coordList))
             {
                 toSendOut.clear();
                 toSendOut.addString("object not found");
@@ -388,6 +529,7 @@ bool LookForObjectThread::writeResult(bool objFound)
     m_outPort.write();
 
     m_object = "";
+    m_objects.clear();
     m_status = LfO_IDLE;
     
     return true;
@@ -402,7 +544,7 @@ void LookForObjectThread::externalStop()
     m_status = LfO_IDLE;
 
     yarp::dev::Nav2D::NavigationStatusEnum currentStatus;
-    m_iNav2D->getNavigationStatus(currentStatus);
+    m_navStatus->getNavigationStatus(currentStatus);
     if (currentStatus == yarp::dev::Nav2D::navigation_status_moving)
     {
         m_iNav2D->stopNavigation();
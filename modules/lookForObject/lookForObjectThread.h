@@ -24,7 +24,10 @@
 #include <yarp/dev/INavigation2D.h>
 #include <yarp/os/all.h>
 #include <math.h>
+#include <vector>
 #include "robotOrient.h"
+#include "navStatusCache.h"
+#include "searchTelemetry.h"
 
 
 class LookForObjectThread : public yarp::os::Thread, 
@@ -44,6 +47,7 @@ private:
     //Devices
     yarp::dev::PolyDriver            m_nav2DPoly;
     yarp::dev::Nav2D::INavigation2D* m_iNav2D{nullptr};
+    NavStatusCache*                  m_navStatus{nullptr};
 
     //Ports
     std::string                                 m_outPortName;
@@ -58,11 +62,15 @@ private:
     //Others
     LfO_status                  m_status;
     std::string                 m_object;
+    std::vector<std::string>    m_objects;          //objects still to be found in a multi-object search
+    bool                        m_multi;
     double                      m_wait_for_search;
+    double                      m_detections_wait;  //max time to wait for the detections after the head has settled
     bool                        m_ext_stop;
     yarp::os::ResourceFinder&   m_rf;
     
     RobotOrient*             m_robotOrient;
+    SearchTelemetry*         m_telemetry{nullptr};
 
 
 public:
@@ -82,8 +90,11 @@ public:
 
     bool lookAround(std::string& ob);
     bool turn();
-    bool getObjCoordinates(Bottle* btl, Bottle& out);
+    bool lookInFrame();
+    Bottle* readDetections();
+    bool getObjCoordinates(Bottle* btl, const std::string& label, Bottle& out);
     bool writeResult(bool objFound);
+    void reportObject(const std::string& label, Bottle& coords, Stamp& stamp);
     void externalStop();
 
 };
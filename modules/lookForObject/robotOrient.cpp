@@ -25,6 +25,8 @@ RobotOrient::RobotOrient(yarp::os::ResourceFinder &rf) : m_rf(rf)
 {
     m_current_turn = 1;
     m_current_orient = 1;
+    m_horizontal_fov = 0.0;
+    m_vertical_fov = 0.0;
 }
 
 // ********************************************** //
@@ -37,47 +39,11 @@ bool RobotOrient::configure()
 
     bool useFov = m_rf.check("useCameraFOV") ? m_rf.find("useCameraFOV").asString()=="true" : false;
 
-    // --------- RGBDSensor config --------- //
-    Property rgbdProp;
-    // Prepare default prop object
-    rgbdProp.put("device", RGBDClient);
-    rgbdProp.put("localImagePort", RGBDLocalImagePort);
-    rgbdProp.put("localDepthPort", RGBDLocalDepthPort);
-    rgbdProp.put("localRpcPort", RGBDLocalRpcPort);
-    rgbdProp.put("remoteImagePort", RGBDRemoteImagePort);
-    rgbdProp.put("remoteDepthPort", RGBDRemoteDepthPort);
-    rgbdProp.put("remoteRpcPort", RGBDRemoteRpcPort);
-    rgbdProp.put("ImageCarrier", RGBDImageCarrier);
-    rgbdProp.put("DepthCarrier", RGBDDepthCarrier);
-    bool okRgbdRf = m_rf.check("RGBD_SENSOR_CLIENT");
-    if(!okRgbdRf)
+    // --------- Camera FOV --------- //
+    bool fovGot = getCameraFOV(m_horizontal_fov, m_vertical_fov);
+    if(!fovGot)
     {
-        yCWarning(ROBOT_ORIENT,"RGBD_SENSOR_CLIENT section missing in ini file. Using default values");
-    }
-    else
-    {
-        Searchable& rgbd_config = m_rf.findGroup("RGBD_SENSOR_CLIENT");
-        if(rgbd_config.check("device")) {rgbdProp.put("device", rgbd_config.find("device").asString());}
-        if(rgbd_config.check("localImagePort")) {rgbdProp.put("localImagePort", rgbd_config.find("localImagePort").asString());}
-        if(rgbd_config.check("localDepthPort")) {rgbdProp.put("localDepthPort", rgbd_config.find("localDepthPort").asString());}
-        if(rgbd_config.check("localRpcPort")) {rgbdProp.put("localRpcPort", rgbd_config.find("localRpcPort").asString());}
-        if(rgbd_config.check("remoteImagePort")) {rgbdProp.put("remoteImagePort", rgbd_config.find("remoteImagePort").asString());}
-        if(rgbd_config.check("remoteDepthPort")) {rgbdProp.put("remoteDepthPort", rgbd_config.find("remoteDepthPort").asString());}
-        if(rgbd_config.check("remoteRpcPort")) {rgbdProp.put("remoteRpcPort", rgbd_config.find("remoteRpcPort").asString());}
-        if(rgbd_config.check("ImageCarrier")) {rgbdProp.put("ImageCarrier", rgbd_config.find("ImageCarrier").asString());}
-        if(rgbd_config.check("DepthCarrier")) {rgbdProp.put("DepthCarrier", rgbd_config.find("DepthCarrier").asString());}
-    }
-
-    m_rgbdPoly.open(rgbdProp);
-    if(!m_rgbdPoly.isValid())
-    {
-        yCError(ROBOT_ORIENT,"Error opening PolyDriver check parameters");
-        return false;
-    }
-    m_rgbdPoly.view(m_iRgbd);
-    if(!m_iRgbd)
-    {
-        yCError(ROBOT_ORIENT,"Error opening iRGBD interface. Device not available");
+        yCError(ROBOT_ORIENT,"An error occurred while retrieving the rgb camera FOV");
         return false;
     }
     
@@ -187,19 +153,13 @@ bool RobotOrient::configure()
     }
     else 
     {
-        double verticalFov{0.0}, horizontalFov{0.0};
         double newVFov{0.0}, newHFov{0.0};
-        bool fovGot = m_iRgbd->getRgbFOV(horizontalFov,verticalFov);
-        if(!fovGot)
-        {
-            yCError(ROBOT_ORIENT,"An error occurred while retrieving the rgb camera FOV");
-        }
-        else
+        if(fovGot)
         {
             //consider the width of the fov to inspect an area of 180 degrees laterally and 90 degrees vertically
             // overlapping the views by at least <m_overlap> degrees
-            newHFov = horizontalFov>60 ?  (90.0 - horizontalFov/2) : (horizontalFov-m_overlap) ;
-            newVFov = verticalFov>30 ?  (45.0 - verticalFov/2) : (verticalFov-m_overlap) ;
+            newHFov = m_horizontal_fov>60 ?  (90.0 - m_horizontal_fov/2) : (m_horizontal_fov-m_overlap) ;
+            newVFov = m_vertical_fov>30 ?  (45.0 - m_vertical_fov/2) : (m_vertical_fov-m_overlap) ;
         }
         
         double min_pos_h {0}, min_pos_v {0};
@@ -231,11 +191,7 @@ bool RobotOrient::configure()
         visual_span = left-right;
     }
 
-    double _v_, horizontalFov{0.0};
-    if(!m_iRgbd->getRgbFOV(horizontalFov,_v_))
-        yCError(ROBOT_ORIENT,"An error occurred while retrieving the rgb camera FOV");
-    
-    m_max_turns = ceil(360.0/(visual_span+horizontalFov));
+    m_max_turns = ceil(360.0/(visual_span+m_horizontal_fov));
     m_turn_deg = 360.0/m_max_turns;
 
     return true;
@@ -327,9 +283,45 @@ bool RobotOrient::close()
 {
     if(m_Poly.isValid())
         m_Poly.close();
-
-    if(m_rgbdPoly.isValid())
-        m_rgbdPoly.close();
     
     return true;
 }
+
+// ********************************************** //
+bool RobotOrient::getCameraFOV(double& horizontalFov, double& verticalFov)
+{
+    // The FOV is the only information needed from the camera: it can be written in the .ini file
+    if(m_rf.check("CAMERA_INFO"))
+    {
+        Searchable& camera_config = m_rf.findGroup("CAMERA_INFO");
+        if(camera_config.check("horizontal_fov") && camera_config.check("vertical_fov"))
+        {
+            horizontalFov = camera_config.find("horizontal_fov").asFloat32();
+            verticalFov = camera_config.find("vertical_fov").asFloat32();
+            yCInfo(ROBOT_ORIENT) << "Using camera FOV from config file:" << horizontalFov << verticalFov;
+            return true;
+        }
+    }
+
+    // Otherwise the FOV is asked on the rpc port of the camera, without opening a RGBD client
+    string localRpc = RGBDLocalRpcPort;
+    string remoteRpc = RGBDRemoteRpcPort;
+    if(!m_rf.check("RGBD_SENSOR_CLIENT"))
+    {
+        yCWarning(ROBOT_ORIENT,"RGBD_SENSOR_CLIENT section missing in ini file. Using default values");
+    }
+    else
+    {
+        Searchable& rgbd_config = m_rf.findGroup("RGBD_SENSOR_CLIENT");
+        if(rgbd_config.check("localRpcPort")) {localRpc = rgbd_config.find("localRpcPort").asString();}
+        if(rgbd_config.check("remoteRpcPort")) {remoteRpc = rgbd_config.find("remoteRpcPort").asString();}
+    }
+
+    CameraInfo camera;
+    if(!camera.open(localRpc, remoteRpc))
+        return false;
+    bool ok = camera.getRgbFOV(horizontalFov,verticalFov);
+    camera.close();
+
+    return ok;
+}
@@ -22,7 +22,6 @@
 #include <yarp/os/Log.h>
 #include <yarp/os/LogStream.h>
 #include <yarp/dev/PolyDriver.h>
-#include <yarp/dev/IRGBDSensor.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/Port.h>
 #include <yarp/os/RFModule.h>
@@ -31,17 +30,11 @@
 #include <vector>
 #include <algorithm>
 #include <math.h>
+#include "cameraInfo.h"
 
 //Defaults RGBD sensor
-#define RGBDClient            "RGBDSensorClient"
-#define RGBDLocalImagePort    "/lookForObject/robotOrient/clientRgbPort:i"
-#define RGBDLocalDepthPort    "/lookForObject/robotOrient/clientDepthPort:i"
 #define RGBDLocalRpcPort      "/lookForObject/robotOrient/clientRpcPort"
-#define RGBDRemoteImagePort   "/cer/depthCamera/rgbImage:o"
-#define RGBDRemoteDepthPort   "/cer/depthCamera/depthImage:o"
 #define RGBDRemoteRpcPort     "/cer/depthCamera/rpc:i"
-#define RGBDImageCarrier      "mjpeg"
-#define RGBDDepthCarrier      "fast_tcp"
 
 using namespace std;
 using namespace yarp::os;
@@ -57,8 +50,9 @@ private:
     IPositionControl*     m_iposctrl;
     IControlLimits*       m_ilimctrl;      
 
-    PolyDriver            m_rgbdPoly;
-    IRGBDSensor*          m_iRgbd{nullptr};
+    //camera FOV (read once at configure, no image stream is connected)
+    double                m_horizontal_fov;
+    double                m_vertical_fov;
 
     //head orientations
     map<string, pair<double,double>>         m_orientations;
@@ -91,6 +85,9 @@ public:
     void resetTurns();
     void home();
     void help();
+
+private:
+    bool getCameraFOV(double& horizontalFov, double& verticalFov);
 };
 
 #endif 
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "mapMetadata.h"
+
+
+YARP_LOG_COMPONENT(MAP_METADATA, "r1_obr.mapMetadata")
+
+
+mutex  MapMetadata::s_mutex;
+string MapMetadata::s_map_name;
+
+
+/****************************************************************/
+bool MapMetadata::getMapName(NavStatusCache* navStatus, INavigation2D* iNav2D, string& name)
+{
+    //the lock is kept while fetching, so the components asking at the same time share the same fetch
+    lock_guard<mutex> lock(s_mutex);
+    if (s_map_name != "")
+    {
+        name = s_map_name;
+        return true;
+    }
+
+    Map2DLocation robot;
+    if (navStatus->getCurrentPosition(robot) && robot.map_id != "")
+    {
+        s_map_name = robot.map_id;
+    }
+    else
+    {
+        yCWarning(MAP_METADATA, "The robot pose is not available, downloading the global map to get its name");
+        MapGrid2D map;
+        if (!iNav2D->getCurrentNavigationMap(NavigationMapTypeEnum::global_map, map))
+        {
+            yCError(MAP_METADATA, "Error retrieving current global map");
+            return false;
+        }
+        s_map_name = map.getMapName();
+    }
+
+    yCInfo(MAP_METADATA, "Current map: %s", s_map_name.c_str());
+    name = s_map_name;
+    return true;
+}
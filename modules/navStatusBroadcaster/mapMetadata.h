@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef MAP_METADATA_H
+#define MAP_METADATA_H
+
+#include <yarp/os/all.h>
+#include <yarp/dev/INavigation2D.h>
+#include <mutex>
+#include "navStatusCache.h"
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::dev::Nav2D;
+
+// Metadata of the current navigation map, fetched once per process and shared by all the components
+// (e.g. the modules of r1Obr-composition). The name of the map is the one of the robot pose, that is
+// already in memory if navStatusBroadcaster is running: the whole global map is downloaded only if
+// the pose is not available.
+class MapMetadata
+{
+private:
+    static mutex    s_mutex;
+    static string   s_map_name;
+
+public:
+    static bool getMapName(NavStatusCache* navStatus, INavigation2D* iNav2D, string& name);
+};
+
+#endif
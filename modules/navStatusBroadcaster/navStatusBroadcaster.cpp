@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "navStatusBroadcaster.h"
+
+
+YARP_LOG_COMPONENT(NAV_STATUS_BROADCASTER, "r1_obr.navStatusBroadcaster")
+
+
+/****************************************************************/
+NavStatusBroadcaster::NavStatusBroadcaster() :
+    m_period(0.1),
+    m_heartbeat_period(0.5),
+    m_target_period(0.5),
+    m_pose_threshold(0.01),
+    m_angle_threshold(0.5),
+    m_status(navigation_status_error),
+    m_last_publish(-1.0),
+    m_last_target_read(-1.0)
+{
+    m_status_port_name = "/navStatusBroadcaster/status:o";
+}
+
+
+/****************************************************************/
+bool NavStatusBroadcaster::configure(ResourceFinder &rf)
+{
+    // ------------ Generic config ------------ //
+    if(rf.check("period"))              {m_period = rf.find("period").asFloat32();}
+    if(rf.check("heartbeat_period"))    {m_heartbeat_period = rf.find("heartbeat_period").asFloat32();}
+    if(rf.check("target_period"))       {m_target_period = rf.find("target_period").asFloat32();}
+    if(rf.check("pose_threshold"))      {m_pose_threshold = rf.find("pose_threshold").asFloat32();}
+    if(rf.check("angle_threshold"))     {m_angle_threshold = rf.find("angle_threshold").asFloat32();}
+
+
+    // --------- Navigation2DClient config --------- //
+    Property nav2DProp;
+    if(!rf.check("NAVIGATION_CLIENT"))
+    {
+        yCWarning(NAV_STATUS_BROADCASTER,"NAVIGATION_CLIENT section missing in ini file. Using the default values");
+    }
+    Searchable& nav_config = rf.findGroup("NAVIGATION_CLIENT");
+    nav2DProp.put("device", nav_config.check("device", Value("navigation2D_nwc_yarp")));
+    nav2DProp.put("local", nav_config.check("local", Value("/navStatusBroadcaster/navClient")));
+    nav2DProp.put("navigation_server", nav_config.check("navigation_server", Value("/navigation2D_nws_yarp")));
+    nav2DProp.put("map_locations_server", nav_config.check("map_locations_server", Value("/map2D_nws_yarp")));
+    nav2DProp.put("localization_server", nav_config.check("localization_server", Value("/localization2D_nws_yarp")));
+
+    m_nav2DPoly.open(nav2DProp);
+    if(!m_nav2DPoly.isValid())
+    {
+        yCError(NAV_STATUS_BROADCASTER,"Error opening PolyDriver check parameters");
+        return false;
+    }
+    m_nav2DPoly.view(m_iNav2D);
+    if(!m_iNav2D)
+    {
+        yCError(NAV_STATUS_BROADCASTER,"Error opening INavigation2D interface. Device not available");
+        return false;
+    }
+
+
+    // ------------ Open ports ------------ //
+    if(rf.check("status_port")) {m_status_port_name = rf.find("status_port").asString();}
+    if(!m_status_port.open(m_status_port_name))
+    {
+        yCError(NAV_STATUS_BROADCASTER) << "Cannot open port" << m_status_port_name;
+        return false;
+    }
+    else
+        yCInfo(NAV_STATUS_BROADCASTER) << "opened port" << m_status_port_name;
+
+    return true;
+}
+
+
+/****************************************************************/
+bool NavStatusBroadcaster::close()
+{
+    if (!m_status_port.isClosed())
+        m_status_port.close();
+
+    if(m_nav2DPoly.isValid())
+        m_nav2DPoly.close();
+
+    return true;
+}
+
+
+/****************************************************************/
+double NavStatusBroadcaster::getPeriod()
+{
+    return m_period;
+}
+
+
+/****************************************************************/
+bool NavStatusBroadcaster::updateModule()
+{
+    if (isStopping())
+        return false;
+
+    NavigationStatusEnum status;
+    Map2DLocation pose;
+    if (!m_iNav2D->getNavigationStatus(status) || !m_iNav2D->getCurrentPosition(pose))
+        return true;
+
+    bool statusChanged = status != m_status;
+    if (statusChanged)
+        yCDebug(NAV_STATUS_BROADCASTER) << "Navigation status:" << INavigation2DHelpers::statusToString(status);
+
+    //a new goal can be sent while the robot is moving (e.g. a detour), without any change of status:
+    //while a goal is active the target is read again every target_period seconds
+    bool targetChanged = false;
+    if (statusChanged || (status != navigation_status_idle && Time::now() - m_last_target_read > m_target_period))
+    {
+        Map2DLocation target;
+        if (status == navigation_status_idle || !m_iNav2D->getAbsoluteLocationOfCurrentTarget(target))
+            target = Map2DLocation();
+        m_last_target_read = Time::now();
+
+        targetChanged = target.map_id != m_target.map_id || target.x != m_target.x ||
+                        target.y != m_target.y || target.theta != m_target.theta;
+        m_target = target;
+    }
+
+    double dtheta = fabs(fmod(pose.theta - m_pose.theta + 540.0, 360.0) - 180.0);
+    bool moved = pose.map_id != m_pose.map_id ||
+                 hypot(pose.x - m_pose.x, pose.y - m_pose.y) > m_pose_threshold ||
+                 dtheta > m_angle_threshold;
+
+    m_status = status;
+    if (statusChanged || moved || targetChanged || Time::now() - m_last_publish > m_heartbeat_period)
+    {
+        m_pose = pose;
+        publish();
+    }
+
+    return true;
+}
+
+
+/****************************************************************/
+void NavStatusBroadcaster::publish()
+{
+    Bottle& b = m_status_port.prepare();
+    b.clear();
+    b.addInt32((int)m_status);
+    Bottle& pose = b.addList();
+    pose.addString(m_pose.map_id);
+    pose.addFloat64(m_pose.x);
+    pose.addFloat64(m_pose.y);
+    pose.addFloat64(m_pose.theta);
+    Bottle& target = b.addList();
+    target.addString(m_target.map_id);
+    target.addFloat64(m_target.x);
+    target.addFloat64(m_target.y);
+    target.addFloat64(m_target.theta);
+
+    m_stamp.update();
+    m_status_port.setEnvelope(m_stamp);
+    m_status_port.write();
+    m_last_publish = Time::now();
+}
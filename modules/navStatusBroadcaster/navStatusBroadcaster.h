@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef NAV_STATUS_BROADCASTER_H
+#define NAV_STATUS_BROADCASTER_H
+
+#include <yarp/os/all.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/INavigation2D.h>
+#include <cmath>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::dev::Nav2D;
+
+class NavStatusBroadcaster : public RFModule
+{
+private:
+    double                  m_period;
+    double                  m_heartbeat_period;
+    double                  m_target_period;    //the target is read again at this rate while a goal is active
+    double                  m_pose_threshold;   //meters
+    double                  m_angle_threshold;  //degrees
+
+    //Ports
+    BufferedPort<Bottle>    m_status_port;
+    string                  m_status_port_name;
+
+    //Devices
+    PolyDriver              m_nav2DPoly;
+    INavigation2D*          m_iNav2D{nullptr};
+
+    //Last published data
+    NavigationStatusEnum    m_status;
+    Map2DLocation           m_pose;
+    Map2DLocation           m_target;
+    double                  m_last_publish;
+    double                  m_last_target_read;
+    Stamp                   m_stamp;
+
+public:
+    NavStatusBroadcaster();
+    virtual bool configure(ResourceFinder &rf);
+    virtual bool close();
+    virtual double getPeriod();
+    virtual bool updateModule();
+
+private:
+    void publish();
+};
+
+#endif
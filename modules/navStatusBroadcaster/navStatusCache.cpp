@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "navStatusCache.h"
+
+
+YARP_LOG_COMPONENT(NAV_STATUS_CACHE, "r1_obr.navStatusCache")
+
+
+/****************************************************************/
+NavStatusCache::NavStatusCache(INavigation2D* iNav2D) :
+    m_iNav2D(iNav2D),
+    m_status(navigation_status_idle),
+    m_last_update(-1.0),
+    m_stale_time(2.0),
+    m_goal_pending(false),
+    m_goal_sent_time(-1.0),
+    m_goal_timeout(5.0)
+{
+}
+
+
+/****************************************************************/
+bool NavStatusCache::open(const string& local, const string& remote, double staleTime, double goalTimeout)
+{
+    m_stale_time = staleTime;
+    m_goal_timeout = goalTimeout;
+
+    m_port.useCallback(*this);
+    if(!m_port.open(local))
+    {
+        yCError(NAV_STATUS_CACHE) << "Cannot open port" << local;
+        return false;
+    }
+    yCInfo(NAV_STATUS_CACHE) << "opened port" << local;
+
+    if(!Network::connect(remote, local, "fast_tcp"))
+        yCWarning(NAV_STATUS_CACHE) << "Cannot connect to" << remote << ": the navigation status will be polled";
+
+    return true;
+}
+
+
+/****************************************************************/
+void NavStatusCache::close()
+{
+    if (!m_port.isClosed())
+    {
+        m_port.disableCallback();
+        m_port.close();
+    }
+}
+
+
+/****************************************************************/
+void NavStatusCache::onRead(Bottle& b)
+{
+    //format: <status> (<map> <x> <y> <theta>) (<target map> <x> <y> <theta>)
+    if (b.size() < 3)
+        return;
+    Bottle* pose = b.get(1).asList();
+    Bottle* target = b.get(2).asList();
+    if (pose == nullptr || target == nullptr || pose->size() < 4 || target->size() < 4)
+    {
+        yCWarning(NAV_STATUS_CACHE) << "Wrong navigation status format:" << b.toString();
+        return;
+    }
+
+    NavigationStatusEnum status = (NavigationStatusEnum)b.get(0).asInt32();
+    bool changed;
+    vector<function<void(NavigationStatusEnum)>> callbacks;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        changed = status != m_status;
+        m_status = status;
+        m_pose = Map2DLocation(pose->get(0).asString(), pose->get(1).asFloat64(), pose->get(2).asFloat64(), pose->get(3).asFloat64());
+        m_target = Map2DLocation(target->get(0).asString(), target->get(1).asFloat64(), target->get(2).asFloat64(), target->get(3).asFloat64());
+        m_last_update = Time::now();
+        if (status == navigation_status_moving)
+            m_goal_pending = false;
+        if (changed)
+            callbacks = m_callbacks;
+    }
+    m_cv.notify_all();
+
+    for (auto& callback : callbacks)
+        callback(status);
+}
+
+
+/****************************************************************/
+bool NavStatusCache::isFresh()
+{
+    if (m_goal_pending && Time::now() - m_goal_sent_time > m_goal_timeout)
+    {
+        //the goal has never been seen moving (e.g. rejected by the navigation server)
+        yCDebug(NAV_STATUS_CACHE) << "Pending goal not seen in" << m_goal_timeout << "seconds, using the broadcaster again";
+        m_goal_pending = false;
+    }
+
+    return m_last_update > 0 && Time::now() - m_last_update < m_stale_time && !m_goal_pending;
+}
+
+
+/****************************************************************/
+bool NavStatusCache::getNavigationStatus(NavigationStatusEnum& status)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (isFresh())
+        {
+            status = m_status;
+            return true;
+        }
+    }
+
+    bool ok = m_iNav2D->getNavigationStatus(status);
+    if (ok && (status == navigation_status_goal_reached || status == navigation_status_aborted))
+    {
+        //the last goal has already ended: from now on the broadcaster reports it correctly
+        lock_guard<mutex> lock(m_mutex);
+        m_goal_pending = false;
+    }
+    return ok;
+}
+
+
+/****************************************************************/
+bool NavStatusCache::getCurrentPosition(Map2DLocation& loc)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (m_last_update > 0 && Time::now() - m_last_update < m_stale_time)
+        {
+            loc = m_pose;
+            return true;
+        }
+    }
+
+    return m_iNav2D->getCurrentPosition(loc);
+}
+
+
+/****************************************************************/
+bool NavStatusCache::getAbsoluteLocationOfCurrentTarget(Map2DLocation& loc)
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (isFresh())
+        {
+            loc = m_target;
+            return true;
+        }
+    }
+
+    return m_iNav2D->getAbsoluteLocationOfCurrentTarget(loc);
+}
+
+
+/****************************************************************/
+bool NavStatusCache::waitForStatusChange(NavigationStatusEnum& status, double timeout)
+{
+    double deadline = Time::now() + timeout;
+    {
+        unique_lock<mutex> lock(m_mutex);
+        if (isFresh())
+        {
+            NavigationStatusEnum previous = status;
+            m_cv.wait_for(lock, chrono::duration<double>(timeout), [&]{ return m_status != previous || !isFresh(); });
+            if (isFresh())
+            {
+                status = m_status;
+                return true;
+            }
+        }
+    }
+
+    //no pushed data: same behaviour of a poll every "timeout" seconds
+    double left = deadline - Time::now();
+    if (left > 0)
+        Time::delay(left);
+    return getNavigationStatus(status);
+}
+
+
+/****************************************************************/
+void NavStatusCache::goalSent()
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_goal_pending = true;
+    m_goal_sent_time = Time::now();
+}
+
+
+/****************************************************************/
+void NavStatusCache::goalFailed()
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_goal_pending = false;
+}
+
+
+/****************************************************************/
+void NavStatusCache::addStatusCallback(function<void(NavigationStatusEnum)> callback)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_callbacks.push_back(callback);
+}
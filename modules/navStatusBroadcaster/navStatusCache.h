@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef NAV_STATUS_CACHE_H
+#define NAV_STATUS_CACHE_H
+
+#include <yarp/os/all.h>
+#include <yarp/dev/INavigation2D.h>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::dev::Nav2D;
+
+// Local copy of the navigation status and robot pose published by navStatusBroadcaster.
+// The getters read from memory. When no recent data has been received, or after a new goal
+// has been sent and the broadcaster has not reported it yet, they fall back to the RPCs of the
+// navigation client, so a module keeps working even if the broadcaster is not running.
+class NavStatusCache : public TypedReaderCallback<Bottle>
+{
+private:
+    BufferedPort<Bottle>    m_port;
+    INavigation2D*          m_iNav2D;
+
+    mutex                   m_mutex;
+    condition_variable      m_cv;
+    NavigationStatusEnum    m_status;
+    Map2DLocation           m_pose;
+    Map2DLocation           m_target;
+    double                  m_last_update;
+    double                  m_stale_time;
+    bool                    m_goal_pending;     //a goal has been sent but the broadcaster has not seen it yet
+    double                  m_goal_sent_time;
+    double                  m_goal_timeout;     //a pending goal not seen by then is ignored
+
+    vector<function<void(NavigationStatusEnum)>> m_callbacks;
+
+public:
+    NavStatusCache(INavigation2D* iNav2D);
+    ~NavStatusCache() = default;
+
+    bool open(const string& local, const string& remote, double staleTime = 2.0, double goalTimeout = 5.0);
+    void close();
+
+    using TypedReaderCallback<Bottle>::onRead;
+    void onRead(Bottle& b) override;
+
+    bool getNavigationStatus(NavigationStatusEnum& status);
+    bool getCurrentPosition(Map2DLocation& loc);
+    bool getAbsoluteLocationOfCurrentTarget(Map2DLocation& loc);
+
+    //waits until the status is different from "status" or the timeout expires. "status" is updated with the latest one
+    bool waitForStatusChange(NavigationStatusEnum& status, double timeout);
+
+    //to be called right before sending a navigation goal, and goalFailed if the goal has not been sent
+    void goalSent();
+    void goalFailed();
+
+    //called (from the port thread) every time the navigation status changes
+    void addStatusCallback(function<void(NavigationStatusEnum)> callback);
+
+private:
+    bool isFresh();
+};
+
+#endif
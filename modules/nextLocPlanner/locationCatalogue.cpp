@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "locationCatalogue.h"
+
+
+YARP_LOG_COMPONENT(LOCATION_CATALOGUE, "r1_obr.locationCatalogue")
+
+
+/****************************************************************/
+LocationCatalogue::LocationCatalogue(RpcClient& planner) :
+    m_rpc(planner),
+    m_seq(-1),
+    m_loaded(false),
+    m_last_update(-1.0),
+    m_stale_time(3.0),
+    m_last_load_time(-1.0)
+{
+}
+
+
+/****************************************************************/
+bool LocationCatalogue::open(const string& local, const string& remote, double staleTime)
+{
+    m_stale_time = staleTime;
+    m_remote = remote;
+
+    //every change must be applied: a lost one would force to load all the locations again
+    m_port.setStrict();
+    m_port.useCallback(*this);
+    if(!m_port.open(local))
+    {
+        yCError(LOCATION_CATALOGUE) << "Cannot open port" << local;
+        return false;
+    }
+    yCInfo(LOCATION_CATALOGUE) << "opened port" << local;
+
+    if(!Network::connect(remote, local, "fast_tcp"))
+        yCWarning(LOCATION_CATALOGUE) << "Cannot connect to" << remote << ": the locations will be asked to the planner";
+
+    return true;
+}
+
+
+/****************************************************************/
+void LocationCatalogue::close()
+{
+    if (!m_port.isClosed())
+    {
+        m_port.disableCallback();
+        m_port.close();
+    }
+}
+
+
+/****************************************************************/
+void LocationCatalogue::onRead(Bottle& b)
+{
+    //format: <seq> all|changes ((<name> <status> [<map_id> <x> <y> <theta>]) ...)  or  <seq> heartbeat
+    string type = b.get(1).asString();
+    Bottle* entries = b.get(2).asList();
+    if (b.size() < 2 || (type != "heartbeat" && entries == nullptr))
+    {
+        yCWarning(LOCATION_CATALOGUE) << "Wrong locations format:" << b.toString();
+        return;
+    }
+
+    int seq = b.get(0).asInt32();
+    lock_guard<mutex> lock(m_mutex);
+    m_last_update = Time::now();
+    if (type == "all")
+    {
+        apply(*entries, true);
+        m_seq = seq;
+        m_loaded = true;
+        return;
+    }
+
+    if (!m_loaded)
+        return;
+
+    if (type == "changes" && seq == m_seq + 1)
+    {
+        apply(*entries, false);
+        m_seq = seq;
+    }
+    else if (type != "heartbeat" || seq != m_seq)
+    {
+        //a change has been lost, or the planner has been restarted (a heartbeat carries the sequence number of the last change)
+        yCWarning(LOCATION_CATALOGUE, "Location changes lost (%s %d after %d): the catalogue will be loaded again", type.c_str(), seq, m_seq);
+        m_loaded = false;
+    }
+}
+
+
+/****************************************************************/
+void LocationCatalogue::apply(const Bottle& entries, bool all)
+{
+    if (all)
+        m_locations.clear();
+
+    for (size_t i=0; i<entries.size(); i++)
+    {
+        Bottle* entry = entries.get(i).asList();
+        if (entry == nullptr || entry->size() < 2)
+            continue;
+
+        string name = entry->get(0).asString();
+        string status = entry->get(1).asString();
+        if (status == "removed" || entry->size() < 6)
+        {
+            m_locations.erase(name);
+            continue;
+        }
+
+        Location& loc = m_locations[name];
+        loc.status = status;
+        loc.pose = Map2DLocation(entry->get(2).asString(), entry->get(3).asFloat64(), entry->get(4).asFloat64(), entry->get(5).asFloat64());
+    }
+}
+
+
+/****************************************************************/
+bool LocationCatalogue::load()
+{
+    Bottle req, rep;
+    req.addString("catalogue");
+    if (!m_rpc.write(req, rep) || rep.get(1).asString() != "all" || !rep.get(2).isList())
+    {
+        yCWarning(LOCATION_CATALOGUE, "Cannot load the locations from the planner");
+        return false;
+    }
+
+    onRead(rep);
+    yCInfo(LOCATION_CATALOGUE, "Loaded %d locations", (int)rep.get(2).asList()->size());
+    return true;
+}
+
+
+/****************************************************************/
+bool LocationCatalogue::upToDate()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (m_loaded && Time::now() - m_last_update < m_stale_time)
+            return true;
+
+        //at most one attempt per second, the planner could be missing
+        if (m_last_load_time > 0 && Time::now() - m_last_load_time < 1.0)
+            return false;
+        m_last_load_time = Time::now();
+    }
+
+    //the notifications could have never been connected, or the planner could have been restarted
+    if (m_port.getInputCount() == 0 && Network::connect(m_remote, m_port.getName(), "fast_tcp"))
+        yCInfo(LOCATION_CATALOGUE) << "Connected to" << m_remote;
+
+    return load();
+}
+
+
+/****************************************************************/
+bool LocationCatalogue::find(const string& name, Bottle& reply)
+{
+    reply.clear();
+    if (upToDate())
+    {
+        lock_guard<mutex> lock(m_mutex);
+        auto it = m_locations.find(name);
+        if (it != m_locations.end())
+        {
+            reply.addString("ok");
+            reply.addString(it->second.status);
+        }
+        else
+            reply.addString("notValid");
+        return true;
+    }
+
+    Bottle req;
+    req.addString("find");
+    req.addString(name);
+    return m_rpc.write(req, reply);
+}
+
+
+/****************************************************************/
+bool LocationCatalogue::getLocation(const string& name, Map2DLocation& pose)
+{
+    if (!upToDate())
+        return false;
+
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_locations.find(name);
+    if (it == m_locations.end())
+        return false;
+
+    pose = it->second.pose;
+    return true;
+}
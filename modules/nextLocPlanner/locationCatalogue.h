@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef LOCATION_CATALOGUE_H
+#define LOCATION_CATALOGUE_H
+
+#include <yarp/os/all.h>
+#include <yarp/dev/INavigation2D.h>
+#include <mutex>
+#include <map>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::dev::Nav2D;
+
+// Local replica of the locations of nextLocPlanner: pose and status of every location.
+// All the locations are loaded at once with the "catalogue" command of the planner, then the replica
+// is updated by the changes published by the planner, so the queries are answered from memory.
+// If the replica is out of date (no change or heartbeat received for a while) the queries are
+// forwarded to the planner, so a module keeps working even if the notifications are not connected,
+// and the connection to the planner is tried again.
+class LocationCatalogue : public TypedReaderCallback<Bottle>
+{
+private:
+    struct Location
+    {
+        string          status;     //unchecked, checking or checked
+        Map2DLocation   pose;
+    };
+
+    BufferedPort<Bottle>    m_port;
+    RpcClient&              m_rpc;
+    string                  m_remote;
+
+    mutex                   m_mutex;
+    map<string, Location>   m_locations;
+    int                     m_seq;              //sequence number of the last change applied
+    bool                    m_loaded;           //false until the first load, and after a change has been lost
+    double                  m_last_update;
+    double                  m_stale_time;
+    double                  m_last_load_time;   //last attempt to connect and load
+
+public:
+    LocationCatalogue(RpcClient& planner);
+    ~LocationCatalogue() = default;
+
+    bool open(const string& local, const string& remote, double staleTime = 3.0);
+    void close();
+
+    using TypedReaderCallback<Bottle>::onRead;
+    void onRead(Bottle& b) override;
+
+    //same reply of the "find" command of the planner: "ok <status>" or "notValid"
+    bool find(const string& name, Bottle& reply);
+
+    //false if the location is unknown or the replica is out of date
+    bool getLocation(const string& name, Map2DLocation& pose);
+
+private:
+    bool upToDate();
+    bool load();
+    void apply(const Bottle& entries, bool all);
+};
+
+#endif
@@ -23,7 +23,8 @@ YARP_LOG_COMPONENT(NEXT_LOC_PLANNER, "r1_obr.nextLocPlanner")
 
 NextLocPlanner::NextLocPlanner() :
     m_period(1.0),
-    m_area("")
+    m_area(""),
+    m_catalogue_seq(0)
 {  
 }
 
@@ -46,6 +47,14 @@ bool NextLocPlanner::configure(ResourceFinder &rf)
         return false;
     }
 
+    //Open the port of the location changes
+    string locationsPortName = rf.check("locations_port") ? rf.find("locations_port").asString() : "/nextLocPlanner/locations:o";
+    if (!m_locations_port.open(locationsPortName))
+    {
+        yCError(NEXT_LOC_PLANNER, "open() error could not open port %s, check network", locationsPortName.c_str());
+        return false;
+    }
+
     //Navigation2DClient config 
     Property nav2DProp;
         //Defaults
@@ -79,16 +88,22 @@ bool NextLocPlanner::configure(ResourceFinder &rf)
         return false;
     }
 
-    MapGrid2D  map;
-    if(!m_iNav2D->getCurrentNavigationMap(NavigationMapTypeEnum::global_map, map))
+    // --------- Navigation status --------- //
+    string navStatusPort = rf.check("nav_status_port") ? rf.find("nav_status_port").asString() : "/navStatusBroadcaster/status:o";
+    m_navStatus = new NavStatusCache(m_iNav2D);
+    if(!m_navStatus->open("/nextLocPlanner/navStatus:i", navStatusPort))
+        return false;
+
+    //only the name of the map is needed, not the grid
+    if(!MapMetadata::getMapName(m_navStatus, m_iNav2D, m_map_name))
     {
         yCError(NEXT_LOC_PLANNER, "Error retrieving current global map");
     }
-    m_map_name = map.getMapName();
 
     //Load all the locations in m_all_locations
     vector<string> all_locations;
-    if (!m_iNav2D->getLocationsList(all_locations)) 
+    vector<Map2DLocation> all_poses;
+    if (!loadLocations(rf, all_locations, all_poses)) 
     {
         yCError(NEXT_LOC_PLANNER,"Error getting locations list from map server");
         return false;
@@ -97,12 +112,13 @@ bool NextLocPlanner::configure(ResourceFinder &rf)
 
     if(!all_locations.empty()) 
     {
-        for (string & loc_name : all_locations)
+        for (size_t i=0; i<all_locations.size(); i++)
         {
-            Map2DLocation loc;
-            m_iNav2D->getLocation(loc_name, loc);
-            if(loc.map_id == m_map_name)
-                m_all_locations.push_back(loc_name);
+            if(all_poses[i].map_id == m_map_name)
+            {
+                m_all_locations.push_back(all_locations[i]);
+                m_poses[all_locations[i]] = all_poses[i];
+            }
         }
         if(m_all_locations.empty()) 
         {
@@ -130,10 +146,54 @@ bool NextLocPlanner::configure(ResourceFinder &rf)
     {
         yCWarning(NEXT_LOC_PLANNER,"Warning: no locations from map server");
     }
+
+    publishChanges();
     
     return true;
 }
 
+
+/****************************************************************/
+bool NextLocPlanner::loadLocations(ResourceFinder &rf, vector<string>& names, vector<Map2DLocation>& poses)
+{
+    //all the poses with two requests to the map server, instead of one request per location
+    Property mapProp;
+    mapProp.put("device", "map2D_nwc_yarp");
+    mapProp.put("local", "/nextLocPlanner/mapClient");
+    mapProp.put("remote", "/map2D_nws_yarp");
+    if(rf.check("NAVIGATION_CLIENT"))
+    {
+        Searchable& nav_config = rf.findGroup("NAVIGATION_CLIENT");
+        if(nav_config.check("map_locations_server")) {mapProp.put("remote", nav_config.find("map_locations_server").asString());}
+    }
+
+    PolyDriver mapPoly;
+    IMap2D* iMap{nullptr};
+    if (mapPoly.open(mapProp))
+        mapPoly.view(iMap);
+
+    //the map server lists the names and the locations in the same order
+    bool ok = iMap && iMap->getLocationsList(names) && iMap->getAllLocations(poses) && names.size() == poses.size();
+    if (mapPoly.isValid())
+        mapPoly.close();
+    if (ok)
+        return true;
+
+    yCWarning(NEXT_LOC_PLANNER,"Cannot get all the locations at once from the map server, asking them one by one");
+    names.clear();
+    poses.clear();
+    if (!m_iNav2D->getLocationsList(names))
+        return false;
+    for (const string& name : names)
+    {
+        Map2DLocation loc;
+        m_iNav2D->getLocation(name, loc);
+        poses.push_back(loc);
+    }
+
+    return true;
+}
+
 /****************************************************************/
 bool NextLocPlanner::close()
 {
@@ -141,6 +201,16 @@ bool NextLocPlanner::close()
     if (m_rpc_server_port.asPort().isOpen())
         m_rpc_server_port.close();
 
+    if (!m_locations_port.isClosed())
+        m_locations_port.close();
+
+    if(m_navStatus)
+    {
+        m_navStatus->close();
+        delete m_navStatus;
+        m_navStatus = nullptr;
+    }
+
     if(m_nav2DPoly.isValid())
         m_nav2DPoly.close();
        
@@ -187,6 +257,9 @@ bool NextLocPlanner::setLocationStatus(const string location_name, const string&
     }
     else if (location_name=="all")
     {
+        //the verification locations belong to the search that is over
+        while (!m_verify_locations.empty())
+            removeVerifyLocation(m_verify_locations.back());
         
         if (uncheckedOk)   
         {
@@ -217,6 +290,9 @@ bool NextLocPlanner::setLocationStatus(const string location_name, const string&
         return false;
     }
 
+    if (checkedOk && isVerifyLocation(location_name))
+        removeVerifyLocation(location_name);
+
     sortUncheckedLocations();
     
     return true;
@@ -255,18 +331,33 @@ bool NextLocPlanner::respond(const Bottle &cmd, Bottle &reply)
                 reply.addString("noLocation");
             }      
         }
+        else if (cmd_0=="peek")
+        {
+            //same as "next" but the status of the location is not changed
+            if (m_locations_unchecked.size()>0)
+                reply.addString(m_locations_unchecked[0]);
+            else
+                reply.addString("noLocation");
+        }
+        else if (cmd_0=="catalogue")
+        {
+            fillCatalogue(reply);
+        }
         else if (cmd_0=="help")
         {
             reply.addVocab32("many");
             reply.addString("next : returns the next unchecked location or noLocation");
+            reply.addString("peek : returns the location that next would return, without changing its status");
             reply.addString("set <locationName> <status> : sets the status of a location to unchecked, checking or checked");
             reply.addString("set all <status> : sets the status of all locations");
             reply.addString("find <locationName> : checks if a location is in the list of the available ones");
             reply.addString("remove <locationName> : removes the defined location by any list");
             reply.addString("add <locationName> : adds a previously defined location in the unchecked list");
             reply.addString("add <locationName> <x,y,th coordinates>: adds a new location in the unchecked list");
+            reply.addString("verify <locationName> <x,y,th coordinates>: adds a temporary location, returned by next before the others and removed once checked");
             reply.addString("list : lists all the locations and their status");
             reply.addString("list2 : lists all the locations divided by their status");
+            reply.addString("catalogue : returns pose and status of all the locations: <seq> all ((<locationName> <status> <map> <x> <y> <th>) ...)");
             reply.addString("close : closes the nextLocationPlanner module");
             reply.addString("help : gets this list");
         }
@@ -399,7 +490,7 @@ bool NextLocPlanner::respond(const Bottle &cmd, Bottle &reply)
             yCWarning(NEXT_LOC_PLANNER,"Error: wrong RPC command. Type 'help'");
         }
     }
-    else if (cmd.size()==5)    //expected 'add <location> <x> <y> <th>'
+    else if (cmd.size()==5)    //expected 'add <location> <x> <y> <th>' or 'verify <location> <x> <y> <th>'
     {
         
         string locName = cmd.get(1).asString();
@@ -410,11 +501,21 @@ bool NextLocPlanner::respond(const Bottle &cmd, Bottle &reply)
         Map2DLocation loc;
         loc.map_id=m_map_name;
         loc.x=x;
-        loc.x=y;
+        loc.y=y;
         loc.theta=th;
         loc.description=locName;
 
-        if(addLocation(locName, loc))
+        if (cmd_0=="verify")
+        {
+            if(addVerifyLocation(locName, loc))
+                reply.addString(locName + " added");
+            else
+            {
+                reply.addVocab32(Vocab32::encode("nack"));
+                yCWarning(NEXT_LOC_PLANNER,"Cannot add verification location %s", locName.c_str());
+            }
+        }
+        else if(addLocation(locName, loc))
             reply.addString(locName + " added");
         else
         {
@@ -432,6 +533,8 @@ bool NextLocPlanner::respond(const Bottle &cmd, Bottle &reply)
     if (reply.size()==0)
         reply.addVocab32(Vocab32::encode("ack")); 
 
+    publishChanges();
+
     return true;
 }
 
@@ -491,8 +594,12 @@ double NextLocPlanner::distRobotLocation(const string& location_name)
 {
     Map2DLocation robotLoc;
     Map2DLocation loc;
-    m_iNav2D->getCurrentPosition(robotLoc);
-    m_iNav2D->getLocation(location_name, loc);
+    m_navStatus->getCurrentPosition(robotLoc);
+    auto it = m_poses.find(location_name);
+    if (it != m_poses.end())
+        loc = it->second;
+    else
+        m_iNav2D->getLocation(location_name, loc);
 
     return sqrt(pow((robotLoc.x - loc.x), 2) + pow((robotLoc.y - loc.y), 2));
 }
@@ -505,6 +612,9 @@ bool NextLocPlanner::updateModule()
     lock_guard<mutex> lock(m_mutex);
 
     sortUncheckedLocations();
+
+    //heartbeat for the replicas, if nothing has changed
+    publishChanges();
     
     return true;
 }
@@ -532,12 +642,25 @@ void NextLocPlanner::sortUncheckedLocations()
 
     // Write the sorted pairs back to the original vectors
     unzip(zipped, m_locations_unchecked, m_unchecked_dist);
+
+    // The verification locations come first
+    stable_partition(m_locations_unchecked.begin(), m_locations_unchecked.end(), 
+        [this](const string& loc)
+        {
+            return isVerifyLocation(loc);
+        });
 }
 
 
 /****************************************************************/
 bool NextLocPlanner::removeLocation(string& location_name)
 {
+    if (isVerifyLocation(location_name))
+    {
+        removeVerifyLocation(location_name);
+        return true;
+    }
+
     vector<string>::iterator findUnchecked {find(m_locations_unchecked.begin(), m_locations_unchecked.end(), location_name)};
     vector<string>::iterator findChecking {find(m_locations_checking.begin(), m_locations_checking.end(), location_name)};
     vector<string>::iterator findChecked {find(m_locations_checked.begin(), m_locations_checked.end(), location_name)};
@@ -569,8 +692,149 @@ bool NextLocPlanner::addLocation(string& location_name)
 bool NextLocPlanner::addLocation(string locName, Map2DLocation loc)
 {
     m_iNav2D->storeLocation(locName, loc);
+    m_poses[locName] = loc;
     m_all_locations.push_back(locName);
     m_locations_unchecked.push_back(locName);
 
     return true;
-}
\ No newline at end of file
+}
+
+
+/****************************************************************/
+bool NextLocPlanner::addVerifyLocation(string locName, Map2DLocation loc)
+{
+    //a location with the same name is replaced
+    if (isVerifyLocation(locName))
+        removeVerifyLocation(locName);
+    else if (find(m_all_locations.begin(), m_all_locations.end(), locName) != m_all_locations.end())
+        return false;
+
+    //stored in the map server, so that the navigation can reach it by name
+    if (!m_iNav2D->storeLocation(locName, loc))
+        return false;
+
+    m_all_locations.push_back(locName);
+    m_poses[locName] = loc;
+    m_verify_locations.push_back(locName);
+    m_locations_unchecked.insert(m_locations_unchecked.begin(), locName);
+    sortUncheckedLocations();
+
+    yCInfo(NEXT_LOC_PLANNER,"Verification location %s added at %.2f %.2f %.1f", locName.c_str(), loc.x, loc.y, loc.theta);
+    return true;
+}
+
+
+/****************************************************************/
+bool NextLocPlanner::isVerifyLocation(const string& location_name)
+{
+    return find(m_verify_locations.begin(), m_verify_locations.end(), location_name) != m_verify_locations.end();
+}
+
+
+/****************************************************************/
+void NextLocPlanner::removeVerifyLocation(const string& location_name)
+{
+    //a copy, the name could be an element of the vectors
+    string name = location_name;
+    for (auto* locations : {&m_all_locations, &m_verify_locations, &m_locations_unchecked, &m_locations_checking, &m_locations_checked})
+        locations->erase(remove(locations->begin(), locations->end(), name), locations->end());
+    m_poses.erase(name);
+
+    m_iNav2D->deleteLocation(name);
+}
+
+
+/****************************************************************/
+string NextLocPlanner::locationStatus(const string& location_name)
+{
+    if (find(m_locations_unchecked.begin(), m_locations_unchecked.end(), location_name) != m_locations_unchecked.end())
+        return "unchecked";
+    if (find(m_locations_checking.begin(), m_locations_checking.end(), location_name) != m_locations_checking.end())
+        return "checking";
+    if (find(m_locations_checked.begin(), m_locations_checked.end(), location_name) != m_locations_checked.end())
+        return "checked";
+    return "removed";
+}
+
+
+/****************************************************************/
+void NextLocPlanner::addCatalogueEntry(Bottle& entry, const string& location_name, const string& status)
+{
+    //format: <name> <status> [<map_id> <x> <y> <theta>], no pose for a removed location
+    entry.addString(location_name);
+    entry.addString(status);
+    auto it = m_poses.find(location_name);
+    if (status != "removed" && it != m_poses.end())
+    {
+        entry.addString(it->second.map_id);
+        entry.addFloat64(it->second.x);
+        entry.addFloat64(it->second.y);
+        entry.addFloat64(it->second.theta);
+    }
+}
+
+
+/****************************************************************/
+void NextLocPlanner::fillCatalogue(Bottle& b)
+{
+    b.addInt32(m_catalogue_seq);
+    b.addString("all");
+    Bottle& list = b.addList();
+    for (const string& name : m_all_locations)
+    {
+        string status = locationStatus(name);
+        if (status != "removed")
+            addCatalogueEntry(list.addList(), name, status);
+    }
+}
+
+
+/****************************************************************/
+void NextLocPlanner::publishChanges()
+{
+    if (m_locations_port.isClosed())
+        return;
+
+    //the entries changed since the last publication, compared as text
+    Bottle changes;
+    for (const string& name : m_all_locations)
+    {
+        Bottle entry;
+        addCatalogueEntry(entry, name, locationStatus(name));
+        string text = entry.toString();
+        auto it = m_published.find(name);
+        if (it == m_published.end() || it->second != text)
+        {
+            changes.addList() = entry;
+            m_published[name] = text;
+        }
+    }
+    for (auto it = m_published.begin(); it != m_published.end(); )
+    {
+        if (find(m_all_locations.begin(), m_all_locations.end(), it->first) == m_all_locations.end())
+        {
+            addCatalogueEntry(changes.addList(), it->first, "removed");
+            it = m_published.erase(it);
+        }
+        else
+            it++;
+    }
+
+    //without changes only a heartbeat is sent, carrying the sequence number of the last change
+    Bottle& b = m_locations_port.prepare();
+    b.clear();
+    if (changes.size() > 0)
+    {
+        m_catalogue_seq++;
+        b.addInt32(m_catalogue_seq);
+        b.addString("changes");
+        b.addList() = changes;
+    }
+    else
+    {
+        b.addInt32(m_catalogue_seq);
+        b.addString("heartbeat");
+    }
+    //strict: a change must not be overwritten by the next one before being sent
+    m_locations_port.write(true);
+}
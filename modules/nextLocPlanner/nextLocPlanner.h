@@ -26,10 +26,15 @@
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/Port.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Bottle.h>
 #include <yarp/dev/INavigation2D.h>
+#include <yarp/dev/IMap2D.h>
 #include <vector>
 #include <map>
 #include <algorithm>
+#include "navStatusCache.h"
+#include "mapMetadata.h"
 
 using namespace yarp::os;
 using namespace yarp::dev;
@@ -48,15 +53,21 @@ private:
     //Devices
     PolyDriver        m_nav2DPoly;
     INavigation2D*    m_iNav2D{nullptr};
+    NavStatusCache*   m_navStatus{nullptr};
 
     //Ports
     RpcServer         m_rpc_server_port;
+    BufferedPort<Bottle> m_locations_port;  //changes of the locations, for the replicas of the other modules
 
     //Locations
     vector<string>    m_all_locations;
     vector<string>    m_locations_unchecked;
     vector<string>    m_locations_checking;
     vector<string>    m_locations_checked;
+    vector<string>    m_verify_locations;   //temporary locations, visited before the others
+    map<string, Map2DLocation> m_poses;
+    map<string, string> m_published;        //status of the locations as last published
+    int               m_catalogue_seq;
     
     mutex             m_mutex;
 
@@ -76,9 +87,17 @@ public:
     bool removeLocation(string& loc);
     bool addLocation(string& loc); //add a previously defined location 
     bool addLocation(string locName, Map2DLocation loc); //add a new location 
+    bool addVerifyLocation(string locName, Map2DLocation loc); //add a temporary location, removed once checked
 
 private:
+    bool loadLocations(ResourceFinder &rf, vector<string>& names, vector<Map2DLocation>& poses);
     double distRobotLocation(const string& location_name);
+    string locationStatus(const string& location_name);
+    void addCatalogueEntry(Bottle& entry, const string& location_name, const string& status);
+    void fillCatalogue(Bottle& b);
+    void publishChanges();
+    bool isVerifyLocation(const string& location_name);
+    void removeVerifyLocation(const string& location_name);
 
     template <typename A, typename B>
     void zip(const vector<A> &a, const vector<B> &b,  vector<pair<A,B>> &zipped)
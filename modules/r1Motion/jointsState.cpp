@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "jointsState.h"
+
+YARP_LOG_COMPONENT(JOINTS_STATE, "r1_obr.r1Motion.jointsState")
+
+
+/****************************************************************/
+JointsState::JointsState() :
+    m_max_age(0.1)
+{
+}
+
+
+/****************************************************************/
+bool JointsState::configure(PolyDriver* drivers, const vector<string>& part_names, double max_age)
+{
+    m_max_age = max_age;
+    m_parts.resize(part_names.size());
+    for (size_t i = 0; i < part_names.size(); i++)
+    {
+        Part& part = m_parts[i];
+        IPositionControl* iposctrl = nullptr;
+        part.name = part_names[i];
+        drivers[i].view(part.ictrlmode);
+        drivers[i].view(part.iencoder);
+        drivers[i].view(iposctrl);
+        if (!part.ictrlmode || !part.iencoder || !iposctrl)
+        {
+            yCError(JOINTS_STATE, "Error opening the interfaces of %s. Devices not available", part.name.c_str());
+            return false;
+        }
+
+        iposctrl->getAxes(&part.axes);
+        part.modes.resize(part.axes);
+        part.encs.resize(part.axes);
+    }
+
+    return true;
+}
+
+
+/****************************************************************/
+bool JointsState::getModes(int part, vector<int>& modes, double max_age)
+{
+    Part& p = m_parts[part];
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (p.modes_time >= 0.0 && Time::now() - p.modes_time <= (max_age < 0.0 ? m_max_age : max_age))
+        {
+            modes = p.modes;
+            return true;
+        }
+    }
+
+    //the parts can be read in parallel
+    vector<int> fresh(p.axes);
+    if (!p.ictrlmode->getControlModes(fresh.data()))
+        return false;
+
+    lock_guard<mutex> lock(m_mutex);
+    p.modes = fresh;
+    p.modes_time = Time::now();
+    modes = fresh;
+    return true;
+}
+
+
+/****************************************************************/
+bool JointsState::getEncoders(int part, vector<double>& encs, double max_age)
+{
+    Part& p = m_parts[part];
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (p.encs_time >= 0.0 && Time::now() - p.encs_time <= (max_age < 0.0 ? m_max_age : max_age))
+        {
+            encs = p.encs;
+            return true;
+        }
+    }
+
+    vector<double> fresh(p.axes);
+    if (!p.iencoder->getEncoders(fresh.data()))
+        return false;
+
+    lock_guard<mutex> lock(m_mutex);
+    p.encs = fresh;
+    p.encs_time = Time::now();
+    encs = fresh;
+    return true;
+}
+
+
+/****************************************************************/
+bool JointsState::areJointsOk()
+{
+    vector<int> modes;
+    for (size_t i = 0; i < m_parts.size(); i++)
+    {
+        if (!getModes(i, modes))
+        {
+            yCError(JOINTS_STATE) << "Error: cannot read the control modes of" << m_parts[i].name;
+            return false;
+        }
+
+        for (size_t i_joint = 0; i_joint < modes.size(); i_joint++)
+        {
+            if (modes[i_joint] == VOCAB_CM_HW_FAULT)
+            {
+                yCError(JOINTS_STATE) << "Error: hardware fault detected on" << m_parts[i].name << "joint" << (int)i_joint;
+                return false;
+            }
+            else if (modes[i_joint] == VOCAB_CM_IDLE)
+            {
+                yCError(JOINTS_STATE) << "Error: idle joint detected on" << m_parts[i].name << "joint" << (int)i_joint;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef JOINTS_STATE_H
+#define JOINTS_STATE_H
+
+#include <yarp/os/all.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include <vector>
+#include <string>
+#include <mutex>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+
+// Control modes and encoders of the parts of the robot, read with one call per part.
+// A value read less than "max_age" seconds ago is answered from memory.
+class JointsState
+{
+private:
+    struct Part
+    {
+        string              name;
+        IControlMode*       ictrlmode = nullptr;
+        IEncoders*          iencoder = nullptr;
+        int                 axes = 0;
+        vector<int>         modes;
+        vector<double>      encs;
+        double              modes_time = -1.0;
+        double              encs_time = -1.0;
+    };
+
+    vector<Part>            m_parts;
+    double                  m_max_age;
+    mutex                   m_mutex;
+
+public:
+    JointsState();
+    ~JointsState() = default;
+
+    bool configure(PolyDriver* drivers, const vector<string>& part_names, double max_age = 0.1);
+
+    int getAxes(int part) { return m_parts[part].axes; }
+    bool getModes(int part, vector<int>& modes, double max_age = -1.0);
+    bool getEncoders(int part, vector<double>& encs, double max_age = -1.0);
+
+    //false if a joint is in hardware fault or idle
+    bool areJointsOk();
+};
+
+#endif
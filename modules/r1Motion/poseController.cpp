@@ -0,0 +1,266 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "poseController.h"
+
+YARP_LOG_COMPONENT(POSE_CONTROLLER, "r1_obr.r1Motion.poseController")
+
+
+/****************************************************************/
+PoseController::PoseController() :
+    m_drivers(nullptr)
+{
+}
+
+
+/****************************************************************/
+PoseController::~PoseController()
+{
+    close();
+}
+
+
+/****************************************************************/
+bool PoseController::open(const string& robot, const string& local_prefix, const vector<string>& part_names)
+{
+    m_drivers = new PolyDriver[part_names.size()];
+    m_parts.resize(part_names.size());
+
+    for (size_t i = 0; i < part_names.size(); i++)
+    {
+        Part& part = m_parts[i];
+        part.name = part_names[i];
+
+        Property prop;
+        prop.put("device","remote_controlboard");
+        prop.put("local",local_prefix + "/" + part.name);
+        prop.put("remote","/" + robot + "/" + part.name);
+        if (!m_drivers[i].open(prop))
+        {
+            yCError(POSE_CONTROLLER,"Unable to connect to %s",("/" + robot + "/" + part.name).c_str());
+            return false;
+        }
+
+        m_drivers[i].view(part.iposctrl);
+        m_drivers[i].view(part.ictrlmode);
+        if (!part.iposctrl || !part.ictrlmode)
+        {
+            yCError(POSE_CONTROLLER,"Error opening iPositionControl or iControlMode interfaces of %s. Devices not available", part.name.c_str());
+            return false;
+        }
+
+        part.iposctrl->getAxes(&part.axes);
+        for (int j = 0; j < part.axes; j++)
+            part.joints.push_back(j);
+    }
+
+    return m_state.configure(m_drivers, part_names);
+}
+
+
+/****************************************************************/
+void PoseController::close()
+{
+    if (!m_drivers)
+        return;
+
+    for (size_t i = 0; i < m_parts.size(); i++)
+    {
+        if (m_drivers[i].isValid())
+            m_drivers[i].close();
+    }
+
+    delete[] m_drivers;
+    m_drivers = nullptr;
+}
+
+
+/****************************************************************/
+bool PoseController::addPose(const string& name, const Searchable& config)
+{
+    vector<vector<double>> targets(m_parts.size());
+    bool found = false;
+    for (size_t i = 0; i < m_parts.size(); i++)
+    {
+        string key = m_parts[i].name + "_pos";
+        if (!config.check(key))
+            continue;
+
+        //either a string or a list
+        Bottle positions;
+        const Value& value = config.find(key);
+        if (value.isList())
+            positions = *value.asList();
+        else
+            positions.fromString(value.asString());
+
+        for (int j = 0; j < m_parts[i].axes; j++)
+            targets[i].push_back(positions.get(j).asFloat32());
+        found = true;
+    }
+
+    if (!found)
+    {
+        yCError(POSE_CONTROLLER, "Pose %s does not move any part", name.c_str());
+        return false;
+    }
+
+    m_poses[name] = targets;
+    return true;
+}
+
+
+/****************************************************************/
+bool PoseController::getPose(const string& name, vector<vector<double>>& targets)
+{
+    auto it = m_poses.find(name);
+    if (it == m_poses.end())
+        return false;
+
+    targets = it->second;
+    return true;
+}
+
+
+/****************************************************************/
+bool PoseController::setControlMode(int part, int mode)
+{
+    Part& p = m_parts[part];
+    vector<int> modes(p.axes, mode);
+    if (!p.ictrlmode->setControlModes(p.axes, p.joints.data(), modes.data()))
+        return false;
+
+    Time::delay(0.01);  // give time to update control modes value
+    if (!p.ictrlmode->getControlModes(p.axes, p.joints.data(), modes.data()))
+        return false;
+    for (int i = 0; i < p.axes; i++)
+    {
+        if (modes[i] != mode)
+        {
+            yCError(POSE_CONTROLLER) << "Joint" << i << "not in the requested control mode for part:" << p.name;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/****************************************************************/
+bool PoseController::movePart(int part, const vector<double>& target, double time)
+{
+    Part& p = m_parts[part];
+    if (!setControlMode(part, VOCAB_CM_POSITION))
+        return false;
+
+    if (time > 0.0)
+    {
+        vector<double> encs;
+        if (!m_state.getEncoders(part, encs, 0.0))
+            return false;
+
+        vector<double> speeds(p.axes);
+        for (int i = 0; i < p.axes; i++)
+            speeds[i] = fabs(encs[i] - target[i]) / time;
+        if (!p.iposctrl->setRefSpeeds(p.axes, p.joints.data(), speeds.data()))
+            return false;
+    }
+
+    return p.iposctrl->positionMove(p.axes, p.joints.data(), target.data());
+}
+
+
+/****************************************************************/
+bool PoseController::moveTo(const vector<vector<double>>& targets, double time)
+{
+    for (size_t i = 0; i < m_parts.size() && i < targets.size(); i++)
+    {
+        if (!targets[i].empty() && (int)targets[i].size() != m_parts[i].axes)
+        {
+            yCError(POSE_CONTROLLER, "Wrong number of joints for %s", m_parts[i].name.c_str());
+            return false;
+        }
+    }
+
+    //the parts are commanded at the same time, each one with its own calls
+    vector<future<bool>> results(m_parts.size());
+    for (size_t i = 0; i < m_parts.size(); i++)
+    {
+        m_parts[i].moving = i < targets.size() && !targets[i].empty();
+        if (m_parts[i].moving)
+            results[i] = async(launch::async, &PoseController::movePart, this, (int)i, cref(targets[i]), time);
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < m_parts.size(); i++)
+    {
+        if (results[i].valid() && !results[i].get())
+        {
+            yCError(POSE_CONTROLLER, "Error while moving %s", m_parts[i].name.c_str());
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+
+/****************************************************************/
+bool PoseController::goToPose(const string& name, double time)
+{
+    auto it = m_poses.find(name);
+    if (it == m_poses.end())
+    {
+        yCError(POSE_CONTROLLER, "Unknown pose %s", name.c_str());
+        return false;
+    }
+
+    return moveTo(it->second, time);
+}
+
+
+/****************************************************************/
+bool PoseController::isMotionDone()
+{
+    for (auto& part : m_parts) 
+    {
+        if (!part.moving)
+            continue;
+        bool done = false;
+        if (!part.iposctrl->checkMotionDone(&done) || !done)
+            return false;
+    }
+
+    return true;
+}
+
+
+/****************************************************************/
+future<bool> PoseController::motionDone(double timeout)
+{
+    return async(launch::async, [this, timeout]() {
+        double deadline = Time::now() + timeout;
+        while (!isMotionDone())
+        {
+            if (Time::now() > deadline)
+                return false;
+            Time::delay(0.05);
+        }
+        return true;
+    });
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef POSE_CONTROLLER_H
+#define POSE_CONTROLLER_H
+
+#include <yarp/os/all.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include <vector>
+#include <string>
+#include <map>
+#include <future>
+#include <cmath>
+#include "jointsState.h"
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+
+// The parts of the robot (e.g. right_arm, left_arm, head, torso) opened through remote_controlboard,
+// and the named poses that they can take. Every command is sent with one call for all the joints
+// of a part, and the parts are commanded in parallel.
+class PoseController
+{
+private:
+    struct Part
+    {
+        string              name;
+        IPositionControl*   iposctrl = nullptr;
+        IControlMode*       ictrlmode = nullptr;
+        int                 axes = 0;
+        vector<int>         joints;
+        bool                moving = false;     //moved by the last command
+    };
+
+    PolyDriver*             m_drivers;
+    vector<Part>            m_parts;
+    JointsState             m_state;
+
+    //per part targets, empty if the part is not moved by the pose
+    map<string, vector<vector<double>>> m_poses;
+
+public:
+    PoseController();
+    ~PoseController();
+
+    //opens "/<robot>/<part>" with local port "<local_prefix>/<part>"
+    bool open(const string& robot, const string& local_prefix, const vector<string>& part_names);
+    void close();
+
+    PolyDriver* drivers() { return m_drivers; }
+    int getParts() { return (int)m_parts.size(); }
+    int getAxes(int part) { return m_parts[part].axes; }
+    JointsState& state() { return m_state; }
+    bool areJointsOk() { return m_state.areJointsOk(); }
+
+    //the positions of the pose are read from "<part>_pos" (e.g. right_arm_pos "-9.0 9.0 -10.0 50.0"),
+    //a missing joint goes to 0.0 and a missing part is not moved
+    bool addPose(const string& name, const Searchable& config);
+    bool getPose(const string& name, vector<vector<double>>& targets);
+    bool hasPose(const string& name) { return m_poses.find(name) != m_poses.end(); }
+
+    bool setControlMode(int part, int mode);
+
+    //position mode, and reference speeds such that all the joints arrive after "time" seconds (if positive)
+    bool moveTo(const vector<vector<double>>& targets, double time = -1.0);
+    bool goToPose(const string& name, double time = -1.0);
+
+    //about the parts moved by the last command
+    bool isMotionDone();
+    //to be kept until it is ready: the destructor of the future waits for the motion
+    future<bool> motionDone(double timeout);
+
+private:
+    bool movePart(int part, const vector<double>& target, double time);
+};
+
+#endif
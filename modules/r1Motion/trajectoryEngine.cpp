@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "trajectoryEngine.h"
+
+YARP_LOG_COMPONENT(TRAJECTORY_ENGINE, "r1_obr.r1Motion.trajectoryEngine")
+
+
+/****************************************************************/
+TrajectoryEngine::TrajectoryEngine() :
+    PeriodicThread(0.01),
+    m_default_time(2.0),
+    m_active(false),
+    m_completed(false),
+    m_stopping(false),
+    m_t0(0.0),
+    m_duration(0.0)
+{
+}
+
+
+/****************************************************************/
+bool TrajectoryEngine::configure(PolyDriver* drivers, int n_parts, Searchable& config)
+{
+    if (config.check("period"))       {setPeriod(config.find("period").asFloat64());}
+    if (config.check("default_time")) {m_default_time = config.find("default_time").asFloat64();}
+
+    m_parts.resize(n_parts);
+    for (int i = 0; i < n_parts; i++)
+    {
+        Part& part = m_parts[i];
+        IPositionControl* iposctrl = nullptr;
+        IControlLimits* ilimits = nullptr;
+        drivers[i].view(part.iposdir);
+        drivers[i].view(part.iencoder);
+        drivers[i].view(iposctrl);
+        drivers[i].view(ilimits);
+        if (!part.iposdir || !part.iencoder || !iposctrl)
+        {
+            yCError(TRAJECTORY_ENGINE, "Error opening IPositionDirect or IEncoders interfaces of part %d. Devices not available", i);
+            return false;
+        }
+
+        iposctrl->getAxes(&part.axes);
+        for (int j = 0; j < part.axes; j++)
+            part.joints.push_back(j);
+        part.start.resize(part.axes);
+        part.goal.resize(part.axes);
+        part.ref.resize(part.axes);
+
+        part.vel_max.assign(part.axes, 0.0);
+        for (int j = 0; ilimits && j < part.axes; j++)
+        {
+            double vmin, vmax;
+            if (ilimits->getVelLimits(j, &vmin, &vmax) && vmax > 0.0)
+                part.vel_max[j] = vmax;
+        }
+    }
+
+    return start();
+}
+
+
+/****************************************************************/
+void TrajectoryEngine::close()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+        m_active = false;
+    }
+    m_done_cv.notify_all();
+
+    if (isRunning())
+        stop();
+}
+
+
+/****************************************************************/
+bool TrajectoryEngine::moveTo(const vector<vector<double>>& targets, double time)
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_stopping)
+        return false;
+
+    for (size_t i = 0; i < m_parts.size(); i++)
+    {
+        Part& part = m_parts[i];
+        part.moving = i < targets.size() && !targets[i].empty();
+        if (!part.moving)
+            continue;
+
+        if ((int)targets[i].size() != part.axes)
+        {
+            yCError(TRAJECTORY_ENGINE, "Wrong number of joints for part %d: %d instead of %d", (int)i, (int)targets[i].size(), part.axes);
+            m_active = false;
+            return false;
+        }
+
+        //a motion following another one starts from where the previous set-points ended, without steps
+        if (part.ref_valid)
+            part.start = part.ref;
+        else if (!part.iencoder->getEncoders(part.start.data()))
+        {
+            yCError(TRAJECTORY_ENGINE, "Cannot read the encoders of part %d", (int)i);
+            m_active = false;
+            return false;
+        }
+        part.goal = targets[i];
+    }
+
+    //the peak speed of a minimum-jerk trajectory is 1.875*distance/duration
+    double duration = time > 0.0 ? time : m_default_time;
+    double min_duration = 0.0;
+    for (const Part& part : m_parts)
+    {
+        if (!part.moving)
+            continue;
+        for (int j = 0; j < part.axes; j++)
+        {
+            if (part.vel_max[j] > 0.0)
+                min_duration = max(min_duration, 1.875 * fabs(part.goal[j] - part.start[j]) / part.vel_max[j]);
+        }
+    }
+    if (min_duration > duration)
+    {
+        yCWarning(TRAJECTORY_ENGINE, "Motion of %.2f seconds too fast for the velocity limits: it lasts %.2f seconds", duration, min_duration);
+        duration = min_duration;
+    }
+
+    m_duration = duration;
+    m_t0 = Time::now();
+    m_active = true;
+    m_completed = false;
+
+    return true;
+}
+
+
+/****************************************************************/
+bool TrajectoryEngine::waitMotionDone()
+{
+    unique_lock<mutex> lock(m_mutex);
+    //the trajectory lasts m_duration: a longer wait means that the thread is not running
+    double timeout = m_duration + 1.0;
+    bool done = m_done_cv.wait_for(lock, chrono::duration<double>(timeout), [&]{ return !m_active || m_stopping; });
+    if (!done)
+    {
+        yCError(TRAJECTORY_ENGINE, "Motion not completed in %.1f seconds", timeout);
+        m_active = false;
+        return false;
+    }
+
+    return m_completed;
+}
+
+
+/****************************************************************/
+bool TrajectoryEngine::isMotionDone()
+{
+    lock_guard<mutex> lock(m_mutex);
+    return !m_active;
+}
+
+
+/****************************************************************/
+void TrajectoryEngine::halt()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_active = false;
+    }
+    m_done_cv.notify_all();
+}
+
+
+/****************************************************************/
+void TrajectoryEngine::release(int part)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_parts[part].ref_valid = false;
+}
+
+
+/****************************************************************/
+double TrajectoryEngine::minJerk(double s)
+{
+    //zero velocity and acceleration at both ends
+    return s * s * s * (10.0 + s * (-15.0 + 6.0 * s));
+}
+
+
+/****************************************************************/
+void TrajectoryEngine::run()
+{
+    bool finished = false;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (!m_active)
+            return;
+
+        double s = (Time::now() - m_t0) / m_duration;
+        if (s >= 1.0)
+        {
+            s = 1.0;
+            finished = true;
+        }
+        double k = minJerk(s);
+
+        //all the parts are streamed with the same phase, so they end together
+        for (auto& part : m_parts)
+        {
+            if (!part.moving)
+                continue;
+            for (int j = 0; j < part.axes; j++)
+                part.ref[j] = part.start[j] + (part.goal[j] - part.start[j]) * k;
+            part.ref_valid = true;
+            part.iposdir->setPositions(part.axes, part.joints.data(), part.ref.data());
+        }
+
+        if (finished)
+        {
+            m_active = false;
+            m_completed = true;
+        }
+    }
+
+    if (finished)
+        m_done_cv.notify_all();
+}
+
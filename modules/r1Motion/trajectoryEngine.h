@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef TRAJECTORY_ENGINE_H
+#define TRAJECTORY_ENGINE_H
+
+#include <yarp/os/all.h>
+#include <yarp/dev/PolyDriver.h>
+#include <yarp/dev/ControlBoardInterfaces.h>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+
+// Moves several parts of the robot along minimum-jerk trajectories that start and end together.
+// The set-points are streamed to the parts in position direct mode by a single periodic thread:
+// the parts must be in VOCAB_CM_POSITION_DIRECT while they are moved.
+class TrajectoryEngine : public PeriodicThread
+{
+private:
+    struct Part
+    {
+        IPositionDirect*    iposdir = nullptr;
+        IEncoders*          iencoder = nullptr;
+        int                 axes = 0;
+        vector<int>         joints;
+        vector<double>      vel_max;                //velocity limits of the joints, 0 if not available
+        bool                moving = false;
+        bool                ref_valid = false;      //ref holds the last set-point sent
+        vector<double>      start;
+        vector<double>      goal;
+        vector<double>      ref;
+    };
+
+    vector<Part>            m_parts;
+    double                  m_default_time;
+
+    mutex                   m_mutex;
+    condition_variable      m_done_cv;
+    bool                    m_active;
+    bool                    m_completed;            //the last motion has reached its goal
+    bool                    m_stopping;             //set by close(), wakes up waitMotionDone
+    double                  m_t0;
+    double                  m_duration;
+
+public:
+    TrajectoryEngine();
+    ~TrajectoryEngine() = default;
+
+    //views the interfaces of the given parts, and starts the thread. Parameters: period, default_time
+    bool configure(PolyDriver* drivers, int n_parts, Searchable& config);
+    void close();
+
+    //starts a motion of duration "time" (default_time if negative); parts with no target stay still.
+    //The duration is extended if needed to keep the peak speed of every joint within its velocity limit
+    bool moveTo(const vector<vector<double>>& targets, double time);
+    bool waitMotionDone();
+    bool isMotionDone();
+    void halt();
+
+    //the next motion of the part starts from the encoders (e.g. after a change of control mode)
+    void release(int part);
+
+    int getAxes(int part) { return m_parts[part].axes; }
+
+    virtual void run() override;
+
+private:
+    static double minJerk(double s);
+};
+
+#endif
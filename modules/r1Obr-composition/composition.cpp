@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "composition.h"
+
+
+YARP_LOG_COMPONENT(R1OBR_COMPOSITION, "r1_obr.composition")
+
+
+/****************************************************************/
+void HostedModule::run()
+{
+    while (!isStopping())
+    {
+        double start = Time::now();
+        if (!m_module->updateModule())
+        {
+            yCInfo(R1OBR_COMPOSITION, "%s: updateModule returned false", m_name.c_str());
+            break;
+        }
+        double left = m_module->getPeriod() - (Time::now() - start);
+        if (left > 0)
+            Time::delay(left);
+    }
+}
+
+
+/****************************************************************/
+void HostedModule::onStop()
+{
+    m_module->interruptModule();
+}
+
+
+/****************************************************************/
+void HostedModule::threadRelease()
+{
+    m_module->close();
+    yCInfo(R1OBR_COMPOSITION, "%s closed", m_name.c_str());
+}
+
+
+/****************************************************************/
+Composition::Composition() :
+    m_period(1.0),
+    m_carrier("local")
+{
+}
+
+
+/****************************************************************/
+bool Composition::configure(ResourceFinder &rf)
+{
+    if(rf.check("period")) {m_period = rf.find("period").asFloat32();}
+    if(rf.check("carrier")) {m_carrier = rf.find("carrier").asString();}
+
+    Bottle* modules = rf.find("modules").asList();
+    if (modules == nullptr || modules->size() == 0)
+    {
+        yCError(R1OBR_COMPOSITION, "No module to host. Please specify them in the 'modules' list");
+        return false;
+    }
+
+    //the modules are configured one after the other, in the order of the list
+    for (int i=0; i<modules->size(); i++)
+    {
+        if (!startModule(modules->get(i).asString(), rf))
+        {
+            close();
+            return false;
+        }
+    }
+
+    return connectPorts(rf);
+}
+
+
+/****************************************************************/
+bool Composition::startModule(const string& name, ResourceFinder &rf)
+{
+    Hosted* h = new Hosted;
+    h->module = createHostedModule(name, h->info);
+    if (h->module == nullptr)
+    {
+        yCError(R1OBR_COMPOSITION, "Unknown module %s", name.c_str());
+        delete h;
+        return false;
+    }
+
+    //[<name>] group: context and configuration file, as --context and --from of the standalone executable
+    string context = h->info.default_context;
+    string from = h->info.default_config_file;
+    Bottle& group = rf.findGroup(name);
+    if (!group.isNull())
+    {
+        if (group.check("context")) {context = group.find("context").asString();}
+        if (group.check("from")) {from = group.find("from").asString();}
+    }
+
+    h->rf.setVerbose(true);
+    h->rf.setDefaultContext(context);
+    if (from != "")
+        h->rf.setDefaultConfigFile(from);
+    char arg0[] = "r1Obr-composition";
+    char* argv[] = {arg0};
+    h->rf.configure(1, argv);
+
+    yCInfo(R1OBR_COMPOSITION, "Configuring %s (context %s, file %s)", name.c_str(), context.c_str(), from.c_str());
+    if (!h->module->configure(h->rf))
+    {
+        yCError(R1OBR_COMPOSITION, "Configuration of %s failed", name.c_str());
+        delete h->module;
+        delete h;
+        return false;
+    }
+
+    h->thread = new HostedModule(h->module, name);
+    if (!h->thread->start())
+    {
+        yCError(R1OBR_COMPOSITION, "Cannot start the thread of %s", name.c_str());
+        h->module->close();
+        delete h->thread;
+        delete h->module;
+        delete h;
+        return false;
+    }
+
+    m_hosted.push_back(h);
+    return true;
+}
+
+
+/****************************************************************/
+bool Composition::connectPorts(ResourceFinder &rf)
+{
+    //[CONNECTIONS] group: one line per connection, "<label> <from> <to> [carrier]"
+    Bottle& connections = rf.findGroup("CONNECTIONS");
+    for (int i=1; i<connections.size(); i++)
+    {
+        Bottle* line = connections.get(i).asList();
+        if (line == nullptr || line->size() < 3)
+            continue;
+
+        string from = line->get(1).asString();
+        string to = line->get(2).asString();
+        string carrier = line->size() > 3 ? line->get(3).asString() : m_carrier;
+
+        //with the "local" carrier the data is handed over to the reader without being serialized
+        if (Network::connect(from, to, carrier))
+            yCInfo(R1OBR_COMPOSITION) << "Connected" << from << "to" << to << "with" << carrier;
+        else if (Network::connect(from, to))
+            yCWarning(R1OBR_COMPOSITION) << "Cannot connect" << from << "to" << to << "with" << carrier << ". Connected with the default carrier";
+        else
+            yCError(R1OBR_COMPOSITION) << "Cannot connect" << from << "to" << to;
+    }
+
+    return true;
+}
+
+
+/****************************************************************/
+bool Composition::close()
+{
+    //closed in reverse order
+    for (auto it = m_hosted.rbegin(); it != m_hosted.rend(); it++)
+    {
+        Hosted* h = *it;
+        yCInfo(R1OBR_COMPOSITION, "Stopping %s", h->info.name.c_str());
+        h->thread->stop();
+        delete h->thread;
+        delete h->module;
+        delete h;
+    }
+    m_hosted.clear();
+
+    return true;
+}
+
+
+/****************************************************************/
+double Composition::getPeriod()
+{
+    return m_period;
+}
+
+
+/****************************************************************/
+bool Composition::updateModule()
+{
+    for (auto h : m_hosted)
+    {
+        if (!h->thread->isRunning())
+        {
+            yCWarning(R1OBR_COMPOSITION, "%s has stopped. Closing all the modules", h->info.name.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef R1OBR_COMPOSITION_H
+#define R1OBR_COMPOSITION_H
+
+#include <yarp/os/all.h>
+#include <vector>
+#include <string>
+#include "hostedModules.h"
+
+using namespace yarp::os;
+using namespace std;
+
+// Runs the loop of a hosted module (updateModule every getPeriod seconds) and closes it when stopped.
+// The signals and the terminal are handled by the composition only.
+class HostedModule : public Thread
+{
+private:
+    RFModule*       m_module;
+    string          m_name;
+
+public:
+    HostedModule(RFModule* module, const string& name) : m_module(module), m_name(name) {}
+    ~HostedModule() = default;
+
+    virtual void run() override;
+    virtual void onStop() override;
+    virtual void threadRelease() override;
+};
+
+
+class Composition : public RFModule
+{
+private:
+    struct Hosted
+    {
+        HostedModuleInfo    info;
+        ResourceFinder      rf;         //the module keeps a reference to it
+        RFModule*           module{nullptr};
+        HostedModule*       thread{nullptr};
+    };
+
+    double                      m_period;
+    string                      m_carrier;
+    vector<Hosted*>             m_hosted;
+
+public:
+    Composition();
+    ~Composition() = default;
+
+    virtual bool configure(ResourceFinder &rf);
+    virtual bool close();
+    virtual double getPeriod();
+    virtual bool updateModule();
+
+private:
+    bool startModule(const string& name, ResourceFinder &rf);
+    bool connectPorts(ResourceFinder &rf);
+};
+
+#endif
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "hostedModules.h"
+
+#include "r1Obr-orchestrator.h"
+#include "goAndFindIt.h"
+#include "nextLocPlanner.h"
+#include "lookForObject.h"
+#include "approachObject.h"
+#include "lookAndPoint.h"
+
+
+/****************************************************************/
+yarp::os::RFModule* createHostedModule(const std::string& name, HostedModuleInfo& info)
+{
+    //same defaults of the main() of the standalone executables
+    info.name = name;
+    if (name == "r1Obr-orchestrator")
+    {
+        info.default_context = "r1Obr-orchestrator";
+        info.default_config_file = "r1Obr-orchestrator_R1.ini";
+        return new Orchestrator();
+    }
+    else if (name == "goAndFindIt")
+    {
+        info.default_context = "goAndFindIt";
+        info.default_config_file = "goAndFindIt_R1.ini";
+        return new GoAndFindIt();
+    }
+    else if (name == "nextLocPlanner")
+    {
+        info.default_context = "nextLocPlanner";
+        info.default_config_file = "nextLocPlanner_R1.ini";
+        return new NextLocPlanner();
+    }
+    else if (name == "lookForObject")
+    {
+        info.default_context = "lookForObject";
+        info.default_config_file = "lookForObject_R1_SIM.ini";
+        return new LookForObject();
+    }
+    else if (name == "approachObject")
+    {
+        info.default_context = "approachObject";
+        info.default_config_file = "approachObject_R1_SIM.ini";
+        return new ApproachObject();
+    }
+    else if (name == "look_and_point")
+    {
+        info.default_context = "look_and_point";
+        info.default_config_file = "";
+        return new LookAndPoint();
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef HOSTED_MODULES_H
+#define HOSTED_MODULES_H
+
+#include <yarp/os/RFModule.h>
+#include <string>
+
+struct HostedModuleInfo
+{
+    std::string     name;               //as in the "modules" list of the .ini file
+    std::string     default_context;
+    std::string     default_config_file;
+};
+
+//creates the module called "name". nullptr if it is not one of the modules that can be hosted
+yarp::os::RFModule* createHostedModule(const std::string& name, HostedModuleInfo& info);
+
+#endif
@@ -70,6 +70,7 @@ bool ChatBot::configure(ResourceFinder &rf)
 
     // iChatBot
     m_chatBot_active = config.check("chatbot_active") ? !(config.find("chatbot_active").asString() == "false") : true;
+    m_prewarm = config.check("prewarm_replies") ? (config.find("prewarm_replies").asString() == "true") : false;
 
     if(m_chatBot_active)
     {
@@ -118,6 +119,19 @@ bool ChatBot::configure(ResourceFinder &rf)
         return false;
     }
 
+    m_speech_queue = new SpeechQueue(m_speaker, m_audiorecorderRPCPort, m_audioPlayPort);
+    if(!m_speech_queue->configure(rf))
+    {
+        yCError(CHAT_BOT_ORCHESTRATOR,"SpeechQueue configuration failed");
+        return false;
+    }
+
+    if(!start())
+    {
+        yCError(CHAT_BOT_ORCHESTRATOR,"Cannot start the Chat Bot worker");
+        return false;
+    }
+
     return true;
 }
 
@@ -125,6 +139,16 @@ bool ChatBot::configure(ResourceFinder &rf)
 // ****************************************************** //
 void ChatBot::close()
 {    
+    if(isRunning())
+        stop();
+
+    if(m_speech_queue)
+    {
+        m_speech_queue->close();
+        delete m_speech_queue;
+        m_speech_queue = nullptr;
+    }
+
     if(!m_voiceCommandPort.isClosed())
         m_voiceCommandPort.close();
 
@@ -159,7 +183,7 @@ void ChatBot::onRead(Bottle& b)
     if(str == "")
         return;
 
-    interactWithChatBot(str);
+    interactAsync(str);
     
 }
 
@@ -169,6 +193,7 @@ void ChatBot::interactWithChatBot(const string& msgIn)
 {
     if(m_chatBot_active)
     {
+        lock_guard<mutex> lock(m_bot_mutex);
         yCInfo(CHAT_BOT_ORCHESTRATOR,"ChatBot received: %s",msgIn.c_str());
         
         string msgOut;
@@ -192,32 +217,10 @@ void ChatBot::interactWithChatBot(const string& msgIn)
             else if(cmd->get(0).asString()=="say")
             {
                 string toSay = cmd->tail().toString();
-                yCInfo(CHAT_BOT_ORCHESTRATOR, "Saying: %s", toSay.c_str());
-
-                //close microphone
-                Bottle req{"stopRecording_RPC"}, rep;
-                m_audiorecorderRPCPort.write(req,rep);
-
-                //speak
-                m_speaker->say(toSay);
-
-                //wait until finish speaking
-                Time::delay(0.5);
-                bool audio_is_playing{true};
-                while (audio_is_playing) 
-                {
-                    Bottle* player_status = m_audioPlayPort.read(false);
-                    if (player_status)
-                    {
-                        audio_is_playing = (unsigned int)player_status->get(1).asInt64() > 0;
-                    }
-                    Time::delay(0.1);                    
-                }
-
-                //re-open microphone
-                req.clear(); rep.clear();
-                req.addString("startRecording_RPC");
-                m_audiorecorderRPCPort.write(req,rep);
+                yCInfo(CHAT_BOT_ORCHESTRATOR, "Queueing: %s", toSay.c_str());
+
+                //the speech queue closes the microphone while speaking
+                m_speech_queue->say(toSay);
             }
             else if(cmd->get(0).asString()=="setLanguage")
             {
@@ -239,3 +242,79 @@ void ChatBot::interactWithChatBot(const string& msgIn)
         yCWarning(CHAT_BOT_ORCHESTRATOR, "Chat Bot not active. Use RPC port to write commands");
     
 }
+
+
+// ****************************************************** //
+void ChatBot::prewarm(const vector<string>& msgs)
+{
+    if(!m_chatBot_active || !m_prewarm)
+        return;
+
+    lock_guard<mutex> lock(m_bot_mutex);
+
+    for (const auto& msgIn : msgs)
+    {
+        string msgOut;
+        m_iChatBot->interact(msgIn, msgOut);
+        Bottle msg_btl; msg_btl.fromString(msgOut);
+        for (int i=0; i<(int)msg_btl.size(); i++)
+        {
+            //only the sentences are taken, the other commands are ignored
+            Bottle* cmd=msg_btl.get(i).asList();
+            if(cmd && cmd->get(0).asString()=="say")
+            {
+                Sound sound;
+                m_speaker->synthesize(cmd->tail().toString(), sound);
+            }
+        }
+    }
+
+    //the dialog starts from the beginning, as if nothing had been asked
+    m_iChatBot->resetBot();
+    string msgIn,msgOut;
+    m_iChatBot->interact(msgIn = "skip_language_set", msgOut);
+    m_iChatBot->setLanguage(m_language_chatbot);
+
+    yCInfo(CHAT_BOT_ORCHESTRATOR, "Replies to %d messages synthesized in advance", (int)msgs.size());
+}
+
+
+// ****************************************************** //
+void ChatBot::interactAsync(const string& msgIn)
+{
+    {
+        lock_guard<mutex> lock(m_msgs_mutex);
+        m_msgs.push_back(msgIn);
+    }
+    m_msgs_cv.notify_one();
+}
+
+
+// ****************************************************** //
+void ChatBot::run()
+{
+    while(!isStopping())
+    {
+        string msgIn;
+        {
+            unique_lock<mutex> lock(m_msgs_mutex);
+            m_msgs_cv.wait(lock, [&]{ return isStopping() || !m_msgs.empty(); });
+            if(isStopping())
+                return;
+            msgIn = m_msgs.front();
+            m_msgs.pop_front();
+        }
+
+        interactWithChatBot(msgIn);
+    }
+}
+
+
+// ****************************************************** //
+void ChatBot::onStop()
+{
+    {
+        lock_guard<mutex> lock(m_msgs_mutex);
+    }
+    m_msgs_cv.notify_all();
+}
@@ -22,13 +22,18 @@
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/IChatBot.h>
 #include "speechSynthesizer.h"
+#include "speechQueue.h"
 #include <yarp/dev/AudioPlayerStatus.h>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
 
 using namespace yarp::os;
 using namespace yarp::dev;
 using namespace std;
 
-class ChatBot : public TypedReaderCallback<Bottle>
+class ChatBot : public TypedReaderCallback<Bottle>, public Thread
 {
 
 private:
@@ -43,8 +48,16 @@ private:
     IChatBot*               m_iChatBot = nullptr;
 
     SpeechSynthesizer*      m_speaker;
+    SpeechQueue*            m_speech_queue = nullptr;
 
     string                  m_language_chatbot;
+    bool                    m_prewarm;
+
+    //messages waiting for the worker, so that nobody waits for the Chat Bot
+    mutex                   m_bot_mutex;
+    mutex                   m_msgs_mutex;
+    condition_variable      m_msgs_cv;
+    deque<string>           m_msgs;
 
 public:
     
@@ -59,6 +72,14 @@ public:
     virtual void onRead(Bottle& b) override;
     
     void interactWithChatBot(const string& msgIn);
+    void interactAsync(const string& msgIn);
+
+    //Thread
+    void run() override;
+    void onStop() override;
+
+    //the replies of the Chat Bot to the given messages are synthesized in advance
+    void prewarm(const vector<string>& msgs);
 
 };
 
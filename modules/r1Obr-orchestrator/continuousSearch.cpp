@@ -20,7 +20,17 @@
 
 YARP_LOG_COMPONENT(CONTINUOUS_SEARCH, "r1_obr.orchestrator.continousSearch")
 
-ContinuousSearch::ContinuousSearch() 
+ContinuousSearch::ContinuousSearch() :
+    m_next_id(0),
+    m_fired_id(-1),
+    m_frames(0),
+    m_confirm_hits(3),
+    m_confirm_window(5),
+    m_pixel_gate(80.0),
+    m_world_gate(0.5),
+    m_reject_radius(0.7),
+    m_confirm_timeout(1.0),
+    m_strong_confidence(0.0)
 {
     m_object_finder_result_port_name= "/r1Obr-orchestrator/continousSearch/object_finder_result:i";
 }
@@ -36,7 +46,19 @@ bool ContinuousSearch::configure(ResourceFinder& rf)
     Searchable& cs_config = rf.findGroup("CONTINUOUS_SEARCH");
     if(cs_config.check("object_finder_result_port")) {m_object_finder_result_port_name = cs_config.find("object_finder_result_port").asString();}
     m_active = cs_config.check("active")  ? !(cs_config.find("active").asString() == "false") : true;
+    if(cs_config.check("confirm_hits"))     {m_confirm_hits = cs_config.find("confirm_hits").asInt32();}
+    if(cs_config.check("confirm_window"))   {m_confirm_window = cs_config.find("confirm_window").asInt32();}
+    if(cs_config.check("pixel_gate"))       {m_pixel_gate = cs_config.find("pixel_gate").asFloat64();}
+    if(cs_config.check("world_gate"))       {m_world_gate = cs_config.find("world_gate").asFloat64();}
+    if(cs_config.check("reject_radius"))    {m_reject_radius = cs_config.find("reject_radius").asFloat64();}
+    if(cs_config.check("confirm_timeout"))  {m_confirm_timeout = cs_config.find("confirm_timeout").asFloat64();}
+    if(cs_config.check("strong_confidence")){m_strong_confidence = cs_config.find("strong_confidence").asFloat64();}
 
+    //the hits of the last M frames are the bits of an unsigned int
+    m_confirm_window = max(1, min(m_confirm_window, 32));
+    m_confirm_hits = max(1, min(m_confirm_hits, m_confirm_window));
+
+    m_object_finder_result_port.useCallback(*this);
     if(!m_object_finder_result_port.open(m_object_finder_result_port_name))
     {
         yCError(CONTINUOUS_SEARCH) << "Cannot open port" << m_object_finder_result_port_name; 
@@ -61,46 +83,292 @@ void ContinuousSearch::close()
 }
 
 
+/****************************************************************/
+void ContinuousSearch::onRead(Bottle& b)
+{
+    Stamp stamp;
+    m_object_finder_result_port.getEnvelope(stamp);
+
+    if (m_memory)
+        m_memory->record(b, stamp.isValid() ? stamp.getTime() : Time::now());
+
+    lock_guard<mutex> lock(m_mutex);
+    m_last_frame = b;
+    m_last_stamp = stamp;
+    m_frames++;
+    updateTracks(b);
+}
+
+
+/****************************************************************/
+void ContinuousSearch::updateTracks(const Bottle& frame)
+{
+    unsigned int window = m_confirm_window == 32 ? 0xFFFFFFFF : (1u << m_confirm_window) - 1;
+    for (auto& track : m_tracks)
+        track.hits = (track.hits << 1) & window;
+
+    vector<bool> updated(m_tracks.size(), false);
+    for (size_t i=0; i<frame.size(); i++)
+    {
+        Bottle* det = frame.get(i).asList();
+        if (!det)   //"nothing"
+            continue;
+
+        string label = det->get(0).asString();
+        double conf = det->get(1).asFloat64();
+        double u = det->get(2).asFloat64();
+        double v = det->get(3).asFloat64();
+        Bottle* world = det->get(4).asList();   //present if the detections come from detectionLifter
+        bool has_world = world && world->size() == 3;
+        double x = has_world ? world->get(0).asFloat64() : 0.0;
+        double y = has_world ? world->get(1).asFloat64() : 0.0;
+        double z = has_world ? world->get(2).asFloat64() : 0.0;
+
+        //the closest track of the same label not yet updated in this frame
+        int best = -1;
+        double best_dist = 0.0;
+        for (size_t t=0; t<m_tracks.size(); t++)
+        {
+            const Track& track = m_tracks[t];
+            if (updated[t] || track.label != label)
+                continue;
+
+            double dist;
+            if (has_world && track.has_world)
+            {
+                dist = sqrt(pow(track.x - x, 2) + pow(track.y - y, 2) + pow(track.z - z, 2));
+                if (dist > m_world_gate)
+                    continue;
+                dist /= m_world_gate;
+            }
+            else
+            {
+                dist = sqrt(pow(track.u - u, 2) + pow(track.v - v, 2));
+                if (dist > m_pixel_gate)
+                    continue;
+                dist /= m_pixel_gate;
+            }
+
+            if (best < 0 || dist < best_dist)
+            {
+                best = (int)t;
+                best_dist = dist;
+            }
+        }
+
+        if (best < 0)
+        {
+            Track track;
+            track.id = m_next_id++;
+            track.label = label;
+            track.hits = 0;
+            track.conf_sum = 0.0;
+            track.detections = 0;
+            track.rejected = has_world && isNear(m_rejected, label, x, y, z);
+            track.verifying = has_world && isNear(m_verifying, label, x, y, z);
+            m_tracks.push_back(track);
+            updated.push_back(false);
+            best = (int)m_tracks.size() - 1;
+        }
+
+        Track& track = m_tracks[best];
+        track.u = u;
+        track.v = v;
+        track.has_world = has_world;
+        track.x = x;
+        track.y = y;
+        track.z = z;
+        track.hits |= 1;
+        track.conf_sum += conf;
+        track.detections++;
+        updated[best] = true;
+    }
+
+    //the tracks not seen in the last M frames are removed
+    for (size_t t=m_tracks.size(); t-- > 0;)
+    {
+        if (m_tracks[t].hits == 0)
+            m_tracks.erase(m_tracks.begin() + t);
+    }
+}
+
+
+/****************************************************************/
+bool ContinuousSearch::isConfirmed(const Track& track)
+{
+    int n = 0;
+    for (unsigned int h = track.hits; h; h >>= 1)
+        n += h & 1;
+
+    return !track.rejected && n >= m_confirm_hits;
+}
+
+
+/****************************************************************/
+bool ContinuousSearch::isNear(const vector<Position>& positions, const string& label, double x, double y, double z)
+{
+    for (const auto& r : positions)
+    {
+        if (r.label == label && sqrt(pow(r.x - x, 2) + pow(r.y - y, 2) + pow(r.z - z, 2)) < m_reject_radius)
+            return true;
+    }
+
+    return false;
+}
+
+
 /****************************************************************/
 bool ContinuousSearch::seeObject(string& obj)
+{
+    string seen;
+    return seeObject(vector<string>{obj}, seen);
+}
+
+
+/****************************************************************/
+bool ContinuousSearch::seeObject(const vector<string>& objs, string& seen)
+{
+    Sighting sighting;
+    if (!seeObject(objs, sighting))
+        return false;
+
+    seen = sighting.label;
+    return true;
+}
+
+
+/****************************************************************/
+bool ContinuousSearch::seeObject(const vector<string>& objs, Sighting& sighting)
 {
     if (!m_active)
         return false;
     
-    Bottle* finderResult = m_object_finder_result_port.read(false); 
-    if(finderResult != nullptr)
+    //all the objects are checked against the same tracks, the strong sightings first
+    lock_guard<mutex> lock(m_mutex);
+    const Track* seen = nullptr;
+    bool strong = false;
+    for (const auto& track : m_tracks)
     {
-        if(finderResult->check(obj))   
-            return true;
+        if (!isConfirmed(track) || find(objs.begin(), objs.end(), track.label) == objs.end())
+            continue;
+
+        bool track_strong = track.conf_sum >= m_strong_confidence * track.detections;
+        if (!track_strong && track.verifying)
+            continue;
+
+        if (!seen || (track_strong && !strong))
+        {
+            seen = &track;
+            strong = track_strong;
+        }
     }
 
-    return false;
+    if (!seen)
+        return false;
+
+    sighting.label = seen->label;
+    sighting.strong = strong;
+    sighting.has_world = seen->has_world;
+    sighting.x = seen->x;
+    sighting.y = seen->y;
+    sighting.z = seen->z;
+    m_fired_id = seen->id;
+    return true;
 }
 
 
 /****************************************************************/
-bool ContinuousSearch::whereObject(string& obj, Bottle& coords) 
+bool ContinuousSearch::whereObject(string& obj, Bottle& coords, Stamp& stamp) 
 {
     if (!m_active)
         return false;
     
-    // we repeat the same as seeObject for two reasons:
+    // we check again on a new frame for two reasons:
     // - to be sure that the robot has really seen the object while navigating
     // - the first time the robot hasn't stopped the navigation
-    
-    Bottle* finderResult = m_object_finder_result_port.read(false); 
-    if(finderResult != nullptr)
+    int frames;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        frames = m_frames;
+    }
+
+    double deadline = Time::now() + m_confirm_timeout;
+    while (Time::now() < deadline)
     {
-        if (getObjCoordinates(finderResult, obj, coords))
         {
-            return true;
+            lock_guard<mutex> lock(m_mutex);
+            if (m_frames != frames)
+            {
+                if (getObjCoordinates(&m_last_frame, obj, coords))
+                {
+                    stamp = m_last_stamp;
+                    return true;
+                }
+                break;
+            }
         }
+        Time::delay(0.02);
     }
 
     yCWarning(CONTINUOUS_SEARCH, "The Object Finder is not seeing any %s", obj.c_str());
     return false;
 }
 
+
+/****************************************************************/
+void ContinuousSearch::reject()
+{
+    lock_guard<mutex> lock(m_mutex);
+    for (auto& track : m_tracks)
+    {
+        if (track.id != m_fired_id)
+            continue;
+
+        track.rejected = true;
+        //the detections at the same place will not be considered for the rest of the search
+        if (track.has_world)
+        {
+            m_rejected.push_back({track.label, track.x, track.y, track.z});
+            if (m_memory)
+                m_memory->forget(track.label, track.x, track.y, track.z, m_reject_radius);
+        }
+        yCInfo(CONTINUOUS_SEARCH, "Sighting of %s (track %d) rejected", track.label.c_str(), track.id);
+    }
+    m_fired_id = -1;
+}
+
+
+/****************************************************************/
+void ContinuousSearch::verifying()
+{
+    lock_guard<mutex> lock(m_mutex);
+    for (auto& track : m_tracks)
+    {
+        if (track.id != m_fired_id)
+            continue;
+
+        track.verifying = true;
+        if (track.has_world)
+            m_verifying.push_back({track.label, track.x, track.y, track.z});
+    }
+    m_fired_id = -1;
+}
+
+
+/****************************************************************/
+void ContinuousSearch::newSearch()
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_rejected.clear();
+    m_verifying.clear();
+    for (auto& track : m_tracks)
+    {
+        track.rejected = false;
+        track.verifying = false;
+    }
+}
+
+
 /****************************************************************/
 bool ContinuousSearch::getObjCoordinates(Bottle* inputBtl, string& object, Bottle& outputBtl)
 {
@@ -109,7 +377,7 @@ bool ContinuousSearch::getObjCoordinates(Bottle* inputBtl, string& object, Bottl
     for (int i=0; i<inputBtl->size(); i++)
     {
         Bottle* b = inputBtl->get(i).asList();
-        if (b->get(0).asString() != object) //skip objects with another label
+        if (!b || b->get(0).asString() != object) //skip "nothing" and objects with another label
             continue;
         
         if(b->get(1).asFloat32() > max_conf) //get the object with the max confidence
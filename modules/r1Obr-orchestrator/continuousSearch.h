@@ -20,18 +20,80 @@
 
 #include <yarp/os/all.h>
 #include <vector>
+#include <algorithm>
+#include <mutex>
+#include <cmath>
+#include "objectMemory.h"
 
 using namespace yarp::os;
 using namespace std;
 
-class ContinuousSearch 
+// Detections received while navigating. Every frame of the Object Finder updates a set of tracks
+// (same label, close in the world frame or, if the position is not known, in the image): an object
+// is considered seen when its track has been detected in at least N of the last M frames.
+// A sighting that turns out to be false is rejected, together with its world position for the rest of the search.
+// A sighting is strong if the mean confidence of its track is at least strong_confidence, weak otherwise.
+class ContinuousSearch : public TypedReaderCallback<Bottle>
 {
+public:
+    struct Sighting
+    {
+        string              label;
+        bool                strong;
+        bool                has_world;
+        double              x, y, z;            //world coordinates, if has_world
+    };
+
 private:
+    struct Track
+    {
+        int                 id;
+        string              label;
+        double              u, v;               //pixel coordinates
+        bool                has_world;
+        double              x, y, z;            //world coordinates, from detectionLifter
+        unsigned int        hits;               //one bit per frame, the last frame is the least significant
+        double              conf_sum;
+        int                 detections;
+        bool                rejected;
+        bool                verifying;          //a verification waypoint has been planned: only a strong sighting is reported
+    };
+
+    struct Position
+    {
+        string              label;
+        double              x, y, z;
+    };
+
     bool                    m_active;
 
     string                  m_object_finder_result_port_name;
     BufferedPort<Bottle>    m_object_finder_result_port;
-    
+
+    mutex                   m_mutex;
+    vector<Track>           m_tracks;
+    vector<Position>        m_rejected;
+    vector<Position>        m_verifying;
+    int                     m_next_id;
+    int                     m_fired_id;         //track of the last sighting
+    Bottle                  m_last_frame;
+    Stamp                   m_last_stamp;
+    int                     m_frames;
+
+    int                     m_confirm_hits;     //N
+    int                     m_confirm_window;   //M
+    double                  m_pixel_gate;
+    double                  m_world_gate;
+    double                  m_reject_radius;
+    double                  m_confirm_timeout;
+    double                  m_strong_confidence;
+
+    //every detection is recorded, whatever the object being searched
+    ObjectMemory*           m_memory{nullptr};
+
+    void updateTracks(const Bottle& frame);
+    bool isConfirmed(const Track& track);
+    bool isNear(const vector<Position>& positions, const string& label, double x, double y, double z);
     
 public:
     
@@ -40,9 +102,24 @@ public:
 
     bool configure(ResourceFinder& rf);
     void close();
+    void setMemory(ObjectMemory* memory) { m_memory = memory; }
+
+    //Port inherited from TypedReaderCallback
+    using TypedReaderCallback<Bottle>::onRead;
+    void onRead(Bottle& b) override;
+
     bool seeObject(string& obj);
+    bool seeObject(const vector<string>& objs, string& seen);
+    bool seeObject(const vector<string>& objs, Sighting& sighting);
     bool getObjCoordinates(Bottle* inputBtl, string& object, Bottle& out);
-    bool whereObject(string& obj, Bottle& coords) ;
+    bool whereObject(string& obj, Bottle& coords, Stamp& stamp) ;
+
+    //the last sighting was false: it is not reported again
+    void reject();
+    //the last sighting is going to be checked from a verification waypoint: only a strong sighting of it is reported
+    void verifying();
+    //a new search starts: the rejected sightings are forgotten
+    void newSearch();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,193 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "goAndFindItMirror.h"
+
+
+YARP_LOG_COMPONENT(GO_AND_FIND_IT_MIRROR, "r1_obr.orchestrator.goAndFindItMirror")
+
+
+/****************************************************************/
+GoAndFindItMirror::GoAndFindItMirror(RpcClient& rpc) :
+    m_rpc(rpc),
+    m_seq(0),
+    m_cmd_count(0),
+    m_cmd_expected(0),
+    m_cmd_sent_time(0.0),
+    m_status(""),
+    m_what(""),
+    m_where(""),
+    m_last_update(-1.0),
+    m_stale_time(3.0),
+    m_cmd_wait_time(0.5)
+{
+}
+
+
+/****************************************************************/
+bool GoAndFindItMirror::configure(ResourceFinder& rf)
+{
+    string local = "/r1Obr-orchestrator/goAndFindIt/status:i";
+    if (rf.check("goandfindit_status_port"))        {local = rf.find("goandfindit_status_port").asString();}
+    if (rf.check("goandfindit_status_stale_time"))  {m_stale_time = rf.find("goandfindit_status_stale_time").asFloat32();}
+
+    if(!m_port.open(local))
+    {
+        yCError(GO_AND_FIND_IT_MIRROR) << "Cannot open port" << local;
+        return false;
+    }
+    m_port.useCallback(*this);
+
+    return true;
+}
+
+
+/****************************************************************/
+void GoAndFindItMirror::close()
+{
+    if(!m_port.isClosed())
+    {
+        m_port.interrupt();
+        m_port.close();
+    }
+}
+
+
+/****************************************************************/
+void GoAndFindItMirror::onRead(Bottle& b)
+{
+    //<seq> <commands handled> <status> <what> <where>
+    if (b.size() < 5)
+    {
+        yCWarning(GO_AND_FIND_IT_MIRROR, "Wrong status message: %s", b.toString().c_str());
+        return;
+    }
+
+    int seq = b.get(0).asInt32();
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (seq <= m_seq)
+        {
+            //goAndFindIt has been restarted: its command counter starts again from zero
+            yCDebug(GO_AND_FIND_IT_MIRROR, "Status sequence restarted from %d", seq);
+            m_cmd_expected = 0;
+        }
+        else if (m_seq > 0 && seq != m_seq + 1)
+            yCDebug(GO_AND_FIND_IT_MIRROR, "%d status messages lost", seq - m_seq - 1);
+
+        m_seq = seq;
+        m_cmd_count = b.get(1).asInt32();
+        m_status = b.get(2).asString();
+        m_what = b.get(3).asString();
+        m_where = b.get(4).asString();
+        m_last_update = Time::now();
+    }
+    m_cv.notify_all();
+}
+
+
+/****************************************************************/
+void GoAndFindItMirror::commandSending()
+{
+    lock_guard<mutex> lock(m_mutex);
+    //taken before the request: goAndFindIt publishes the state before replying, so it could be received
+    //before the reply. The state of a previous command could still be on its way too
+    m_cmd_expected = max(m_cmd_count, m_cmd_expected) + 1;
+    m_cmd_sent_time = Time::now();
+}
+
+
+/****************************************************************/
+void GoAndFindItMirror::commandLost()
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_cmd_expected--;
+}
+
+
+/****************************************************************/
+bool GoAndFindItMirror::waitCommandDone()
+{
+    //timed from now: the reply to the command can take longer than cmd_wait_time
+    unique_lock<mutex> lock(m_mutex);
+    return m_cv.wait_for(lock, chrono::duration<double>(m_cmd_wait_time), [&]{ return m_cmd_count >= m_cmd_expected; });
+}
+
+
+/****************************************************************/
+bool GoAndFindItMirror::waitUpToDate(unique_lock<mutex>& lock)
+{
+    if (m_last_update < 0)
+        return false;
+
+    double left = m_cmd_sent_time + m_cmd_wait_time - Time::now();
+    if (left > 0)
+        m_cv.wait_for(lock, chrono::duration<double>(left), [&]{ return m_cmd_count >= m_cmd_expected; });
+
+    return m_cmd_count >= m_cmd_expected && Time::now() - m_last_update < m_stale_time;
+}
+
+
+/****************************************************************/
+string GoAndFindItMirror::ask(const string& query)
+{
+    Bottle request, reply;
+    request.addString(query);
+    m_rpc.write(request, reply);
+
+    return reply.get(0).asString();
+}
+
+
+/****************************************************************/
+string GoAndFindItMirror::getStatus()
+{
+    {
+        unique_lock<mutex> lock(m_mutex);
+        if (waitUpToDate(lock))
+            return m_status;
+    }
+
+    return ask("status");
+}
+
+
+/****************************************************************/
+string GoAndFindItMirror::getWhat()
+{
+    {
+        unique_lock<mutex> lock(m_mutex);
+        if (waitUpToDate(lock))
+            return m_what;
+    }
+
+    return ask("what");
+}
+
+
+/****************************************************************/
+string GoAndFindItMirror::getWhere()
+{
+    {
+        unique_lock<mutex> lock(m_mutex);
+        if (waitUpToDate(lock))
+            return m_where;
+    }
+
+    return ask("where");
+}
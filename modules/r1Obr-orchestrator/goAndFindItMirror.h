@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef GO_AND_FIND_IT_MIRROR_H
+#define GO_AND_FIND_IT_MIRROR_H
+
+#include <yarp/os/all.h>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <algorithm>
+
+using namespace yarp::os;
+using namespace std;
+
+// Local copy of the state of goAndFindIt, received from its status port.
+// The getters read from memory. After a command has been sent to goAndFindIt they wait (up to
+// "cmd_wait_time") for the state following that command; if nothing recent has been received
+// they fall back to the RPCs, so the orchestrator keeps working with an older goAndFindIt.
+class GoAndFindItMirror : public TypedReaderCallback<Bottle>
+{
+private:
+    BufferedPort<Bottle>    m_port;
+    RpcClient&              m_rpc;
+
+    mutex                   m_mutex;
+    condition_variable      m_cv;
+    int                     m_seq;
+    int                     m_cmd_count;
+    int                     m_cmd_expected;     //commands handled by goAndFindIt once the last one sent is done
+    double                  m_cmd_sent_time;
+    string                  m_status;
+    string                  m_what;
+    string                  m_where;
+    double                  m_last_update;
+    double                  m_stale_time;
+    double                  m_cmd_wait_time;
+
+public:
+    GoAndFindItMirror(RpcClient& rpc);
+    ~GoAndFindItMirror() = default;
+
+    bool configure(ResourceFinder& rf);
+    void close();
+
+    using TypedReaderCallback<Bottle>::onRead;
+    void onRead(Bottle& b) override;
+
+    //to be called before sending a command that changes the state of goAndFindIt
+    void commandSending();
+    //the command has not reached goAndFindIt
+    void commandLost();
+    //waits up to "cmd_wait_time" for the state following the last command sent. False if it has not arrived
+    bool waitCommandDone();
+
+    string getStatus();
+    string getWhat();
+    string getWhere();
+
+private:
+    //waits for the state following the last command. False if the local copy cannot be used
+    bool waitUpToDate(unique_lock<mutex>& lock);
+    string ask(const string& query);
+};
+
+#endif
@@ -47,6 +47,12 @@ bool Nav2Loc::configure(yarp::os::ResourceFinder &rf)
         return false;
     }
 
+    // --------- Navigation status --------- //
+    string navStatusPort = rf.check("nav_status_port") ? rf.find("nav_status_port").asString() : "/navStatusBroadcaster/status:o";
+    m_navStatus = new NavStatusCache(m_iNav2D);
+    if(!m_navStatus->open("/r1Obr-orchestrator/nav2loc/navStatus:i", navStatusPort))
+        return false;
+
     // --------- Home coordinates config --------- //
     Vector home_position(3, 0.0);
 
@@ -65,14 +71,15 @@ bool Nav2Loc::configure(yarp::os::ResourceFinder &rf)
     }
     if(home_config.check("near_distance")) {m_near_distance = home_config.find("near_distance").asFloat32();}
 
-    MapGrid2D  map;
-    if(!m_iNav2D->getCurrentNavigationMap(NavigationMapTypeEnum::global_map, map))
+    //only the name of the map is needed, not the grid
+    string mapName;
+    if(!MapMetadata::getMapName(m_navStatus, m_iNav2D, mapName))
     {
         yCError(NAV_2_LOC, "Error retrieving current global map");
         return false;
     }
 
-    m_home_location = Map2DLocation(map.getMapName(), home_position[0], home_position[1], home_position[2]);
+    m_home_location = Map2DLocation(mapName, home_position[0], home_position[1], home_position[2]);
 
     return true;
 }
@@ -80,6 +87,13 @@ bool Nav2Loc::configure(yarp::os::ResourceFinder &rf)
 
 void Nav2Loc::close()
 {
+    if(m_navStatus)
+    {
+        m_navStatus->close();
+        delete m_navStatus;
+        m_navStatus = nullptr;
+    }
+
     if(m_nav2DPoly.isValid())
         m_nav2DPoly.close();
 }
@@ -87,9 +101,10 @@ void Nav2Loc::close()
 
 bool Nav2Loc::goHome()
 {
-    
+    m_navStatus->goalSent();
     if(!m_iNav2D->gotoTargetByAbsoluteLocation(m_home_location))
     {
+        m_navStatus->goalFailed();
         yCError(NAV_2_LOC, "Error with navigation to home location");
         return false;
     }
@@ -105,8 +120,10 @@ bool Nav2Loc::go(string loc)
     if (loc == "home")
         return goHome();
 
+    m_navStatus->goalSent();
     if(!m_iNav2D->gotoTargetByLocationName(loc))
     {
+        m_navStatus->goalFailed();
         yCError(NAV_2_LOC, "Error with navigation to home location");
         return false;
     }
@@ -142,7 +159,7 @@ bool Nav2Loc::resumeGo()
 bool Nav2Loc::areYouArrived()
 {
     NavigationStatusEnum currentStatus;
-    m_iNav2D->getNavigationStatus(currentStatus);
+    m_navStatus->getNavigationStatus(currentStatus);
 
     return currentStatus == navigation_status_goal_reached;
 }
@@ -151,8 +168,8 @@ bool Nav2Loc::areYouArrived()
 bool Nav2Loc::areYouNearToGoal()
 {
     Map2DLocation robot, target;
-    m_iNav2D->getAbsoluteLocationOfCurrentTarget(target);
-    m_iNav2D->getCurrentPosition(robot);
+    m_navStatus->getAbsoluteLocationOfCurrentTarget(target);
+    m_navStatus->getCurrentPosition(robot);
 
     return sqrt(pow((robot.x-target.x), 2) + pow((robot.y-target.y), 2)) < m_near_distance;
 }
@@ -161,7 +178,7 @@ bool Nav2Loc::areYouNearToGoal()
 bool Nav2Loc::areYouMoving()
 {
     NavigationStatusEnum currentStatus;
-    m_iNav2D->getNavigationStatus(currentStatus);
+    m_navStatus->getNavigationStatus(currentStatus);
 
     return currentStatus == navigation_status_moving;
 }
@@ -169,7 +186,7 @@ bool Nav2Loc::areYouMoving()
 bool Nav2Loc::isNavigationAborted()
 {
     NavigationStatusEnum currentStatus;
-    m_iNav2D->getNavigationStatus(currentStatus);
+    m_navStatus->getNavigationStatus(currentStatus);
 
     return currentStatus == navigation_status_aborted;
 }
@@ -177,4 +194,14 @@ bool Nav2Loc::isNavigationAborted()
 string Nav2Loc::getCurrentTarget()
 {
     return m_current_target_location;
-}
\ No newline at end of file
+}
+
+bool Nav2Loc::getCurrentPosition(Map2DLocation& robot)
+{
+    return m_navStatus->getCurrentPosition(robot);
+}
+
+bool Nav2Loc::getMapName(string& map_name)
+{
+    return MapMetadata::getMapName(m_navStatus, m_iNav2D, map_name);
+}
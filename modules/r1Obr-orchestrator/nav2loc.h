@@ -27,6 +27,8 @@
 #include <yarp/os/Port.h>
 #include <yarp/os/RFModule.h>
 #include <cmath>
+#include "navStatusCache.h"
+#include "mapMetadata.h"
 
 using namespace yarp::os;
 using namespace yarp::dev;
@@ -44,6 +46,7 @@ private:
     // Devices
     PolyDriver              m_nav2DPoly;
     Nav2D::INavigation2D*   m_iNav2D{nullptr};
+    NavStatusCache*         m_navStatus{nullptr};
 
 public:
     Nav2Loc() : m_near_distance(3.0) {}
@@ -60,6 +63,8 @@ public:
     bool areYouMoving();
     bool isNavigationAborted();
     string getCurrentTarget();
+    bool getCurrentPosition(Map2DLocation& robot);
+    bool getMapName(string& map_name);
 };
 
 #endif //NAV_2_LOC_H
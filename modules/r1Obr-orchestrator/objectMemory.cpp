@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "objectMemory.h"
+#include <fstream>
+#include <cstdio>
+
+YARP_LOG_COMPONENT(OBJECT_MEMORY, "r1_obr.orchestrator.objectMemory")
+
+
+/****************************************************************/
+ObjectMemory::ObjectMemory() :
+    PeriodicThread(10.0),
+    m_active(true),
+    m_file("object_memory.txt"),
+    m_merge_radius(0.5),
+    m_half_life(3600.0),
+    m_min_confidence(0.3),
+    m_max_objects(1000),
+    m_dirty(false)
+{
+}
+
+
+/****************************************************************/
+bool ObjectMemory::configure(ResourceFinder& rf)
+{
+    if(!rf.check("OBJECT_MEMORY"))
+    {
+        yCWarning(OBJECT_MEMORY,"OBJECT_MEMORY section missing in ini file. Using the default values");
+    }
+    Searchable& config = rf.findGroup("OBJECT_MEMORY");
+    m_active = config.check("active") ? !(config.find("active").asString() == "false") : true;
+    if(config.check("file"))            {m_file = config.find("file").asString();}
+    if(config.check("merge_radius"))    {m_merge_radius = config.find("merge_radius").asFloat64();}
+    if(config.check("half_life"))       {m_half_life = config.find("half_life").asFloat64();}
+    if(config.check("min_confidence"))  {m_min_confidence = config.find("min_confidence").asFloat64();}
+    if(config.check("max_objects"))     {m_max_objects = config.find("max_objects").asInt32();}
+    if(config.check("save_period"))     {setPeriod(config.find("save_period").asFloat64());}
+
+    if (!m_active)
+        return true;
+
+    if (m_merge_radius <= 0.0)
+        m_merge_radius = 0.5;
+
+    if (m_file != "")
+        load();
+    yCInfo(OBJECT_MEMORY, "Object memory: %d objects, %s", (int)m_objects.size(), m_file == "" ? "not saved" : ("saved in " + m_file).c_str());
+
+    return start();
+}
+
+
+/****************************************************************/
+void ObjectMemory::close()
+{
+    if (isRunning())
+        stop();
+
+    if (m_active && m_dirty)
+        run();
+}
+
+
+/****************************************************************/
+void ObjectMemory::run()
+{
+    vector<Object> objects;
+    {
+        lock_guard<mutex> lock(m_mutex);
+        if (!m_dirty)
+            return;
+        objects = m_objects;
+        m_dirty = false;
+    }
+
+    save(objects);
+}
+
+
+/****************************************************************/
+void ObjectMemory::setMap(const string& map)
+{
+    lock_guard<mutex> lock(m_mutex);
+    m_map = map;
+}
+
+
+/****************************************************************/
+int64_t ObjectMemory::cellOf(double x, double y)
+{
+    int64_t ix = (int64_t)floor(x / m_merge_radius);
+    int64_t iy = (int64_t)floor(y / m_merge_radius);
+    return cellKey(ix, iy);
+}
+
+
+/****************************************************************/
+int64_t ObjectMemory::cellKey(int64_t ix, int64_t iy)
+{
+    //shifted as unsigned: the indices are negative for negative coordinates
+    return (int64_t)(((uint64_t)ix << 32) | ((uint64_t)iy & 0xFFFFFFFFu));
+}
+
+
+/****************************************************************/
+void ObjectMemory::reindex()
+{
+    m_by_label.clear();
+    m_by_cell.clear();
+    for (size_t i=0; i<m_objects.size(); i++)
+    {
+        m_by_label[m_objects[i].label].push_back(i);
+        m_by_cell[cellOf(m_objects[i].x, m_objects[i].y)].push_back(i);
+    }
+}
+
+
+/****************************************************************/
+void ObjectMemory::record(const Bottle& detections, double time)
+{
+    for (size_t i=0; i<detections.size(); i++)
+    {
+        Bottle* det = detections.get(i).asList();
+        if (!det)   //"nothing"
+            continue;
+
+        Bottle* world = det->get(4).asList();
+        if (!world || world->size() != 3)
+            continue;
+
+        record(det->get(0).asString(), det->get(1).asFloat64(), world->get(0).asFloat64(), world->get(1).asFloat64(), world->get(2).asFloat64(), time);
+    }
+}
+
+
+/****************************************************************/
+void ObjectMemory::record(const string& label, double conf, double x, double y, double z, double time)
+{
+    if (!m_active || label == "")
+        return;
+
+    lock_guard<mutex> lock(m_mutex);
+
+    //the closest object of the same label, in the cells around the detection
+    int64_t ix = (int64_t)floor(x / m_merge_radius);
+    int64_t iy = (int64_t)floor(y / m_merge_radius);
+    int best = -1;
+    double best_dist = m_merge_radius;
+    for (int64_t cx = ix-1; cx <= ix+1; cx++)
+    {
+        for (int64_t cy = iy-1; cy <= iy+1; cy++)
+        {
+            auto cell = m_by_cell.find(cellKey(cx, cy));
+            if (cell == m_by_cell.end())
+                continue;
+            for (size_t i : cell->second)
+            {
+                const Object& obj = m_objects[i];
+                double dist = sqrt(pow(obj.x - x, 2) + pow(obj.y - y, 2) + pow(obj.z - z, 2));
+                if (obj.label == label && obj.map == m_map && dist < best_dist)
+                {
+                    best = (int)i;
+                    best_dist = dist;
+                }
+            }
+        }
+    }
+
+    if (best < 0)
+    {
+        m_objects.push_back({label, m_map, x, y, z, time, conf, 1});
+        size_t i = m_objects.size() - 1;
+        m_by_label[label].push_back(i);
+        m_by_cell[cellOf(x, y)].push_back(i);
+        if (m_objects.size() > m_max_objects)
+            prune();
+    }
+    else
+    {
+        //the position is averaged over the last detections
+        Object& obj = m_objects[best];
+        int64_t old_cell = cellOf(obj.x, obj.y);
+        double w = min(obj.hits, 10);
+        obj.x = (obj.x * w + x) / (w + 1);
+        obj.y = (obj.y * w + y) / (w + 1);
+        obj.z = (obj.z * w + z) / (w + 1);
+        obj.conf = max(confidence(obj, time), conf);
+        obj.time = time;
+        obj.hits++;
+
+        int64_t new_cell = cellOf(obj.x, obj.y);
+        if (new_cell != old_cell)
+        {
+            vector<size_t>& old_indexes = m_by_cell[old_cell];
+            old_indexes.erase(find(old_indexes.begin(), old_indexes.end(), (size_t)best));
+            if (old_indexes.empty())
+                m_by_cell.erase(old_cell);
+            m_by_cell[new_cell].push_back(best);
+        }
+    }
+
+    m_dirty = true;
+}
+
+
+/****************************************************************/
+void ObjectMemory::prune()
+{
+    //the objects with the lowest confidence now are forgotten
+    double now = Time::now();
+    sort(m_objects.begin(), m_objects.end(), [this, now](const Object& a, const Object& b)
+    {
+        return confidence(a, now) > confidence(b, now);
+    });
+    m_objects.resize(m_max_objects);
+    reindex();
+}
+
+
+/****************************************************************/
+void ObjectMemory::forget(const string& label, double x, double y, double z, double radius)
+{
+    lock_guard<mutex> lock(m_mutex);
+    size_t before = m_objects.size();
+    m_objects.erase(remove_if(m_objects.begin(), m_objects.end(), [&](const Object& obj)
+    {
+        return obj.label == label && obj.map == m_map && sqrt(pow(obj.x - x, 2) + pow(obj.y - y, 2) + pow(obj.z - z, 2)) < radius;
+    }), m_objects.end());
+
+    if (m_objects.size() != before)
+    {
+        reindex();
+        m_dirty = true;
+    }
+}
+
+
+/****************************************************************/
+bool ObjectMemory::recall(const string& label, Object& object)
+{
+    if (!m_active)
+        return false;
+
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_by_label.find(label);
+    if (it == m_by_label.end())
+        return false;
+
+    double now = Time::now();
+    double best_conf = -1.0;
+    for (size_t i : it->second)
+    {
+        if (m_objects[i].map != m_map)
+            continue;
+        double conf = confidence(m_objects[i], now);
+        if (conf > best_conf)
+        {
+            object = m_objects[i];
+            best_conf = conf;
+        }
+    }
+    object.conf = best_conf;
+
+    return best_conf >= m_min_confidence;
+}
+
+
+/****************************************************************/
+void ObjectMemory::nearby(double x, double y, double radius, vector<Object>& objects)
+{
+    objects.clear();
+    lock_guard<mutex> lock(m_mutex);
+    int64_t ix0 = (int64_t)floor((x - radius) / m_merge_radius);
+    int64_t ix1 = (int64_t)floor((x + radius) / m_merge_radius);
+    int64_t iy0 = (int64_t)floor((y - radius) / m_merge_radius);
+    int64_t iy1 = (int64_t)floor((y + radius) / m_merge_radius);
+    for (int64_t cx = ix0; cx <= ix1; cx++)
+    {
+        for (int64_t cy = iy0; cy <= iy1; cy++)
+        {
+            auto cell = m_by_cell.find(cellKey(cx, cy));
+            if (cell == m_by_cell.end())
+                continue;
+            for (size_t i : cell->second)
+            {
+                if (m_objects[i].map == m_map && sqrt(pow(m_objects[i].x - x, 2) + pow(m_objects[i].y - y, 2)) < radius)
+                    objects.push_back(m_objects[i]);
+            }
+        }
+    }
+}
+
+
+/****************************************************************/
+double ObjectMemory::confidence(const Object& object, double now)
+{
+    if (m_half_life <= 0.0)
+        return object.conf;
+
+    return object.conf * pow(0.5, max(0.0, now - object.time) / m_half_life);
+}
+
+
+/****************************************************************/
+bool ObjectMemory::load()
+{
+    ifstream file(m_file);
+    if (!file.is_open())
+        return false;
+
+    string line;
+    while (getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        Bottle b;
+        b.fromString(line);
+        if (b.size() != 8)
+            continue;
+
+        m_objects.push_back({b.get(0).asString(), b.get(1).asString(), b.get(2).asFloat64(), b.get(3).asFloat64(), b.get(4).asFloat64(), 
+                             b.get(5).asFloat64(), b.get(6).asFloat64(), b.get(7).asInt32()});
+    }
+
+    if (m_objects.size() > m_max_objects)
+        prune();
+    else
+        reindex();
+
+    return true;
+}
+
+
+/****************************************************************/
+bool ObjectMemory::save(const vector<Object>& objects)
+{
+    if (m_file == "")
+        return true;
+
+    //written with a temporary name, so that the memory is never read while being written
+    string tmp = m_file + ".tmp";
+    ofstream file(tmp, ios::trunc);
+    if (!file.is_open())
+    {
+        yCWarning(OBJECT_MEMORY) << "Cannot write" << tmp;
+        return false;
+    }
+
+    file << "# label map x y z time confidence hits" << endl;
+    for (const auto& obj : objects)
+    {
+        Bottle b;
+        b.addString(obj.label);
+        b.addString(obj.map);
+        b.addFloat64(obj.x);
+        b.addFloat64(obj.y);
+        b.addFloat64(obj.z);
+        b.addFloat64(obj.time);
+        b.addFloat64(obj.conf);
+        b.addInt32(obj.hits);
+        file << b.toString() << endl;
+    }
+    file.close();
+
+    return std::rename(tmp.c_str(), m_file.c_str()) == 0;
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef OBJECT_MEMORY_H
+#define OBJECT_MEMORY_H
+
+#include <yarp/os/all.h>
+#include <vector>
+#include <algorithm>
+#include <unordered_map>
+#include <mutex>
+#include <cmath>
+#include <cstdint>
+
+using namespace yarp::os;
+using namespace std;
+
+// Where the objects have been seen: every detection with a world position (e.g. from detectionLifter)
+// is recorded with its label, time and confidence, whatever the object being searched.
+// Detections of the same label closer than "merge_radius" are the same object. The objects are indexed
+// by label and by cell of a grid on the floor, and saved to "file" so that they survive a restart.
+// The confidence of an object halves every "half_life" seconds since it was last seen, and it is
+// recalled only if its confidence is at least "min_confidence".
+// Every object is stored with the map it has been seen in: only the objects of the current map are used.
+class ObjectMemory : public PeriodicThread
+{
+public:
+    struct Object
+    {
+        string              label;
+        string              map;
+        double              x, y, z;            //world coordinates
+        double              time;               //last seen
+        double              conf;               //confidence when last seen
+        int                 hits;               //detections merged
+    };
+
+private:
+    bool                    m_active;
+    string                  m_file;
+    double                  m_merge_radius;
+    double                  m_half_life;
+    double                  m_min_confidence;
+    size_t                  m_max_objects;
+
+    mutex                   m_mutex;
+    string                  m_map;              //current map
+    vector<Object>          m_objects;
+    unordered_map<string, vector<size_t>>   m_by_label;     //indexes of m_objects
+    unordered_map<int64_t, vector<size_t>>  m_by_cell;      //indexes of m_objects, cells of side merge_radius
+    bool                    m_dirty;
+
+    int64_t cellOf(double x, double y);
+    static int64_t cellKey(int64_t ix, int64_t iy);
+    void    reindex();
+    void    prune();
+    bool    load();
+    bool    save(const vector<Object>& objects);
+
+public:
+    ObjectMemory();
+    ~ObjectMemory() = default;
+
+    bool configure(ResourceFinder& rf);
+    void close();
+
+    //inherited from PeriodicThread: the memory is saved if changed
+    void run() override;
+
+    bool isActive() { return m_active; }
+
+    //the map the positions refer to, from now on
+    void setMap(const string& map);
+
+    //detections in the detectionLifter format: (<label> <conf> <cx> <cy> (<x> <y> <z>) ...) ...
+    void record(const Bottle& detections, double time);
+    void record(const string& label, double conf, double x, double y, double z, double time);
+    //the objects of "label" within "radius" from the given position (in the current map) are removed
+    void forget(const string& label, double x, double y, double z, double radius);
+
+    //the object of "label" with the highest confidence now, "conf" is the confidence now
+    bool recall(const string& label, Object& object);
+    //the objects within "radius" from the given position on the floor
+    void nearby(double x, double y, double radius, vector<Object>& objects);
+
+    double confidence(const Object& object, double now);
+};
+
+#endif
@@ -30,7 +30,14 @@ OrchestratorThread::OrchestratorThread(yarp::os::ResourceFinder &rf):
     m_where_specified(false),
     m_object_found(false),
     m_object_not_found(false),
-    m_going(false)
+    m_going(false),
+    m_multi(false),
+    m_has_task(false),
+    m_hold(false),
+    m_search_start(0.0),
+    m_verify_distance(1.0),
+    m_verify_count(0),
+    m_search_count(0)
 {
     //Defaults
     m_sensor_network_rpc_port_name  = "/r1Obr-orchestrator/sensor_network:rpc";
@@ -39,7 +46,9 @@ OrchestratorThread::OrchestratorThread(yarp::os::ResourceFinder &rf):
     m_goandfindit_result_port_name  = "/r1Obr-orchestrator/goAndFindIt/result:i";
     m_positive_outcome_port_name    = "/r1Obr-orchestrator/positive_outcome:o";
     m_negative_outcome_port_name    = "/r1Obr-orchestrator/negative_outcome:o";
+    m_found_objects_port_name       = "/r1Obr-orchestrator/found_objects:o";
     m_faceexpression_rpc_port_name  = "/r1Obr-orchestrator/faceExpression:rpc";
+    m_keyframe_archive_rpc_port_name= "/r1Obr-orchestrator/keyframeArchive:rpc";
     m_map_prefix = "";
 }
 
@@ -52,6 +61,7 @@ bool OrchestratorThread::threadInit()
     if (m_rf.check("goandfindit_rpc_port"))     {m_goandfindit_rpc_port_name      = m_rf.find("goandfindit_rpc_port").asString();}
     if (m_rf.check("goandfindit_result_port"))  {m_goandfindit_result_port_name   = m_rf.find("goandfindit_result_port").asString();}
     if (m_rf.check("faceexpression_rpc_port"))  {m_faceexpression_rpc_port_name   = m_rf.find("faceexpression_rpc_port").asString();}
+    if (m_rf.check("keyframe_archive_rpc_port")){m_keyframe_archive_rpc_port_name = m_rf.find("keyframe_archive_rpc_port").asString();}
 
     if(m_rf.check("map_prefix")){m_map_prefix = m_rf.find("map_prefix").asString();} 
     
@@ -65,6 +75,11 @@ bool OrchestratorThread::threadInit()
         return false;
     }
 
+    string locationsPort = m_rf.check("locations_port") ? m_rf.find("locations_port").asString() : "/nextLocPlanner/locations:o";
+    m_locations = new LocationCatalogue(m_nextLoc_rpc_port);
+    if(!m_locations->open("/r1Obr-orchestrator/locations:i", locationsPort))
+        return false;
+
     if(!m_goandfindit_rpc_port.open(m_goandfindit_rpc_port_name)){
         yCError(R1OBR_ORCHESTRATOR_THREAD) << "Cannot open goAndFindIt RPC port with name" << m_goandfindit_rpc_port_name;
         return false;
@@ -75,11 +90,23 @@ bool OrchestratorThread::threadInit()
         return false;
     }
 
+    m_gafi_mirror = new GoAndFindItMirror(m_goandfindit_rpc_port);
+    if(!m_gafi_mirror->configure(m_rf))
+        return false;
+
     if(!m_faceexpression_rpc_port.open(m_faceexpression_rpc_port_name)){
         yCError(R1OBR_ORCHESTRATOR_THREAD) << "Cannot open faceExpression RPC port with name" << m_faceexpression_rpc_port_name;
         return false;
     }
 
+    if(!m_keyframe_archive_rpc_port.open(m_keyframe_archive_rpc_port_name)){
+        yCError(R1OBR_ORCHESTRATOR_THREAD) << "Cannot open keyframeArchive RPC port with name" << m_keyframe_archive_rpc_port_name;
+        return false;
+    }
+    //a query runs the detector on the archived frames: it can be slow, but a stalled archive must not block the search forever
+    double archiveTimeout = m_rf.check("keyframe_archive_timeout") ? m_rf.find("keyframe_archive_timeout").asFloat64() : 60.0;
+    m_keyframe_archive_rpc_port.asPort().setTimeout(archiveTimeout);
+
 
     // --------- output ports config --------- //
     if(!m_rf.check("OUTPUT_PORT_GROUP"))
@@ -91,6 +118,7 @@ bool OrchestratorThread::threadInit()
         Searchable& outputs = m_rf.findGroup("OUTPUT_PORT_GROUP");
         if(outputs.check("positive_outcome_port")) {m_positive_outcome_port_name = outputs.find("positive_outcome_port").asString();}
         if(outputs.check("negative_outcome_port")) {m_negative_outcome_port_name = outputs.find("negative_outcome_port").asString();}
+        if(outputs.check("found_objects_port")) {m_found_objects_port_name = outputs.find("found_objects_port").asString();}
     }
 
     if(!m_positive_outcome_port.open(m_positive_outcome_port_name)){
@@ -103,6 +131,21 @@ bool OrchestratorThread::threadInit()
         return false;
     }
 
+    if(!m_found_objects_port.open(m_found_objects_port_name)){
+        yCError(R1OBR_ORCHESTRATOR_THREAD) << "Cannot open found objects port with name" << m_found_objects_port_name;
+        return false;
+    }
+
+    // --------- Telemetry --------- //
+    m_telemetry = new SearchTelemetry("r1Obr-orchestrator");
+    if(!m_telemetry->configure(m_rf))
+        return false;
+
+    // --------- Request queue --------- //
+    m_queue = new RequestQueue();
+    if(!m_queue->configure(m_rf))
+        return false;
+
     // --------- Nav2Loc config --------- //
     m_nav2loc = new Nav2Loc();
     if(!m_nav2loc->configure(m_rf))
@@ -111,6 +154,17 @@ bool OrchestratorThread::threadInit()
         return false;
     }
 
+    // --------- Object Memory config --------- //
+    m_memory = new ObjectMemory();
+    if(!m_memory->configure(m_rf))
+    {
+        yCError(R1OBR_ORCHESTRATOR_THREAD,"ObjectMemory configuration failed");
+        return false;
+    }
+    string mapName;
+    if(m_nav2loc->getMapName(mapName))
+        m_memory->setMap(mapName);
+
     // --------- ContinousSearch config --------- //
     m_continuousSearch = new ContinuousSearch();
     if(!m_continuousSearch->configure(m_rf))
@@ -118,6 +172,9 @@ bool OrchestratorThread::threadInit()
         yCError(R1OBR_ORCHESTRATOR_THREAD,"ContinuousSearch configuration failed");
         return false;
     }
+    m_continuousSearch->setMemory(m_memory);
+    Searchable& cs_config = m_rf.findGroup("CONTINUOUS_SEARCH");
+    if (cs_config.check("verify_distance")) {m_verify_distance = cs_config.find("verify_distance").asFloat64();}
 
     // --------- Chat Bot initialization --------- //
     m_chat_bot = new ChatBot();
@@ -133,6 +190,12 @@ bool OrchestratorThread::threadInit()
         return false;
     }
 
+    //the sentences that the orchestrator can ask to say are ready before they are needed
+    vector<string> canned;
+    for (int stat = object_found_maybe; stat <= fallback; stat++)
+        canned.push_back(saysToString((R1_says)stat));
+    m_chat_bot->prewarm(canned);
+
     // --------- Tiny Dancer --------- //
     m_tiny_dancer = new TinyDancer(m_rf);
     if(!m_tiny_dancer->configure())
@@ -152,6 +215,13 @@ void OrchestratorThread::threadRelease()
         
     if (m_nextLoc_rpc_port.asPort().isOpen())
         m_nextLoc_rpc_port.close(); 
+
+    if(m_locations)
+    {
+        m_locations->close();
+        delete m_locations;
+        m_locations = nullptr;
+    }
         
     if (m_goandfindit_rpc_port.asPort().isOpen())
         m_goandfindit_rpc_port.close(); 
@@ -159,14 +229,31 @@ void OrchestratorThread::threadRelease()
     if(!m_goandfindit_result_port.isClosed())
         m_goandfindit_result_port.close();
 
+    if(m_gafi_mirror)
+    {
+        m_gafi_mirror->close();
+        delete m_gafi_mirror;
+        m_gafi_mirror = nullptr;
+    }
+
     if(!m_positive_outcome_port.isClosed())
         m_positive_outcome_port.close();
 
     if(!m_negative_outcome_port.isClosed())
         m_negative_outcome_port.close();
+
+    if(!m_found_objects_port.isClosed())
+        m_found_objects_port.close();
         
     if (m_faceexpression_rpc_port.asPort().isOpen())
         m_faceexpression_rpc_port.close(); 
+
+    //a query in progress is interrupted, so that it ends without waiting for the reply
+    m_keyframe_archive_rpc_port.interrupt();
+    if (m_archive_query.valid())
+        m_archive_query.wait();
+    if (m_keyframe_archive_rpc_port.asPort().isOpen())
+        m_keyframe_archive_rpc_port.close();
     
     m_nav2loc->close();
     delete m_nav2loc;
@@ -174,12 +261,26 @@ void OrchestratorThread::threadRelease()
     m_continuousSearch->close();
     delete m_continuousSearch;
 
+    if(m_memory)
+    {
+        m_memory->close();
+        delete m_memory;
+        m_memory = nullptr;
+    }
+
     m_chat_bot->close();
     delete m_chat_bot;
 
     m_tiny_dancer->close();
     delete m_tiny_dancer;
 
+    m_telemetry->close();
+    delete m_telemetry;
+    m_telemetry = nullptr;
+
+    delete m_queue;
+    m_queue = nullptr;
+
     yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Orchestrator thread released");
 
     return;
@@ -191,6 +292,8 @@ void OrchestratorThread::run()
     while (true)
     {
         setEmotion();
+
+        schedule();
         
         if (m_status == R1_ASKING_NETWORK)
         {
@@ -198,25 +301,45 @@ void OrchestratorThread::run()
             {
                 forwardRequest(m_request);
                 m_status = R1_SEARCHING;
+                m_search_count++;
                 yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Requested: %s", m_request.toString().c_str());
+                if (askMemory())
+                    m_telemetry->increment("memory_recalls");
+                else
+                    startArchiveQuery();
             }
         }
 
         else if (m_status == R1_SEARCHING)
         {
-            Bottle req{"status"};
-            string goandfindit_status = forwardRequest(req).get(0).asString();
+            checkArchive();
+
+            string goandfindit_status = m_gafi_mirror->getStatus();
+            checkMergedGoes(goandfindit_status);
+            checkRecalled(goandfindit_status);
 
             if(goandfindit_status == "navigating")
             {
                 bool doContSearch = !m_where_specified || m_nav2loc->areYouNearToGoal();
-                if(doContSearch && m_continuousSearch->seeObject(m_object))
+                ContinuousSearch::Sighting sighting;
+                if(doContSearch && m_continuousSearch->seeObject(m_objects, sighting))
                 {
-                    stopOrReset("stop");
-                    m_status = R1_CONTINUOUS_SEARCH;
-                    Time::delay(2.0);  //stopping the navigation the robot starts oscillating, better wait a couple of seconds before continuing
-                    yCInfo(R1OBR_ORCHESTRATOR_THREAD, "I thought I saw a %s", m_object.c_str());
-                    askChatBotToSpeak(object_found_maybe);
+                    m_sighted = sighting.label;
+                    m_telemetry->increment("sightings_while_navigating");
+                    //a weak sighting is checked from a verification location, without stopping the robot
+                    if (!sighting.strong && verifySighting(sighting))
+                    {
+                        m_continuousSearch->verifying();
+                        m_telemetry->increment("verification_locations");
+                    }
+                    else
+                    {
+                        stopOrReset("stop");
+                        m_status = R1_CONTINUOUS_SEARCH;
+                        Time::delay(2.0);  //stopping the navigation the robot starts oscillating, better wait a couple of seconds before continuing
+                        yCInfo(R1OBR_ORCHESTRATOR_THREAD, "I thought I saw a %s", m_sighted.c_str());
+                        askChatBotToSpeak(object_found_maybe);
+                    }
                 }
             }
             else 
@@ -224,6 +347,8 @@ void OrchestratorThread::run()
                 Bottle* result = m_goandfindit_result_port.read(false); 
                 if(result != nullptr)
                 {
+                    Stamp resultStamp;
+                    m_goandfindit_result_port.getEnvelope(resultStamp);
                     m_result = *result;
                     if (result->get(0).asString() == "not found")  
                     {
@@ -234,12 +359,24 @@ void OrchestratorThread::run()
                         
                         m_status = R1_OBJECT_NOT_FOUND;
                     }
+                    else if (m_multi && result->get(0).asString() == "all found")
+                    {
+                        allObjectsFound();
+                    }
+                    else if (m_multi)
+                    {
+                        multiObjectFound(m_result, resultStamp);
+                    }
                     else     
                     {
                         m_status = R1_OBJECT_FOUND;
+                        m_telemetry->addSample("search_total", m_search_start);
+                        m_telemetry->increment("objects_found");
                         Bottle&  sendOk = m_positive_outcome_port.prepare();
                         sendOk.clear();
                         sendOk = m_result;
+                        if (resultStamp.isValid())
+                            m_positive_outcome_port.setEnvelope(resultStamp);
                         m_positive_outcome_port.write();
                         yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Object found");
                     }
@@ -254,13 +391,35 @@ void OrchestratorThread::run()
 
         else if (m_status == R1_CONTINUOUS_SEARCH)
         {
-            Bottle&  sendOk = m_positive_outcome_port.prepare();
-            sendOk.clear();
-            sendOk.addString(m_object);
-            Bottle& obj_coords = sendOk.addList();
-            if (m_continuousSearch->whereObject(m_object, obj_coords) && m_status == R1_CONTINUOUS_SEARCH) //second condition added in case of external stop 
+            Bottle  sighting;
+            sighting.addString(m_sighted);
+            Bottle& obj_coords = sighting.addList();
+            Stamp coordsStamp;
+            SearchTelemetry::Timer checkTimer(m_telemetry, "sighting_check");
+            bool seen = m_continuousSearch->whereObject(m_sighted, obj_coords, coordsStamp);
+            checkTimer.stop();
+            if (seen && m_status == R1_CONTINUOUS_SEARCH && m_multi)
             {
+                //the other objects are still to be found: the tour goes on without the one just seen
+                yCInfo(R1OBR_ORCHESTRATOR_THREAD, "%s found while navigating", m_sighted.c_str());
+                Bottle drop;
+                drop.addString("drop");
+                drop.addString(m_sighted);
+                forwardRequest(drop);
+                multiObjectFound(sighting, coordsStamp);
+                if (m_status == R1_SEARCHING)
+                    resume();
+            }
+            else if (seen && m_status == R1_CONTINUOUS_SEARCH) //second condition added in case of external stop 
+            {
+                Bottle&  sendOk = m_positive_outcome_port.prepare();
+                sendOk.clear();
+                sendOk = sighting;
                 m_status = R1_OBJECT_FOUND;
+                m_telemetry->addSample("search_total", m_search_start);
+                m_telemetry->increment("objects_found");
+                if (coordsStamp.isValid())
+                    m_positive_outcome_port.setEnvelope(coordsStamp);
                 m_positive_outcome_port.write();
                 yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Object found while navigating");
             }
@@ -268,6 +427,8 @@ void OrchestratorThread::run()
             {
                 m_status = R1_SEARCHING;
                 yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Object actually not found. Resuming navigation");
+                m_telemetry->increment("false_sightings");
+                m_continuousSearch->reject();
                 askChatBotToSpeak(object_found_false);
                 resume();
             }
@@ -282,7 +443,10 @@ void OrchestratorThread::run()
         {
             yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Object not found");
             m_object_not_found = true;
+            m_telemetry->addSample("search_total", m_search_start);
+            m_telemetry->increment("objects_not_found");
 
+            SearchTelemetry::Timer homeTimer(m_telemetry, "go_home");
             m_nav2loc->goHome();
             bool arrived{false};
             while (!arrived && m_status == R1_OBJECT_NOT_FOUND )
@@ -290,6 +454,7 @@ void OrchestratorThread::run()
                 arrived = m_nav2loc->areYouArrived();
                 Time::delay(0.5);
             }
+            homeTimer.stop();
 
             if (m_status == R1_OBJECT_NOT_FOUND) //in case of external stop
             {
@@ -358,7 +523,7 @@ void OrchestratorThread::onRead(yarp::os::Bottle &b)
 
         if (cmd=="stop" || cmd=="reset") 
         { 
-            stopOrReset(cmd);
+            userStopOrReset(cmd);
         }
         if (cmd=="reset_home") 
         { 
@@ -375,16 +540,9 @@ void OrchestratorThread::onRead(yarp::os::Bottle &b)
         {
             resume();
         }
-        else if (cmd=="search")
-        {
-            if (m_status == R1_OBJECT_FOUND || m_status == R1_OBJECT_NOT_FOUND )
-                stopOrReset("stop");
-
-            search(b);            
-        }
-        else if (cmd=="go")
+        else if (cmd=="search" || cmd=="go")
         {
-            go(b.get(1).asString());           
+            submit(b);
         }
         else
         {
@@ -405,11 +563,335 @@ void OrchestratorThread::onStop()
 Bottle OrchestratorThread::forwardRequest(const Bottle& request)
 {
     Bottle _rep_;
-    m_goandfindit_rpc_port.write(request,_rep_);
+    string cmd = request.get(0).asString();
+    bool changesState = cmd != "status" && cmd != "what" && cmd != "where" && cmd != "help";
+    if (changesState)
+        m_gafi_mirror->commandSending();
+
+    SearchTelemetry::Timer rpcTimer(m_telemetry, "goandfindit_rpc");
+    if (!m_goandfindit_rpc_port.write(request,_rep_) && changesState)
+        m_gafi_mirror->commandLost();
 
     return _rep_;
 }
 
+/****************************************************************/
+string OrchestratorThread::submit(const Bottle& request)
+{
+    string cmd = request.get(0).asString();
+
+    //without the queue every new request replaces the current one
+    if (!m_queue->isEnabled())
+    {
+        if (cmd == "search")
+        {
+            if (m_status == R1_OBJECT_FOUND || m_status == R1_OBJECT_NOT_FOUND )
+                stopOrReset("stop");
+            search(request);
+        }
+        else
+            go(request.get(1).asString());
+        return "started";
+    }
+
+    lock_guard<mutex> lock(m_sched_mutex);
+    RequestQueue::Request req = m_queue->makeRequest(request);
+
+    if (m_has_task && isTaskFinished() && !m_hold)
+        completeTask();
+
+    if (!m_has_task || m_hold)
+    {
+        //a task stopped by the user is kept, it can be resumed when the new one is over
+        if (m_has_task)
+            suspendTask();
+        m_hold = false;
+        startTask(req);
+        return "started";
+    }
+
+    if (mergeRequest(req))
+        return "merged";
+
+    if (m_queue->preemptionEnabled() && req.priority > m_task.request.priority)
+    {
+        yCInfo(R1OBR_ORCHESTRATOR_THREAD, "%s interrupted by %s", m_task.request.cmd.toString().c_str(), request.toString().c_str());
+        suspendTask();
+        startTask(req);
+        return "started";
+    }
+
+    return m_queue->push(req) ? "queued" : "discarded";
+}
+
+/****************************************************************/
+void OrchestratorThread::schedule()
+{
+    if (!m_queue->isEnabled())
+        return;
+
+    lock_guard<mutex> lock(m_sched_mutex);
+    if (m_hold || !isTaskFinished())
+        return;
+
+    if (m_has_task)
+        completeTask();
+
+    //a search not found ends by itself once the robot is home and the outcome has been sent,
+    //while the robot stays with the object found until there is something else to do
+    if (m_status == R1_OBJECT_NOT_FOUND)
+        return;
+    if (m_status == R1_OBJECT_FOUND)
+    {
+        if (m_suspended.empty() && m_queue->empty())
+            return;
+        stopOrReset("stop");
+    }
+
+    //an interrupted request goes on before the queued ones with the same priority
+    RequestQueue::Request next;
+    if (!m_suspended.empty() && m_suspended.back().request.priority >= m_queue->topPriority())
+    {
+        Task task = m_suspended.back();
+        m_suspended.pop_back();
+        resumeTask(task);
+    }
+    else if (m_queue->pop(next))
+        startTask(next);
+}
+
+/****************************************************************/
+bool OrchestratorThread::isTaskFinished()
+{
+    //a search that has found the object, or has not found it, is over even if the robot is still showing the result
+    return m_status == R1_IDLE || m_status == R1_OBJECT_FOUND || m_status == R1_OBJECT_NOT_FOUND;
+}
+
+/****************************************************************/
+void OrchestratorThread::startTask(const RequestQueue::Request& req)
+{
+    yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Starting request: %s", req.cmd.toString().c_str());
+
+    m_task = Task();
+    m_task.request = req;
+    m_has_task = true;
+    m_merged_goes.clear();
+
+    string cmd = req.cmd.get(0).asString();
+    if (cmd == "search")
+    {
+        //goAndFindIt forgets the interrupted searches: they will start again
+        for (auto& task : m_suspended)
+        {
+            if (task.request.cmd.get(0).asString() == "search")
+                task.restart = true;
+        }
+        search(req.cmd);
+    }
+    else if (cmd == "go")
+        go(req.cmd.get(1).asString());
+}
+
+/****************************************************************/
+void OrchestratorThread::completeTask()
+{
+    yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Request completed: %s", m_task.request.cmd.toString().c_str());
+
+    //the merged locations that the search has not reached are still to be visited
+    for (const auto& loc : m_merged_goes)
+    {
+        Bottle goCmd;
+        goCmd.addString("go");
+        goCmd.addString(loc);
+        m_queue->push(m_queue->makeRequest(goCmd));
+    }
+    m_merged_goes.clear();
+    m_has_task = false;
+}
+
+/****************************************************************/
+void OrchestratorThread::suspendTask()
+{
+    Task task = m_task;
+    task.object = m_object;
+    task.objects = m_objects;
+    task.multi = m_multi;
+    task.where_specified = m_where_specified;
+    task.object_found = m_object_found;
+    task.object_not_found = m_object_not_found;
+    task.going = m_going;
+    task.search_request = m_request;
+    task.result = m_result;
+    task.search_start = m_search_start;
+
+    //goAndFindIt keeps the checked locations, the search can go on from where it was
+    if (m_status != R1_IDLE)
+        stopOrReset("stop");
+
+    for (const auto& loc : m_merged_goes)
+    {
+        Bottle goCmd;
+        goCmd.addString("go");
+        goCmd.addString(loc);
+        m_queue->push(m_queue->makeRequest(goCmd));
+    }
+    m_merged_goes.clear();
+
+    m_suspended.push_back(task);
+    m_has_task = false;
+    m_object_found = false;
+    m_object_not_found = false;
+    m_going = false;
+}
+
+/****************************************************************/
+void OrchestratorThread::resumeTask(Task& task)
+{
+    string cmd = task.request.cmd.get(0).asString();
+    if (task.restart || cmd == "go")
+    {
+        //a "go" starts again from where the robot is now
+        startTask(task.request);
+        return;
+    }
+
+    yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Resuming request: %s", task.request.cmd.toString().c_str());
+    m_task = task;
+    m_has_task = true;
+    m_object = task.object;
+    m_objects = task.objects;
+    m_multi = task.multi;
+    m_where_specified = task.where_specified;
+    m_object_found = task.object_found;
+    m_object_not_found = task.object_not_found;
+    m_going = task.going;
+    m_request = task.search_request;
+    m_result = task.result;
+    m_search_start = task.search_start;
+
+    resumeActivity();
+}
+
+/****************************************************************/
+bool OrchestratorThread::mergeRequest(const RequestQueue::Request& req)
+{
+    if (m_task.request.cmd.get(0).asString() != "search")
+        return false;
+    if (m_status != R1_ASKING_NETWORK && m_status != R1_SEARCHING && m_status != R1_CONTINUOUS_SEARCH)
+        return false;
+
+    string cmd = req.cmd.get(0).asString();
+    if (cmd == "go")
+    {
+        string loc = req.cmd.get(1).asString();
+        if (loc == "home")
+            return false;
+        if (loc.find(m_map_prefix) == string::npos) 
+            loc = m_map_prefix + loc;
+
+        //the location has to be one of the search: the one specified or one not checked yet
+        if (m_where_specified)
+        {
+            if (m_request.get(2).asString() != loc)
+                return false;
+        }
+        else
+        {
+            Bottle findRep;
+            m_locations->find(loc, findRep);
+            if (findRep.get(0).asString() != "ok" || findRep.get(1).asString() == "checked")
+                return false;
+        }
+
+        m_merged_goes.push_back(loc);
+        yCInfo(R1OBR_ORCHESTRATOR_THREAD, "go %s merged in the current search", loc.c_str());
+        return true;
+    }
+    else if (cmd == "search")
+    {
+        if (req.cmd == m_task.request.cmd)
+        {
+            yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Same search already in progress");
+            return true;
+        }
+
+        //other objects can be added to a search of the whole map
+        if (m_where_specified || req.cmd.size() != 2)
+            return false;
+
+        vector<string> whats;
+        if (req.cmd.get(1).isList())
+        {
+            Bottle* list = req.cmd.get(1).asList();
+            for (size_t i=0; i<list->size(); i++)
+                whats.push_back(list->get(i).asString());
+        }
+        else
+            whats.push_back(req.cmd.get(1).asString());
+
+        bool merged{false};
+        for (const auto& what : whats)
+        {
+            if (what == "" || find(m_objects.begin(), m_objects.end(), what) != m_objects.end())
+                continue;
+            Bottle add;
+            add.addString("add");
+            add.addString(what);
+            if (forwardRequest(add).get(0).asString() != "added")
+                break;  //the search is ending, the rest of the request is queued
+            m_objects.push_back(what);
+            merged = true;
+            yCInfo(R1OBR_ORCHESTRATOR_THREAD, "%s added to the current search", what.c_str());
+        }
+        if (!merged)
+            return false;
+        m_multi = m_objects.size() > 1;
+        Bottle objects;
+        for (const auto& what : m_objects)
+            objects.addString(what);
+        m_object = objects.toString();
+
+        return true;
+    }
+
+    return false;
+}
+
+/****************************************************************/
+void OrchestratorThread::checkMergedGoes(const string& goandfindit_status)
+{
+    if (goandfindit_status != "arrived" && goandfindit_status != "searching")
+        return;
+
+    lock_guard<mutex> lock(m_sched_mutex);
+    auto it = find(m_merged_goes.begin(), m_merged_goes.end(), m_gafi_mirror->getWhere());
+    if (it != m_merged_goes.end())
+    {
+        yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Location %s reached by the search", it->c_str());
+        m_merged_goes.erase(it);
+    }
+}
+
+/****************************************************************/
+string OrchestratorThread::userStopOrReset(const string& cmd)
+{
+    {
+        lock_guard<mutex> lock(m_sched_mutex);
+        if (cmd == "stop")
+            m_hold = true;
+        else
+        {
+            m_queue->clear();
+            m_suspended.clear();
+            m_merged_goes.clear();
+            m_has_task = false;
+            m_hold = false;
+        }
+    }
+
+    return stopOrReset(cmd);
+}
+
 /****************************************************************/
 void OrchestratorThread::search(const Bottle& btl)
 {
@@ -422,8 +904,15 @@ void OrchestratorThread::search(const Bottle& btl)
     m_object_not_found = false;
     m_going = false;
 
+    //results of a previous search, e.g. the end of a multi-object search already completed
+    while (m_goandfindit_result_port.getPendingReads() > 0)
+        m_goandfindit_result_port.read(false);
+
     if(resizeSearchBottle(btl))
     {
+        m_search_start = m_telemetry->startTime();
+        m_telemetry->increment("searches");
+        m_continuousSearch->newSearch();
         m_status = R1_ASKING_NETWORK;
     }
     else
@@ -444,9 +933,38 @@ bool OrchestratorThread::resizeSearchBottle(const Bottle& btl)
         m_where_specified = false;
 
     m_request.clear();
+    m_objects.clear();
     for (int i=0; i < min(sz,3); i++)
     {
-        if(i==2)
+        if(i==1 && btl.get(i).isList())
+        {
+            //"search (<what1> <what2> ...) [<where>]": all the objects are searched in the same tour
+            Bottle* whats = btl.get(i).asList();
+            Bottle& labels = m_request.addList();
+            for (size_t j=0; j < whats->size(); j++)
+            {
+                string what = whats->get(j).asString();
+                if (what != "" && find(m_objects.begin(), m_objects.end(), what) == m_objects.end())
+                {
+                    m_objects.push_back(what);
+                    labels.addString(what);
+                }
+            }
+            if (m_objects.empty())
+            {
+                yCError(R1OBR_ORCHESTRATOR_THREAD,"No object specified.");
+                m_request.clear();
+                return false;
+            }
+            m_object = labels.toString();
+        }
+        else if(i==1)
+        {
+            m_object = btl.get(i).asString();
+            m_objects.push_back(m_object);
+            m_request.addString(m_object);
+        }
+        else if(i==2)
         {
             string loc = btl.get(i).asString();
             
@@ -455,9 +973,8 @@ bool OrchestratorThread::resizeSearchBottle(const Bottle& btl)
                 loc = m_map_prefix + loc;
             }
             
-            Bottle req,rep;
-            req.fromString("find " + loc);
-            m_nextLoc_rpc_port.write(req,rep); //check if location name is valid
+            Bottle rep;
+            m_locations->find(loc, rep); //check if location name is valid
             if (rep.get(0).asString() != "ok")
             {
                 yCError(R1OBR_ORCHESTRATOR_THREAD,"Location specified is not valid.");
@@ -470,6 +987,7 @@ bool OrchestratorThread::resizeSearchBottle(const Bottle& btl)
         else
             m_request.addString(btl.get(i).asString());
     }
+    m_multi = m_objects.size() > 1;
 
     return true;
 }
@@ -525,7 +1043,7 @@ string OrchestratorThread::stopOrReset(const string& cmd)
 /****************************************************************/
 string OrchestratorThread::resetHome()
 {
-    stopOrReset("reset_noNavpos");
+    userStopOrReset("reset_noNavpos");
 
     if (setNavigationPosition())
     {
@@ -541,6 +1059,17 @@ string OrchestratorThread::resetHome()
 
 /****************************************************************/
 string OrchestratorThread::resume()
+{
+    string ret = resumeActivity();
+    {
+        lock_guard<mutex> lock(m_sched_mutex);
+        m_hold = false;
+    }
+    return ret;
+}
+
+/****************************************************************/
+string OrchestratorThread::resumeActivity()
 {
     yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Resuming");
 
@@ -584,9 +1113,9 @@ string OrchestratorThread::resume()
         Bottle rep, request{"resume"};
         rep = forwardRequest(request); 
 
-        request.clear();
-        request.addString("status");
-        if(forwardRequest(request).get(0).asString() != "idle") 
+        //the status following the resume: if it is not received, getStatus asks goAndFindIt
+        m_gafi_mirror->waitCommandDone();
+        if(m_gafi_mirror->getStatus() != "idle") 
             m_status = R1_SEARCHING;
         
         return "search resumed";
@@ -604,6 +1133,43 @@ void OrchestratorThread::objectFound()
     }
 }
 
+/****************************************************************/
+void OrchestratorThread::multiObjectFound(const Bottle& result, Stamp& stamp)
+{
+    string obj = result.get(0).asString();
+    auto it = find(m_objects.begin(), m_objects.end(), obj);
+    if (it == m_objects.end())
+        return; //already reported
+
+    m_objects.erase(it);
+    m_telemetry->increment("objects_found");
+    yCInfo(R1OBR_ORCHESTRATOR_THREAD, "%s found, %d objects still to find", obj.c_str(), (int)m_objects.size());
+
+    Bottle&  sendOk = m_found_objects_port.prepare();
+    sendOk.clear();
+    sendOk = result;
+    if (stamp.isValid())
+        m_found_objects_port.setEnvelope(stamp);
+    m_found_objects_port.write();
+
+    if (m_objects.empty())
+        allObjectsFound();
+    else
+        m_status = R1_SEARCHING;
+}
+
+/****************************************************************/
+void OrchestratorThread::allObjectsFound()
+{
+    if (m_status != R1_SEARCHING && m_status != R1_CONTINUOUS_SEARCH)
+        return;
+
+    yCInfo(R1OBR_ORCHESTRATOR_THREAD, "All the objects have been found");
+    m_telemetry->addSample("search_total", m_search_start);
+    m_status = R1_IDLE;
+    askChatBotToSpeak(object_found_true);
+}
+
 /****************************************************************/
 void OrchestratorThread::objectActuallyNotFound() //in case we lose the sight of the object while approaching it
 {
@@ -643,8 +1209,9 @@ bool OrchestratorThread::setNavigationPosition()
 /****************************************************************/
 string OrchestratorThread::getWhat()
 {
-    Bottle request{"what"};
-    return forwardRequest(request).toString();
+    Bottle what;
+    what.addString(m_gafi_mirror->getWhat());
+    return what.toString();
 }
 
 
@@ -654,17 +1221,16 @@ string OrchestratorThread::getWhere()
     if(m_status == R1_GOING)
         return m_nav2loc->getCurrentTarget();
     
-    Bottle request{"where"};
-    return forwardRequest(request).toString();
+    Bottle where;
+    where.addString(m_gafi_mirror->getWhere());
+    return where.toString();
 }
 
 
 /****************************************************************/
 string OrchestratorThread::getStatus()
 {
-    Bottle request{"status"}, reply;
-    m_goandfindit_rpc_port.write(request,reply);
-    string goAndFindItStatus = reply.get(0).asString();
+    string goAndFindItStatus = m_gafi_mirror->getStatus();
     string str;
 
     switch (m_status)
@@ -719,6 +1285,10 @@ void OrchestratorThread::info(Bottle& reply)
     Bottle& statusList=reply.addList();
     statusList.addString("status"); statusList.addString(":");
     statusList.addString(getStatus());
+
+    Bottle& queueList=reply.addList();
+    queueList.addString("queue"); queueList.addString(":");
+    m_queue->toBottle(queueList);
 }
 
 
@@ -741,6 +1311,16 @@ void OrchestratorThread::setEmotion()
 
 /****************************************************************/
 bool OrchestratorThread::askChatBotToSpeak(R1_says stat)
+{
+    //the Chat Bot and the speech queue work on their own: the search goes on while the robot speaks
+    m_chat_bot->interactAsync(saysToString(stat));
+    
+    return true;
+}
+
+
+/****************************************************************/
+string OrchestratorThread::saysToString(R1_says stat)
 {
     string str;
     switch (stat)
@@ -774,9 +1354,7 @@ bool OrchestratorThread::askChatBotToSpeak(R1_says stat)
         break;
     };
 
-    m_chat_bot->interactWithChatBot(str);    
-    
-    return true;
+    return str;
 }
 
 
@@ -794,9 +1372,8 @@ bool OrchestratorThread::go(string loc)
     
     if (loc != "home")
     {
-        Bottle req,rep;
-        req.fromString("find " + loc);
-        m_nextLoc_rpc_port.write(req,rep); //check if location name is valid
+        Bottle rep;
+        m_locations->find(loc, rep); //check if location name is valid
         if (rep.get(0).asString() != "ok")
         {
             yCError(R1OBR_ORCHESTRATOR_THREAD,"Location specified is not valid.");
@@ -828,4 +1405,210 @@ bool OrchestratorThread::dance(string dance_name)
     yCError(R1OBR_ORCHESTRATOR_THREAD,"Cannot dance now. Status should be 'idle', send a 'stop' command");
 
     return false;
-}
\ No newline at end of file
+}
+
+/****************************************************************/
+bool OrchestratorThread::verifySighting(const ContinuousSearch::Sighting& sighting)
+{
+    //the verification location needs the position of the object, and a tour to be inserted in
+    if (!sighting.has_world || m_where_specified || m_verify_distance <= 0.0)
+        return false;
+
+    Map2DLocation robot;
+    if (!m_nav2loc->getCurrentPosition(robot))
+        return false;
+
+    //too close to the object, better stop and look at it
+    double dist = sqrt(pow((sighting.x-robot.x), 2) + pow((sighting.y-robot.y), 2));
+    if (dist <= m_verify_distance)
+        return false;
+
+    string loc;
+    if (!goToVerifyLocation(sighting.label, sighting.x, sighting.y, loc))
+        return false;
+
+    yCInfo(R1OBR_ORCHESTRATOR_THREAD, "Maybe I saw a %s: I am going to have a closer look from %s", sighting.label.c_str(), loc.c_str());
+    return true;
+}
+
+
+/****************************************************************/
+bool OrchestratorThread::askMemory()
+{
+    //the object seen with the highest confidence is checked before starting the tour
+    m_recalled_loc = "";
+    if (m_where_specified || !m_memory->isActive())
+        return false;
+
+    ObjectMemory::Object best;
+    best.conf = -1.0;
+    for (const auto& what : m_objects)
+    {
+        ObjectMemory::Object obj;
+        if (m_memory->recall(what, obj) && obj.conf > best.conf)
+            best = obj;
+    }
+    if (best.conf < 0.0)
+        return false;
+
+    string loc;
+    if (!goToVerifyLocation(best.label, best.x, best.y, loc))
+        return false;
+
+    //the object is forgotten only if it is not found from there
+    m_recalled = best;
+    m_recalled_loc = loc;
+    m_recalled_searched = false;
+    yCInfo(R1OBR_ORCHESTRATOR_THREAD, "%s was seen %.0f seconds ago: I am going to have a look from %s", best.label.c_str(), Time::now() - best.time, loc.c_str());
+
+    return true;
+}
+
+
+/****************************************************************/
+void OrchestratorThread::checkRecalled(const string& goandfindit_status)
+{
+    if (m_recalled_loc == "")
+        return;
+
+    bool atLocation = m_gafi_mirror->getWhere() == m_recalled_loc;
+    if (atLocation && (goandfindit_status == "arrived" || goandfindit_status == "searching"))
+    {
+        m_recalled_searched = true;
+        return;
+    }
+
+    //the search has moved on from the verification location without finding the object
+    if (m_recalled_searched && (!atLocation || goandfindit_status == "object_not_found"))
+    {
+        m_memory->forget(m_recalled.label, m_recalled.x, m_recalled.y, m_recalled.z, m_verify_distance);
+        yCInfo(R1OBR_ORCHESTRATOR_THREAD, "%s is not where it was seen: forgotten", m_recalled.label.c_str());
+        m_recalled_loc = "";
+    }
+}
+
+
+/****************************************************************/
+void OrchestratorThread::startArchiveQuery()
+{
+    //the keyframe archive is optional
+    if (m_where_specified || m_keyframe_archive_rpc_port.getOutputCount() == 0)
+        return;
+
+    //the query of a previous search is not waited for
+    if (m_archive_query.valid() && m_archive_query.wait_for(chrono::seconds(0)) != future_status::ready)
+    {
+        yCWarning(R1OBR_ORCHESTRATOR_THREAD, "The keyframe archive is still busy: it will not be checked for this search");
+        return;
+    }
+
+    m_archive_query = async(launch::async, &OrchestratorThread::askArchive, this, m_objects, m_search_count);
+}
+
+
+/****************************************************************/
+OrchestratorThread::ArchiveNomination OrchestratorThread::askArchive(vector<string> objects, int search)
+{
+    ArchiveNomination best;
+    best.search = search;
+    best.confidence = -1.0;
+    for (const auto& what : objects)
+    {
+        Bottle req, rep;
+        req.addString("query");
+        req.addString(what);
+        if (!m_keyframe_archive_rpc_port.write(req,rep) || !rep.get(0).isList())
+        {
+            yCWarning(R1OBR_ORCHESTRATOR_THREAD, "The keyframe archive cannot be queried for %s", what.c_str());
+            continue;
+        }
+
+        //the nominations are sorted by confidence: (<x> <y> <theta> <confidence> <time> <n_keyframes>)
+        Bottle* nomination = rep.get(0).asList()->get(0).asList();
+        if (nomination && nomination->get(3).asFloat64() > best.confidence)
+        {
+            best.confidence = nomination->get(3).asFloat64();
+            best.label = what;
+            best.pose.x = nomination->get(0).asFloat64();
+            best.pose.y = nomination->get(1).asFloat64();
+            best.pose.theta = nomination->get(2).asFloat64();
+        }
+    }
+
+    return best;
+}
+
+
+/****************************************************************/
+void OrchestratorThread::checkArchive()
+{
+    if (!m_archive_query.valid() || m_archive_query.wait_for(chrono::seconds(0)) != future_status::ready)
+        return;
+
+    //the robot has kept searching in the meantime: the nomination becomes the next place to check
+    ArchiveNomination nomination = m_archive_query.get();
+    if (nomination.search != m_search_count || nomination.confidence < 0.0)
+        return;
+
+    string loc;
+    if (goToVerifyPose(nomination.label, nomination.pose, loc))
+    {
+        m_telemetry->increment("archive_nominations");
+        yCInfo(R1OBR_ORCHESTRATOR_THREAD, "%s has been seen in the archive: I am going to have a look from %s", nomination.label.c_str(), loc.c_str());
+    }
+}
+
+
+/****************************************************************/
+bool OrchestratorThread::goToVerifyLocation(const string& label, double x, double y, string& loc)
+{
+    Map2DLocation robot;
+    if (!m_nav2loc->getCurrentPosition(robot))
+        return false;
+
+    //on the line connecting robot to object, facing the object
+    double alfa_rad = atan2((y-robot.y), (x-robot.x));
+    Map2DLocation pose;
+    pose.x = x - m_verify_distance*cos(alfa_rad);
+    pose.y = y - m_verify_distance*sin(alfa_rad);
+    pose.theta = alfa_rad / M_PI * 180;
+
+    return goToVerifyPose(label, pose, loc);
+}
+
+
+/****************************************************************/
+bool OrchestratorThread::goToVerifyPose(const string& label, const Map2DLocation& pose, string& loc)
+{
+    string name = label;
+    replace(name.begin(), name.end(), ' ', '_');
+    loc = m_map_prefix + "verify_" + name + "_" + to_string(++m_verify_count);
+
+    Bottle req, rep;
+    req.addString("verify");
+    req.addString(loc);
+    req.addFloat64(pose.x);
+    req.addFloat64(pose.y);
+    req.addFloat64(pose.theta);
+    if (!m_nextLoc_rpc_port.write(req,rep) || rep.get(0).asString() != loc + " added")
+    {
+        yCWarning(R1OBR_ORCHESTRATOR_THREAD, "Cannot add the verification location %s", loc.c_str());
+        return false;
+    }
+
+    //goAndFindIt goes there before the location it is navigating to
+    Bottle detour;
+    detour.addString("verify");
+    detour.addString(loc);
+    if (forwardRequest(detour).get(0).asString() != "going to '" + loc + "'")
+    {
+        //goAndFindIt is not searching anymore
+        req.clear();
+        req.addString("remove");
+        req.addString(loc);
+        m_nextLoc_rpc_port.write(req,rep);
+        return false;
+    }
+
+    return true;
+}
@@ -20,10 +20,18 @@
 #define R1OBR_ORCHESTRATOR_THREAD_H
 
 #include <yarp/os/all.h>
+#include <vector>
+#include <algorithm>
+#include <future>
 #include "nav2loc.h"
 #include "continuousSearch.h"
+#include "objectMemory.h"
 #include "chatBot.h"
 #include "tinyDancer.h"
+#include "searchTelemetry.h"
+#include "goAndFindItMirror.h"
+#include "locationCatalogue.h"
+#include "requestQueue.h"
 
 using namespace yarp::os;
 using namespace std;
@@ -66,26 +74,58 @@ private:
     string                  m_nextLoc_rpc_port_name;
     RpcClient               m_nextLoc_rpc_port;
 
+    //replica of the locations of nextLocPlanner
+    LocationCatalogue*      m_locations{nullptr};
+
     string                  m_goandfindit_rpc_port_name;
     RpcClient               m_goandfindit_rpc_port;
 
     string                  m_goandfindit_result_port_name;
     BufferedPort<Bottle>    m_goandfindit_result_port;
 
+    //state of goAndFindIt, received from its status port
+    GoAndFindItMirror*      m_gafi_mirror{nullptr};
+
     string                  m_positive_outcome_port_name;
     BufferedPort<Bottle>    m_positive_outcome_port;
 
     string                  m_negative_outcome_port_name;
     BufferedPort<Bottle>    m_negative_outcome_port;
 
+    //objects found during a multi-object search
+    string                  m_found_objects_port_name;
+    BufferedPort<Bottle>    m_found_objects_port;
+
     string                  m_faceexpression_rpc_port_name;
     RpcClient               m_faceexpression_rpc_port;
 
+    //the archive of the frames seen by the camera, optional, queried in background while the robot moves
+    struct ArchiveNomination
+    {
+        int             search;         //the search the query has been made for
+        string          label;
+        Map2DLocation   pose;
+        double          confidence;     //negative if nothing has been nominated
+    };
+    string                  m_keyframe_archive_rpc_port_name;
+    RpcClient               m_keyframe_archive_rpc_port;
+    future<ArchiveNomination> m_archive_query;
+    int                     m_search_count;
+
     //Navigator to Home location
     Nav2Loc*                m_nav2loc;
 
     //Continuous Search thread
     ContinuousSearch*       m_continuousSearch;
+    double                  m_verify_distance;  //distance from the object of the verification locations
+    int                     m_verify_count;
+
+    //where the objects have been seen
+    ObjectMemory*           m_memory{nullptr};
+    //the object recalled by the memory for the current search, forgotten if not found at its verification location
+    ObjectMemory::Object    m_recalled;
+    string                  m_recalled_loc;
+    bool                    m_recalled_searched{false};
 
     //Chat Bot
     ChatBot*                m_chat_bot;
@@ -93,9 +133,16 @@ private:
     //TinyDancer
     TinyDancer*             m_tiny_dancer;
 
+    //Telemetry
+    SearchTelemetry*        m_telemetry{nullptr};
+    double                  m_search_start;
+
     // Others
     R1_status               m_status;
     string                  m_object;
+    vector<string>          m_objects;          //objects still to be found
+    bool                    m_multi;            //more objects searched in the same tour
+    string                  m_sighted;          //object seen while navigating
     Bottle                  m_request;
     Bottle                  m_result;
     bool                    m_where_specified;
@@ -104,6 +151,31 @@ private:
     bool                    m_going;
     string                  m_map_prefix;
 
+    //Request scheduling
+    struct Task
+    {
+        RequestQueue::Request   request;
+        bool                    restart{false};     //goAndFindIt has been used by another search meanwhile
+        //state of the orchestrator when the task has been interrupted
+        string                  object;
+        vector<string>          objects;
+        bool                    multi{false};
+        bool                    where_specified{false};
+        bool                    object_found{false};
+        bool                    object_not_found{false};
+        bool                    going{false};
+        Bottle                  search_request;
+        Bottle                  result;
+        double                  search_start{0.0};
+    };
+    RequestQueue*           m_queue{nullptr};
+    mutex                   m_sched_mutex;
+    bool                    m_has_task;
+    Task                    m_task;             //request being executed
+    vector<Task>            m_suspended;        //interrupted requests, the last one is resumed first
+    vector<string>          m_merged_goes;      //"go" requests merged in the current search
+    bool                    m_hold;             //stopped by the user: nothing starts until a resume or a new request
+
     ResourceFinder&         m_rf;
 
 public:
@@ -122,14 +194,19 @@ public:
     void onRead(Bottle& b) override;
 
     Bottle      forwardRequest(const Bottle& b);
+    string      submit(const Bottle& request);
+    string      userStopOrReset(const string& cmd);
     void        search(const Bottle& btl);
     bool        resizeSearchBottle(const Bottle& btl);
     bool        askNetwork();
     string      stopOrReset(const string& cmd);
     string      resetHome();
     string      resume();
+    string      resumeActivity();
     void        objectFound();
     void        objectActuallyNotFound();
+    void        multiObjectFound(const Bottle& result, Stamp& stamp);
+    void        allObjectsFound();
     
     void        setObject(string obj);
     bool        setNavigationPosition();
@@ -141,11 +218,30 @@ public:
     void        setEmotion();
     
     bool        askChatBotToSpeak(R1_says stat);
+    string      saysToString(R1_says stat);
 
     bool        go(string loc);
 
     bool        dance(string dance_name);
 
+private:
+    void        schedule();
+    bool        isTaskFinished();
+    void        startTask(const RequestQueue::Request& req);
+    void        completeTask();
+    void        suspendTask();
+    void        resumeTask(Task& task);
+    bool        mergeRequest(const RequestQueue::Request& req);
+    void        checkMergedGoes(const string& goandfindit_status);
+    bool        verifySighting(const ContinuousSearch::Sighting& sighting);
+    bool        askMemory();
+    void        checkRecalled(const string& goandfindit_status);
+    void        startArchiveQuery();
+    ArchiveNomination askArchive(vector<string> objects, int search);
+    void        checkArchive();
+    bool        goToVerifyLocation(const string& label, double x, double y, string& loc);
+    bool        goToVerifyPose(const string& label, const Map2DLocation& pose, string& loc);
+
 };
 
 #endif
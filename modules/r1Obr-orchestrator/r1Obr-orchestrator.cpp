@@ -23,7 +23,8 @@ YARP_LOG_COMPONENT(R1OBR_ORCHESTRATOR, "r1_obr.orchestrator")
 
 
 Orchestrator::Orchestrator() :
-    m_period(1.0)
+    m_period(1.0),
+    m_speech_queue(nullptr)
 {  
     m_rpc_server_port_name  = "/r1Obr-orchestrator/rpc";
     m_input_port_name = "/r1Obr-orchestrator/input:i";
@@ -112,6 +113,13 @@ bool Orchestrator::configure(ResourceFinder &rf)
         return false;
     }
 
+    m_speech_queue = new SpeechQueue(m_additional_speaker, m_audiorecorderRPCPort, m_audioPlayPort);
+    if(!m_speech_queue->configure(rf))
+    {
+        yCError(R1OBR_ORCHESTRATOR,"SpeechQueue configuration failed");
+        return false;
+    }
+
     // --------- Story Teller --------- //
     m_story_teller = new StoryTeller();
     if(!m_story_teller->configure(rf))
@@ -127,6 +135,12 @@ bool Orchestrator::configure(ResourceFinder &rf)
 /****************************************************************/
 bool Orchestrator::close()
 {
+    if (m_speech_queue)
+    {
+        m_speech_queue->close();
+        delete m_speech_queue;
+    }
+
     if (m_rpc_server_port.asPort().isOpen())
         m_rpc_server_port.close();  
         
@@ -197,6 +211,7 @@ bool Orchestrator::respond(const Bottle &request, Bottle &reply)
             reply.addString("help   : gets this list");
             reply.addString("search <what> : starts to search for 'what'");
             reply.addString("search <what> <where>: starts searching for 'what' at location 'where'");
+            reply.addString("search (<what1> <what2> ...) [<where>]: searches for all the objects in the same tour");
             reply.addString("stop   : stops search");
             reply.addString("reset  : resets search");
             reply.addString("reset_home: resets search and navigates the robot home");
@@ -218,7 +233,7 @@ bool Orchestrator::respond(const Bottle &request, Bottle &reply)
         }
         else if (cmd=="stop" || cmd=="reset")
         {
-            reply.addString(m_inner_thread->stopOrReset(cmd));
+            reply.addString(m_inner_thread->userStopOrReset(cmd));
         }
         else if (cmd=="reset_home")
         {
@@ -256,9 +271,12 @@ bool Orchestrator::respond(const Bottle &request, Bottle &reply)
     }
     else if (cmd=="search")
     {
-        m_inner_thread->search(request);
-        m_inner_thread->setObject(request.get(1).asString());
-        reply.addString("searching for '" + request.get(1).asString() + "'");
+        string what = request.get(1).isList() ? request.get(1).asList()->toString() : request.get(1).asString();
+        string outcome = m_inner_thread->submit(request);
+        if (outcome == "started")
+            reply.addString("searching for '" + what + "'");
+        else
+            reply.addString("search for '" + what + "' " + outcome);
     }
     else if (cmd=="say")
     {   
@@ -268,17 +286,28 @@ bool Orchestrator::respond(const Bottle &request, Bottle &reply)
     }
     else if (cmd=="go")
     {   
-        string location_name = request.get(1).asString();;
-        m_inner_thread->go(location_name);
-        reply.addString("going to '" + location_name + "'");
+        string location_name = request.get(1).asString();
+        string outcome = m_inner_thread->submit(request);
+        if (outcome == "started")
+            reply.addString("going to '" + location_name + "'");
+        else
+            reply.addString("go to '" + location_name + "' " + outcome);
     }
     else if (cmd=="tell")
     {   
-        string story;
+        //each sentence is played as soon as it is synthesized, while the next ones are being synthesized
+        vector<string> sentences;
         string story_key = request.get(1).asString();
-        m_story_teller->getStory(story_key, story);
-        reply.addString("Telling the story");
-        say(story);
+        if (m_story_teller->getSentences(story_key, sentences))
+        {
+            reply.addString("Telling the story");
+            for (auto& sentence : sentences)
+                say(sentence);
+        }
+        else
+        {
+            reply.addString("Story '" + story_key + "' not found");
+        }
     }
     else if (cmd=="dance")
     {   
@@ -319,31 +348,6 @@ void Orchestrator::onRead(yarp::os::Bottle &b)
 /****************************************************************/
 bool Orchestrator::say(string toSay)
 {
-    //close microphone
-    Bottle req{"stopRecording_RPC"}, rep;
-    m_audiorecorderRPCPort.write(req,rep);
-
-    //speak
-    bool ret = m_additional_speaker->say(toSay);
-    
-
-    //wait until finish speaking
-    Time::delay(0.5);
-    bool audio_is_playing{true};
-    while (audio_is_playing) 
-    {
-        Bottle* player_status = m_audioPlayPort.read(false);
-        if (player_status)
-        {
-            audio_is_playing = player_status->get(1).asInt64() > 0;
-        }
-        Time::delay(0.1);
-    }
-
-    //re-open microphone
-    req.clear(); rep.clear();
-    req.addString("startRecording_RPC");
-    m_audiorecorderRPCPort.write(req,rep);
-
-    return ret;
+    //the RPC reply is not delayed until the end of the sentence
+    return m_speech_queue->say(toSay);
 }
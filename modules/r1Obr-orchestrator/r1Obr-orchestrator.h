@@ -24,6 +24,7 @@
 
 #include "orchestratorThread.h"
 #include "speechSynthesizer.h"
+#include "speechQueue.h"
 #include "storyTeller.h"
 
 using namespace yarp::os;
@@ -63,6 +64,7 @@ private:
     double                      m_period;
     RpcClient                   m_audiorecorderRPCPort;
     BufferedPort<Bottle>        m_audioPlayPort;
+    SpeechQueue*                m_speech_queue;
 
 public:
     Orchestrator();
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "requestQueue.h"
+
+
+YARP_LOG_COMPONENT(REQUEST_QUEUE, "r1_obr.orchestrator.requestQueue")
+
+
+/****************************************************************/
+RequestQueue::RequestQueue() :
+    m_enabled(true),
+    m_preemption(true),
+    m_max_size(10)
+{
+    m_priorities["search"] = 1;
+    m_priorities["go"] = 2;
+}
+
+
+/****************************************************************/
+bool RequestQueue::configure(ResourceFinder& rf)
+{
+    if(!rf.check("REQUEST_QUEUE"))
+    {
+        yCWarning(REQUEST_QUEUE,"REQUEST_QUEUE section missing in ini file. Using the default values");
+    }
+    Searchable& config = rf.findGroup("REQUEST_QUEUE");
+    m_enabled = config.check("enabled") ? config.find("enabled").asString() != "false" : true;
+    m_preemption = config.check("preemption") ? config.find("preemption").asString() != "false" : true;
+    if (config.check("max_size"))           {m_max_size = config.find("max_size").asInt32();}
+    if (config.check("search_priority"))    {m_priorities["search"] = config.find("search_priority").asInt32();}
+    if (config.check("go_priority"))        {m_priorities["go"] = config.find("go_priority").asInt32();}
+
+    if (m_enabled)
+        yCInfo(REQUEST_QUEUE, "Request queue enabled: search priority %d, go priority %d, pre-emption %s", 
+                m_priorities["search"], m_priorities["go"], m_preemption ? "on" : "off");
+
+    return true;
+}
+
+
+/****************************************************************/
+bool RequestQueue::isEnabled()
+{
+    return m_enabled;
+}
+
+
+/****************************************************************/
+bool RequestQueue::preemptionEnabled()
+{
+    return m_preemption;
+}
+
+
+/****************************************************************/
+RequestQueue::Request RequestQueue::makeRequest(const Bottle& cmd)
+{
+    Request req;
+    req.cmd = cmd;
+    req.time = Time::now();
+    auto it = m_priorities.find(cmd.get(0).asString());
+    req.priority = it != m_priorities.end() ? it->second : 0;
+    return req;
+}
+
+
+/****************************************************************/
+bool RequestQueue::push(const Request& req)
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_queue.size() >= m_max_size)
+    {
+        yCWarning(REQUEST_QUEUE, "Queue full, request discarded: %s", req.cmd.toString().c_str());
+        return false;
+    }
+
+    auto it = m_queue.begin();
+    while (it != m_queue.end() && it->priority >= req.priority)
+        it++;
+    m_queue.insert(it, req);
+    yCInfo(REQUEST_QUEUE, "Request queued: %s (%d requests waiting)", req.cmd.toString().c_str(), (int)m_queue.size());
+
+    return true;
+}
+
+
+/****************************************************************/
+bool RequestQueue::pop(Request& req)
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_queue.empty())
+        return false;
+
+    req = m_queue.front();
+    m_queue.pop_front();
+    return true;
+}
+
+
+/****************************************************************/
+int RequestQueue::topPriority()
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_queue.empty() ? -1 : m_queue.front().priority;
+}
+
+
+/****************************************************************/
+bool RequestQueue::empty()
+{
+    lock_guard<mutex> lock(m_mutex);
+    return m_queue.empty();
+}
+
+
+/****************************************************************/
+void RequestQueue::clear()
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_queue.empty())
+        yCInfo(REQUEST_QUEUE, "%d queued requests discarded", (int)m_queue.size());
+    m_queue.clear();
+}
+
+
+/****************************************************************/
+void RequestQueue::toBottle(Bottle& b)
+{
+    lock_guard<mutex> lock(m_mutex);
+    for (const auto& req : m_queue)
+        b.addList() = req.cmd;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef REQUEST_QUEUE_H
+#define REQUEST_QUEUE_H
+
+#include <yarp/os/all.h>
+#include <deque>
+#include <map>
+#include <mutex>
+
+using namespace yarp::os;
+using namespace std;
+
+// Requests ("search", "go") waiting to be executed by the orchestrator.
+// They are kept ordered by priority, and by arrival time among requests with the same priority.
+// The priorities and the pre-emption are read from the REQUEST_QUEUE group of the .ini file.
+class RequestQueue
+{
+public:
+    struct Request
+    {
+        Bottle      cmd;
+        int         priority{0};
+        double      time{0.0};
+    };
+
+private:
+    bool                    m_enabled;
+    bool                    m_preemption;
+    size_t                  m_max_size;
+    map<string,int>         m_priorities;
+    deque<Request>          m_queue;
+    mutex                   m_mutex;
+
+public:
+    RequestQueue();
+    ~RequestQueue() = default;
+
+    bool configure(ResourceFinder& rf);
+
+    bool isEnabled();
+    bool preemptionEnabled();
+
+    Request makeRequest(const Bottle& cmd);
+    bool push(const Request& req);
+    bool pop(Request& req);
+    int  topPriority();         //priority of the first request, -1 if the queue is empty
+    bool empty();
+    void clear();
+    void toBottle(Bottle& b);   //the queued commands, in order of execution
+};
+
+#endif
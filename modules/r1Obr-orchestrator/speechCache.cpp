@@ -0,0 +1,321 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "speechCache.h"
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <iterator>
+#include <sys/stat.h>
+#include <dirent.h>
+
+YARP_LOG_COMPONENT(SPEECH_CACHE, "r1_obr.orchestrator.speechCache")
+
+
+// ------------------------------------------------------ //
+SpeechCache::SpeechCache() :
+    m_max_entries(50),
+    m_dir(""),
+    m_disk_max_entries(500),
+    m_disk_max_bytes(100*1024*1024),
+    m_disk_bytes(0),
+    m_hits(0),
+    m_misses(0)
+{
+}
+
+
+// ------------------------------------------------------ //
+bool SpeechCache::configure(Searchable& config)
+{
+    if(config.check("cache_size")) m_max_entries = config.find("cache_size").asInt32();
+    if(config.check("cache_dir")) m_dir = config.find("cache_dir").asString();
+    if(config.check("cache_disk_size")) m_disk_max_entries = config.find("cache_disk_size").asInt32();
+    if(config.check("cache_disk_mb")) m_disk_max_bytes = (size_t)(config.find("cache_disk_mb").asFloat64()*1024*1024);
+
+    if (m_disk_max_entries == 0)
+        m_dir = "";
+
+    if (m_dir != "" && yarp::os::mkdir_p(m_dir.c_str()) != 0 && yarp::os::stat(m_dir.c_str()) != 0)
+    {
+        yCWarning(SPEECH_CACHE) << "Cannot create the directory" << m_dir << ". The sounds will be kept in memory only";
+        m_dir = "";
+    }
+
+    if (m_dir != "")
+    {
+        lock_guard<mutex> lock(m_mutex);
+        loadDiskIndex();
+        evictDisk();
+        saveDiskIndex();
+    }
+
+    yCInfo(SPEECH_CACHE, "Speech cache: %d sounds in memory, %s", (int)m_max_entries, m_dir == "" ? "no disk cache" : ("disk cache in " + m_dir).c_str());
+    if (m_dir != "")
+        yCInfo(SPEECH_CACHE, "Disk cache: %d sounds (%.1f MB), at most %d sounds and %.1f MB", (int)m_disk_lru.size(), m_disk_bytes/1048576.0, (int)m_disk_max_entries, m_disk_max_bytes/1048576.0);
+
+    return true;
+}
+
+
+// ------------------------------------------------------ //
+string SpeechCache::makeKey(const string& text, const string& language, const string& voice, double pitch, double speed)
+{
+    ostringstream key;
+    key << language << "|" << voice << "|" << pitch << "|" << speed << "|" << text;
+    return key.str();
+}
+
+
+// ------------------------------------------------------ //
+bool SpeechCache::get(const string& key, Sound& sound)
+{
+    lock_guard<mutex> lock(m_mutex);
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        sound = it->second->second;
+        if (m_dir != "")
+            touchDisk(fileName(key), 0);
+        m_hits++;
+        return true;
+    }
+
+    if (load(key, sound))
+    {
+        insert(key, sound);
+        m_hits++;
+        return true;
+    }
+
+    m_misses++;
+    yCDebug(SPEECH_CACHE, "Cache miss (%d hits, %d misses)", m_hits, m_misses);
+    return false;
+}
+
+
+// ------------------------------------------------------ //
+void SpeechCache::put(const string& key, const Sound& sound)
+{
+    lock_guard<mutex> lock(m_mutex);
+    insert(key, sound);
+    save(key, sound);
+}
+
+
+// ------------------------------------------------------ //
+bool SpeechCache::contains(const string& key)
+{
+    lock_guard<mutex> lock(m_mutex);
+    if (m_index.find(key) != m_index.end())
+        return true;
+    return m_dir != "" && m_disk_index.find(fileName(key)) != m_disk_index.end();
+}
+
+
+// ------------------------------------------------------ //
+void SpeechCache::insert(const string& key, const Sound& sound)
+{
+    if (m_max_entries == 0)
+        return;
+
+    auto it = m_index.find(key);
+    if (it != m_index.end())
+    {
+        it->second->second = sound;
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        return;
+    }
+
+    m_lru.emplace_front(key, sound);
+    m_index[key] = m_lru.begin();
+
+    while (m_lru.size() > m_max_entries)
+    {
+        m_index.erase(m_lru.back().first);
+        m_lru.pop_back();
+    }
+}
+
+
+// ------------------------------------------------------ //
+string SpeechCache::fileName(const string& key)
+{
+    ostringstream name;
+    name << m_dir << "/" << hex << hash<string>{}(key);
+    return name.str();
+}
+
+
+// ------------------------------------------------------ //
+bool SpeechCache::load(const string& key, Sound& sound)
+{
+    if (m_dir == "")
+        return false;
+
+    //the key is saved next to the sound, in case two keys have the same hash
+    string name = fileName(key);
+    ifstream keyFile(name + ".key");
+    if (!keyFile.is_open())
+        return false;
+    string savedKey((istreambuf_iterator<char>(keyFile)), istreambuf_iterator<char>());
+    if (savedKey != key)
+        return false;
+
+    if (!yarp::sig::file::read(sound, (name + ".wav").c_str()))
+        return false;
+
+    touchDisk(name, 0);
+    return true;
+}
+
+
+// ------------------------------------------------------ //
+void SpeechCache::save(const string& key, const Sound& sound)
+{
+    if (m_dir == "")
+        return;
+
+    //written with a temporary name, so that a sound is never read while being written
+    string name = fileName(key);
+    string tmp = name + ".tmp.wav";
+    if (!yarp::sig::file::write(sound, tmp.c_str()))
+    {
+        yCWarning(SPEECH_CACHE) << "Cannot write" << tmp;
+        return;
+    }
+    ofstream keyFile(name + ".key", ios::trunc);
+    keyFile << key;
+    keyFile.close();
+    ifstream wav(tmp, ios::binary | ios::ate);
+    size_t bytes = wav.is_open() ? (size_t)wav.tellg() : 0;
+    wav.close();
+    std::rename(tmp.c_str(), (name + ".wav").c_str());
+
+    touchDisk(name, bytes);
+}
+
+
+// ------------------------------------------------------ //
+void SpeechCache::touchDisk(const string& name, size_t bytes)
+{
+    //bytes == 0 keeps the size already known
+    auto it = m_disk_index.find(name);
+    if (it != m_disk_index.end())
+    {
+        if (bytes == 0 && it->second == m_disk_lru.begin())
+            return;
+        if (bytes != 0)
+        {
+            m_disk_bytes -= it->second->second;
+            it->second->second = bytes;
+            m_disk_bytes += bytes;
+        }
+        m_disk_lru.splice(m_disk_lru.begin(), m_disk_lru, it->second);
+    }
+    else
+    {
+        if (bytes == 0)     //not on disk anymore
+            return;
+        m_disk_lru.emplace_front(name, bytes);
+        m_disk_index[name] = m_disk_lru.begin();
+        m_disk_bytes += bytes;
+    }
+
+    evictDisk();
+    saveDiskIndex();
+}
+
+
+// ------------------------------------------------------ //
+void SpeechCache::evictDisk()
+{
+    //the most recent sound is kept even if it is larger than the limit
+    while (m_disk_lru.size() > 1 && (m_disk_lru.size() > m_disk_max_entries || m_disk_bytes > m_disk_max_bytes))
+    {
+        const DiskEntry& oldest = m_disk_lru.back();
+        std::remove((oldest.first + ".wav").c_str());
+        std::remove((oldest.first + ".key").c_str());
+        yCDebug(SPEECH_CACHE) << "Removed" << oldest.first << "from the disk cache";
+        m_disk_bytes -= oldest.second;
+        m_disk_index.erase(oldest.first);
+        m_disk_lru.pop_back();
+    }
+}
+
+
+// ------------------------------------------------------ //
+void SpeechCache::loadDiskIndex()
+{
+    //one line per sound, most recently used first: <file name> <bytes>
+    m_disk_lru.clear();
+    m_disk_index.clear();
+    m_disk_bytes = 0;
+
+    ifstream index(m_dir + "/index");
+    string base;
+    size_t bytes;
+    while (index >> base >> bytes)
+    {
+        string name = m_dir + "/" + base;
+        struct stat info;
+        if (m_disk_index.find(name) != m_disk_index.end() || ::stat((name + ".wav").c_str(), &info) != 0)
+            continue;
+        m_disk_lru.emplace_back(name, (size_t)info.st_size);
+        m_disk_index[name] = prev(m_disk_lru.end());
+        m_disk_bytes += (size_t)info.st_size;
+    }
+
+    //sounds missing from the index (e.g. left by an interrupted run) are the first to be removed
+    DIR* d = opendir(m_dir.c_str());
+    if (!d)
+        return;
+    while (dirent* entry = readdir(d))
+    {
+        string file = entry->d_name;
+        if (file.size() <= 4 || file.substr(file.size() - 4) != ".wav")
+            continue;
+        string name = m_dir + "/" + file.substr(0, file.size() - 4);
+        if (file.size() > 8 && file.substr(file.size() - 8) == ".tmp.wav")
+        {
+            std::remove((m_dir + "/" + file).c_str());
+            continue;
+        }
+        struct stat info;
+        if (m_disk_index.find(name) != m_disk_index.end() || ::stat((name + ".wav").c_str(), &info) != 0)
+            continue;
+        m_disk_lru.emplace_back(name, (size_t)info.st_size);
+        m_disk_index[name] = prev(m_disk_lru.end());
+        m_disk_bytes += (size_t)info.st_size;
+    }
+    closedir(d);
+}
+
+
+// ------------------------------------------------------ //
+void SpeechCache::saveDiskIndex()
+{
+    string name = m_dir + "/index";
+    ofstream index(name + ".tmp", ios::trunc);
+    for (const auto& entry : m_disk_lru)
+        index << entry.first.substr(m_dir.size() + 1) << " " << entry.second << "\n";
+    index.close();
+    std::rename((name + ".tmp").c_str(), name.c_str());
+}
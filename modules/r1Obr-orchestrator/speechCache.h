@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef SPEECH_CACHE_H
+#define SPEECH_CACHE_H
+
+#include <yarp/os/all.h>
+#include <yarp/sig/Sound.h>
+#include <yarp/sig/SoundFile.h>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace std;
+
+// Cache of the synthesized sentences, so that a sentence already said is played without
+// asking the speech synthesizer again.
+// The key is made of the text and of the language, voice, pitch and speed of the synthesizer.
+// The most recently used sounds are kept in memory (LRU) and are also saved in "cache_dir"
+// as wav files, so that they survive a restart of the module. The disk cache is LRU too: it
+// is bounded by "cache_disk_size" sounds and "cache_disk_mb" megabytes, and its order is kept
+// in an index file in "cache_dir".
+class SpeechCache
+{
+private:
+    using Entry = pair<string, Sound>;
+    using DiskEntry = pair<string, size_t>;                 //file name and bytes
+
+    size_t                                      m_max_entries;
+    string                                      m_dir;
+    list<Entry>                                 m_lru;      //most recently used first
+    unordered_map<string, list<Entry>::iterator> m_index;
+    size_t                                      m_disk_max_entries;
+    size_t                                      m_disk_max_bytes;
+    size_t                                      m_disk_bytes;
+    list<DiskEntry>                             m_disk_lru; //most recently used first
+    unordered_map<string, list<DiskEntry>::iterator> m_disk_index;
+    mutex                                       m_mutex;
+
+    int                                         m_hits;
+    int                                         m_misses;
+
+public:
+    SpeechCache();
+    ~SpeechCache() = default;
+
+    //reads "cache_size", "cache_dir", "cache_disk_size" and "cache_disk_mb" from the given group
+    bool configure(Searchable& config);
+
+    static string makeKey(const string& text, const string& language, const string& voice, double pitch, double speed);
+
+    bool get(const string& key, Sound& sound);
+    void put(const string& key, const Sound& sound);
+    bool contains(const string& key);
+
+private:
+    void   insert(const string& key, const Sound& sound);   //memory only
+    string fileName(const string& key);
+    bool   load(const string& key, Sound& sound);
+    void   save(const string& key, const Sound& sound);
+    void   touchDisk(const string& name, size_t bytes);
+    void   evictDisk();
+    void   loadDiskIndex();
+    void   saveDiskIndex();
+};
+
+#endif
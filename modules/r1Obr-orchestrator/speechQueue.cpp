@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "speechQueue.h"
+
+YARP_LOG_COMPONENT(SPEECH_QUEUE, "r1_obr.orchestrator.speechQueue")
+
+
+// ------------------------------------------------------ //
+SpeechQueue::SpeechQueue(SpeechSynthesizer* speaker, RpcClient& microphone, BufferedPort<Bottle>& playerStatus) :
+    m_speaker(speaker),
+    m_microphone(microphone),
+    m_playerStatus(playerStatus),
+    m_synthesisWorker(*this, true),
+    m_playbackWorker(*this, false),
+    m_synthesizing(false),
+    m_stopping(false),
+    m_prefetch(2),
+    m_start_timeout(1.0),
+    m_poll_period(0.05)
+{
+}
+
+
+// ------------------------------------------------------ //
+bool SpeechQueue::configure(ResourceFinder &rf)
+{
+    Searchable& config = rf.findGroup("SPEECH_SYNTHESIZER");
+    if(config.check("prefetch"))                {m_prefetch = (size_t)max(1, config.find("prefetch").asInt32());}
+    if(config.check("playback_start_timeout"))  {m_start_timeout = config.find("playback_start_timeout").asFloat64();}
+
+    if(!m_synthesisWorker.start() || !m_playbackWorker.start())
+    {
+        yCError(SPEECH_QUEUE, "Cannot start the speech workers");
+        return false;
+    }
+
+    return true;
+}
+
+
+// ------------------------------------------------------ //
+void SpeechQueue::close()
+{
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_cv.notify_all();
+
+    m_synthesisWorker.stop();
+    m_playbackWorker.stop();
+}
+
+
+// ------------------------------------------------------ //
+bool SpeechQueue::say(const string& sentence)
+{
+    if(!m_speaker->isActive())
+        return false;
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_texts.push_back(sentence);
+    }
+    m_cv.notify_all();
+
+    return true;
+}
+
+
+// ------------------------------------------------------ //
+void SpeechQueue::synthesisLoop()
+{
+    while(true)
+    {
+        Utterance utterance;
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_cv.wait(lock, [&]{ return m_stopping || (!m_texts.empty() && m_sounds.size() < m_prefetch); });
+            if(m_stopping)
+                return;
+            utterance.text = m_texts.front();
+            m_texts.pop_front();
+            m_synthesizing = true;
+        }
+
+        bool ok = m_speaker->synthesize(utterance.text, utterance.sound);
+        if(!ok)
+            yCError(SPEECH_QUEUE, "Some error occurred synthesizing: %s", utterance.text.c_str());
+
+        {
+            lock_guard<mutex> lock(m_mutex);
+            m_synthesizing = false;
+            if(ok)
+                m_sounds.push_back(move(utterance));
+        }
+        m_cv.notify_all();
+    }
+}
+
+
+// ------------------------------------------------------ //
+void SpeechQueue::playbackLoop()
+{
+    bool speaking = false;
+
+    while(true)
+    {
+        Utterance utterance;
+        {
+            unique_lock<mutex> lock(m_mutex);
+            m_cv.wait(lock, [&]{ 
+                return m_stopping || !m_sounds.empty() || (speaking && m_texts.empty() && !m_synthesizing); });
+            if(m_stopping)
+                break;
+
+            if(m_sounds.empty())
+            {
+                //nothing else to say
+                lock.unlock();
+                setMicrophone(true);
+                speaking = false;
+                continue;
+            }
+
+            utterance = move(m_sounds.front());
+            m_sounds.pop_front();
+        }
+        m_cv.notify_all();      //there is room for the next sound to be synthesized
+
+        if(!speaking)
+        {
+            setMicrophone(false);
+            speaking = true;
+        }
+
+        yCInfo(SPEECH_QUEUE, "Saying: %s", utterance.text.c_str());
+        m_speaker->play(utterance.text, utterance.sound);
+        waitPlaybackEnd();
+    }
+
+    if(speaking)
+        setMicrophone(true);
+}
+
+
+// ------------------------------------------------------ //
+void SpeechQueue::waitPlaybackEnd()
+{
+    //the player reports the samples still to be played: the sound is over when,
+    //after having been played, there is nothing left
+    double start = Time::now();
+    bool started = false;
+    while(true)
+    {
+        {
+            lock_guard<mutex> lock(m_mutex);
+            if(m_stopping)
+                return;
+        }
+
+        Bottle* player_status = m_playerStatus.read(false);
+        if(player_status)
+        {
+            bool audio_is_playing = player_status->get(1).asInt64() > 0;
+            if(audio_is_playing)
+                started = true;
+            else if(started)
+                return;
+        }
+
+        if(!started && Time::now() - start > m_start_timeout)
+            return;
+
+        Time::delay(m_poll_period);
+    }
+}
+
+
+// ------------------------------------------------------ //
+void SpeechQueue::setMicrophone(bool on)
+{
+    Bottle req, rep;
+    req.addString(on ? "startRecording_RPC" : "stopRecording_RPC");
+    m_microphone.write(req,rep);
+}
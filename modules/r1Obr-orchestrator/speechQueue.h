@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef SPEECH_QUEUE_H
+#define SPEECH_QUEUE_H
+
+#include <yarp/os/all.h>
+#include <yarp/sig/Sound.h>
+#include <deque>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include "speechSynthesizer.h"
+
+using namespace yarp::os;
+using namespace yarp::sig;
+using namespace std;
+
+// Sentences to be said by the robot. say() returns immediately: a worker synthesizes the
+// sentences while another one plays them, so the next sentence is ready when the previous
+// one ends. The microphone is closed while the robot is speaking.
+class SpeechQueue
+{
+private:
+    class Worker : public Thread
+    {
+    private:
+        SpeechQueue&        m_queue;
+        bool                m_synthesis;
+    public:
+        Worker(SpeechQueue& queue, bool synthesis) : m_queue(queue), m_synthesis(synthesis) {}
+        void run() override { m_synthesis ? m_queue.synthesisLoop() : m_queue.playbackLoop(); }
+    };
+
+    struct Utterance
+    {
+        string              text;
+        Sound               sound;
+    };
+
+    SpeechSynthesizer*      m_speaker;
+    RpcClient&              m_microphone;
+    BufferedPort<Bottle>&   m_playerStatus;
+
+    Worker                  m_synthesisWorker;
+    Worker                  m_playbackWorker;
+
+    mutex                   m_mutex;
+    condition_variable      m_cv;
+    deque<string>           m_texts;            //still to be synthesized
+    deque<Utterance>        m_sounds;           //synthesized, still to be played
+    bool                    m_synthesizing;
+    bool                    m_stopping;
+
+    size_t                  m_prefetch;         //sounds synthesized in advance
+    double                  m_start_timeout;    //the player has not started playing within this time: it is considered done
+    double                  m_poll_period;
+
+public:
+    SpeechQueue(SpeechSynthesizer* speaker, RpcClient& microphone, BufferedPort<Bottle>& playerStatus);
+    ~SpeechQueue() = default;
+
+    bool configure(ResourceFinder &rf);
+    void close();
+
+    bool say(const string& sentence);
+
+private:
+    void synthesisLoop();
+    void playbackLoop();
+    void waitPlaybackEnd();
+    void setMicrophone(bool on);
+};
+
+#endif
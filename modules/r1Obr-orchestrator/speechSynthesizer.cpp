@@ -80,6 +80,23 @@ bool SpeechSynthesizer::configure(ResourceFinder &rf, string suffix)
         m_iSpeech->setVoice(voice);
         m_iSpeech->setPitch(pitch);
         m_iSpeech->setSpeed(speed);
+        m_language = language;
+        m_voice = voice;
+        m_pitch = pitch;
+        m_speed = speed;
+
+        m_cache = new SpeechCache();
+        m_cache->configure(speech_config);
+
+        //the sentences known to be said are synthesized now, unless they are already on disk
+        Bottle* prewarm = speech_config.find("prewarm").asList();
+        for (size_t i=0; prewarm && i<prewarm->size(); i++)
+        {
+            Sound sound;
+            string sentence = prewarm->get(i).asString();
+            if (!synthesize(sentence, sound))
+                yCWarning(SPEECH_SYNTHESIZER, "Cannot pre-warm the cache with: %s", sentence.c_str());
+        }
     }
     
     return true;
@@ -98,6 +115,9 @@ void SpeechSynthesizer::close()
     if(!m_textOutPort.isClosed())
         m_textOutPort.close();
 
+    delete m_cache;
+    m_cache = nullptr;
+
     yCInfo(SPEECH_SYNTHESIZER, "Speech synthesizer thread released");
 }
 
@@ -108,13 +128,25 @@ bool SpeechSynthesizer::say(string& sentence)
     if (!m_active)
         return false;
     
-    Sound& soundToSend = m_audioOutPort.prepare();
-    soundToSend.clear();
-    if(!m_iSpeech->synthesize(sentence,soundToSend))
+    Sound sound;
+    if(!synthesize(sentence,sound))
     {
         yCError(SPEECH_SYNTHESIZER, "Some error occurred synthesizing input string");
         return false;
     }
+
+    return play(sentence, sound);
+}
+
+
+// ------------------------------------------------------ //
+bool SpeechSynthesizer::play(const string& sentence, const Sound& sound)
+{
+    if (!m_active)
+        return false;
+
+    Sound& soundToSend = m_audioOutPort.prepare();
+    soundToSend = sound;
     m_audioOutPort.write();
 
     Bottle& textToSend = m_textOutPort.prepare();
@@ -126,31 +158,66 @@ bool SpeechSynthesizer::say(string& sentence)
 }
 
 
+// ------------------------------------------------------ //
+bool SpeechSynthesizer::synthesize(const string& sentence, Sound& sound)
+{
+    if (!m_active)
+        return false;
+
+    lock_guard<mutex> lock(m_mutex);
+    string key = SpeechCache::makeKey(sentence, m_language, m_voice, m_pitch, m_speed);
+    if (m_cache->get(key, sound))
+        return true;
+
+    if(!m_iSpeech->synthesize(sentence,sound))
+        return false;
+
+    m_cache->put(key, sound);
+    return true;
+}
+
+
 // ------------------------------------------------------ //
 bool SpeechSynthesizer::setLanguage(string& language)
 {
-    return m_iSpeech->setLanguage(language);
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_iSpeech->setLanguage(language))
+        return false;
+    m_language = language;
+    return true;
 }
 
 
 // ------------------------------------------------------ //
 bool SpeechSynthesizer::setVoice(string& voice)
 {
-    return m_iSpeech->setVoice(voice);
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_iSpeech->setVoice(voice))
+        return false;
+    m_voice = voice;
+    return true;
 }
 
 
 // ------------------------------------------------------ //
 bool SpeechSynthesizer::setPitch(double pitch)
 {
-    return m_iSpeech->setPitch(pitch);
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_iSpeech->setPitch(pitch))
+        return false;
+    m_pitch = pitch;
+    return true;
 }
 
 
 // ------------------------------------------------------ //
 bool SpeechSynthesizer::setSpeed(double speed)
 {
-    return m_iSpeech->setSpeed(speed);
+    lock_guard<mutex> lock(m_mutex);
+    if (!m_iSpeech->setSpeed(speed))
+        return false;
+    m_speed = speed;
+    return true;
 }
 
 
@@ -22,6 +22,8 @@
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/ISpeechSynthesizer.h>
 #include <yarp/sig/Sound.h>
+#include "speechCache.h"
+#include <mutex>
 
 using namespace yarp::os;
 using namespace yarp::dev;
@@ -40,13 +42,24 @@ private:
     BufferedPort<Sound>     m_audioOutPort;
     BufferedPort<Bottle>    m_textOutPort;
 
+    //current settings of the synthesizer, part of the cache key
+    string                  m_language;
+    string                  m_voice;
+    double                  m_pitch;
+    double                  m_speed;
+    SpeechCache*            m_cache = nullptr;
+    mutex                   m_mutex;            //the sentences are synthesized by the speech queue worker
+
 public:
     SpeechSynthesizer(){};
     ~SpeechSynthesizer() = default;
 
     bool configure(ResourceFinder &rf, string suffix);
     void close();
+    bool isActive() { return m_active; }
     bool say(string& sentence);
+    bool synthesize(const string& sentence, Sound& sound);
+    bool play(const string& sentence, const Sound& sound);
 
     bool setLanguage(string& language);
     bool setVoice(string& voice);
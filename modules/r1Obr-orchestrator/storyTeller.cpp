@@ -24,6 +24,7 @@ bool StoryTeller::configure(ResourceFinder& rf)
 {
    m_stories_file = "stories_to_read.ini";
    m_active = true;
+   m_max_sentence_length = 150;
 
    if(!rf.check("STORY_TELLER"))
     {
@@ -35,6 +36,7 @@ bool StoryTeller::configure(ResourceFinder& rf)
     {
         Searchable& config = rf.findGroup("STORY_TELLER");
         if(config.check("stories_file")) {m_stories_file = config.find("stories_file").asString();}
+        if(config.check("max_sentence_length")) {m_max_sentence_length = (size_t)config.find("max_sentence_length").asInt32();}
 
         string path_to_file = rf.findFileByName(m_stories_file);
         ifstream file;
@@ -73,6 +75,11 @@ bool StoryTeller::configure(ResourceFinder& rf)
                     value.erase(find_if(value.rbegin(), value.rend(), [](unsigned char ch) { return !isspace(ch); }).base(), value.end());
 
                     m_stories.insert({key, value});
+
+                    //the stories are told one sentence at a time, see getSentences
+                    vector<string> sentences;
+                    splitStory(value, sentences);
+                    m_sentences.insert({key, sentences});
                 }
             }
         }  
@@ -94,3 +101,60 @@ bool StoryTeller::getStory(const string& key, string& story)
 
     return false;
 }
+
+
+/****************************************************************/
+bool StoryTeller::getSentences(const string& key, vector<string>& sentences)
+{
+    sentences.clear();
+    if (m_sentences.find(key) != m_sentences.end())
+    {
+        sentences = m_sentences.at(key);
+        return true;
+    }
+
+    return false;
+}
+
+
+/****************************************************************/
+void StoryTeller::splitStory(const string& story, vector<string>& sentences)
+{
+    //a sentence ends with '.', '!' or '?' (also repeated, e.g. "...") followed by a space.
+    //A longer sentence than m_max_sentence_length is split at ',' ';' ':' too, so that
+    //the first words can be heard without waiting for the synthesis of a long period
+    auto push = [&](size_t begin, size_t end) {
+        string s = story.substr(begin, end - begin);
+        s.erase(s.begin(), find_if(s.begin(), s.end(), [](unsigned char ch) { return !isspace(ch); }));
+        s.erase(find_if(s.rbegin(), s.rend(), [](unsigned char ch) { return !isspace(ch); }).base(), s.end());
+        if (!s.empty())
+            sentences.push_back(s);
+    };
+
+    size_t begin = 0;
+    size_t pause = string::npos;    //last ',' ';' ':' of the current sentence
+    for (size_t i = 0; i < story.size(); i++)
+    {
+        char c = story[i];
+        bool at_boundary = i + 1 == story.size() || isspace((unsigned char)story[i + 1]);
+
+        if ((c == '.' || c == '!' || c == '?') && at_boundary)
+        {
+            push(begin, i + 1);
+            begin = i + 1;
+            pause = string::npos;
+        }
+        else if ((c == ',' || c == ';' || c == ':') && at_boundary)
+        {
+            pause = i + 1;
+        }
+
+        if (i + 1 - begin > m_max_sentence_length && pause != string::npos)
+        {
+            push(begin, pause);
+            begin = pause;
+            pause = string::npos;
+        }
+    }
+    push(begin, story.size());
+}
@@ -20,6 +20,7 @@
 
 #include <yarp/os/all.h>
 #include <unordered_map>
+#include <vector>
 #include <fstream>
 #include <algorithm>
 #include "speechSynthesizer.h"
@@ -35,6 +36,10 @@ private:
     bool m_active;
     string m_stories_file;
     unordered_map<string, string> m_stories;
+    unordered_map<string, vector<string>> m_sentences;
+    size_t m_max_sentence_length;
+
+    void splitStory(const string& story, vector<string>& sentences);
        
 public:
     
@@ -43,6 +48,7 @@ public:
 
     bool configure(ResourceFinder& rf);
     bool getStory(const string& key, string& story);
+    bool getSentences(const string& key, vector<string>& sentences);
 
 };
 
@@ -21,7 +21,7 @@
 YARP_LOG_COMPONENT(TINY_DANCER, "r1_obr.orchestrator.tinyDancer")
 
 
-TinyDancer::TinyDancer(ResourceFinder &_rf) : m_rf(_rf)
+TinyDancer::TinyDancer(ResourceFinder &_rf) : m_engine(nullptr), m_rf(_rf)
 {
     m_robot = "cer";
 };
@@ -32,307 +32,261 @@ bool TinyDancer::configure()
 {
     if(m_rf.check("robot")) {m_robot = m_rf.find("robot").asString();}
     
-    // Polydriver config
-    Property prop;
-
-    prop.put("device","remote_controlboard");
-    prop.put("local","/r1Obr-orchestrator/tinyDancer/right_arm");
-    prop.put("remote","/"+m_robot+"/right_arm");
-    if (!m_drivers[0].open(prop))
-    {
-        yCError(TINY_DANCER,"Unable to connect to %s",("/"+m_robot+"/right_arm").c_str());
-        return false;
-    }
-    prop.clear();
-    prop.put("device","remote_controlboard");
-    prop.put("local","/r1Obr-orchestrator/tinyDancer/left_arm");
-    prop.put("remote","/"+m_robot+"/left_arm");
-    if (!m_drivers[1].open(prop))
-    {
-        yCError(TINY_DANCER,"Unable to connect to %s",("/"+m_robot+"/left_arm").c_str());
-        return false;
-    }
-    prop.clear();
-    prop.put("device","remote_controlboard");
-    prop.put("local","/r1Obr-orchestrator/tinyDancer/head");
-    prop.put("remote","/"+m_robot+"/head");
-    if (!m_drivers[2].open(prop))
+    if(!m_body.open(m_robot, "/r1Obr-orchestrator/tinyDancer", {"right_arm", "left_arm", "head", "torso"}))
     {
-        yCError(TINY_DANCER,"Unable to connect to %s",("/"+m_robot+"/head").c_str());
-        return false;
-    }
-    prop.clear();
-    prop.put("device","remote_controlboard");
-    prop.put("local","/r1Obr-orchestrator/tinyDancer/torso");
-    prop.put("remote","/"+m_robot+"/torso");
-    if (!m_drivers[3].open(prop))
-    {
-        yCError(TINY_DANCER,"Unable to connect to %s",("/"+m_robot+"/torso").c_str());
+        yCError(TINY_DANCER,"Unable to connect to the parts of %s", m_robot.c_str());
         return false;
     }
 
-    m_drivers[0].view(m_iposctrl[0]);
-    m_drivers[1].view(m_iposctrl[1]);
-    m_drivers[2].view(m_iposctrl[2]);
-    m_drivers[3].view(m_iposctrl[3]);
-    if(!m_iposctrl[0] || !m_iposctrl[1] || !m_iposctrl[2] || !m_iposctrl[3] )
+    m_engine = new TrajectoryEngine();
+    if(!m_engine->configure(m_body.drivers(), 4, m_rf.findGroup("TINY_DANCER")))
     {
-        yCError(TINY_DANCER,"Error opening iPositionControl interfaces. Devices not available");
+        yCError(TINY_DANCER,"TrajectoryEngine configuration failed");
         return false;
     }
 
-    m_drivers[0].view(m_ictrlmode[0]);
-    m_drivers[1].view(m_ictrlmode[1]);
-    m_drivers[2].view(m_ictrlmode[2]);
-    m_drivers[3].view(m_ictrlmode[3]);
-    if(!m_ictrlmode[0] || !m_ictrlmode[1] || !m_ictrlmode[2] || !m_ictrlmode[3])
+    loadDances();
+
+    return true;
+}
+
+
+// --------------------------------------------------------------- //
+void TinyDancer::loadDances()
+{
+    string dir = m_rf.findPath("dances");
+    DIR* d = dir == "" ? nullptr : opendir(dir.c_str());
+    if (!d)
     {
-        yCError(TINY_DANCER,"Error opening iControlMode interfaces. Devices not available");
-        return false;
+        yCWarning(TINY_DANCER) << "dances directory not found. The dances will be compiled when requested";
+        return;
     }
 
-    m_drivers[0].view(m_iencoder[0]);
-    m_drivers[1].view(m_iencoder[1]);
-    m_drivers[2].view(m_iencoder[2]);
-    m_drivers[3].view(m_iencoder[3]);
-    if(!m_iencoder[0] || !m_iencoder[1] || !m_iencoder[2] || !m_iencoder[3])
+    lock_guard<mutex> lock(m_dances_mutex);
+    while (dirent* entry = readdir(d))
     {
-        yCError(TINY_DANCER,"Error opening IEncoders interfaces. Devices not available");
-        return false;
+        string name = entry->d_name;
+        if (name.size() > 4 && name.substr(name.size() - 4) == ".ini")
+        {
+            Dance dance;
+            if (compileDance(dir + "/" + name, dance))
+                m_dances["dances/" + name] = dance;
+        }
     }
+    closedir(d);
 
-    return true;
+    yCInfo(TINY_DANCER, "%d dances compiled", (int)m_dances.size());
 }
 
+
 // --------------------------------------------------------------- //
-bool TinyDancer::areJointsOk()
+bool TinyDancer::compileDance(const string& path, Dance& dance)
 {
-    int mode=0;
-    for (int i = 0 ; i<4 ; i++) 
+    ifstream file;
+    file.open(path);
+
+    if (!file)
     {
-        int NUMBER_OF_JOINTS;
-        m_iposctrl[i]->getAxes(&NUMBER_OF_JOINTS);
-        for (int i_joint=0; i_joint < NUMBER_OF_JOINTS; i_joint++)
-        { 
-            m_ictrlmode[i]->getControlMode(i_joint, &mode);
-            if (mode == VOCAB_CM_HW_FAULT)
+        yCError(TINY_DANCER) << path.c_str() << "could not be opened";
+        return false;
+    }
+
+    struct stat info;
+    dance.path = path;
+    dance.mtime = ::stat(path.c_str(), &info) == 0 ? info.st_mtime : 0;
+    dance.steps.clear();
+
+    const char* parts[4] = {"right_arm", "left_arm", "head", "torso"};
+
+    for (string line; getline(file, line);)
+    {
+        if (!line.empty() && line[0] != ';' && line[0] != '#') // if not empty and not a comment
+        {
+            /* must be a key[=: ]value pair */
+            size_t endKey = line.find_first_of("=: ");
+            if (endKey == string::npos) 
+                continue;
+
+            Bottle cmd;
+            cmd.fromString(line.substr(endKey + 1));
+
+            DanceStep step;
+            step.pause = false;
+            step.time = -1.0;
+            for (int part = 0; part < 4; part++)
+                step.moves[part] = false;
+
+            if (cmd.get(0).asString() == "pause")
+            {
+                step.pause = true;
+                step.time = cmd.get(1).asFloat32();
+            }
+            else if (cmd.get(0).asString() == "move")
             {
-                yCError(TINY_DANCER) << "Error: hardware fault detected";
-                return false;
+                Bottle* motion = cmd.get(1).asList();
+                if (!motion)
+                {
+                    yCError(TINY_DANCER) << "Wrong move in" << path.c_str() << ":" << line.c_str();
+                    return false;
+                }
+
+                if (motion->check("time"))
+                    step.time = motion->find("time").asFloat32();
+
+                for (int part = 0; part < 4; part++)
+                {
+                    Bottle* joints = motion->find(parts[part]).asList();
+                    if (!joints)
+                        continue;
+
+                    //as when the file was read at every dance, the missing joints are sent to 0.0
+                    if ((int)joints->size() != m_body.getAxes(part))
+                        yCWarning(TINY_DANCER) << parts[part] << "has" << m_body.getAxes(part) << "joints, found" << (int)joints->size() << "in" << path.c_str();
+
+                    step.moves[part] = true;
+                    for (int i_joint = 0; i_joint < m_body.getAxes(part); i_joint++)
+                        step.joints[part].push_back(joints->get(i_joint).asFloat32());
+                }
             }
-            else if (mode == VOCAB_CM_IDLE)
+            else
             {
-                yCError(TINY_DANCER) << "Error: idle joint detected";
-                return false;
+                continue;
             }
+
+            dance.steps.push_back(step);
         }
     }
 
     return true;
 }
 
+
 // --------------------------------------------------------------- //
-bool TinyDancer::setCtrlMode(const int part, int ctrlMode)
+bool TinyDancer::getDance(const string& dance_file, vector<DanceStep>& steps)
 {
-    int NUMBER_OF_JOINTS;
-    vector<int> joints;
-    vector<int> modes;
-    m_iposctrl[part]->getAxes(&NUMBER_OF_JOINTS);
-    for (int i_joint=0; i_joint < NUMBER_OF_JOINTS; i_joint++)
-    { 
-        joints.push_back(i_joint);
-        modes.push_back(ctrlMode);
-    } 
-
-    m_ictrlmode[part]->setControlModes(NUMBER_OF_JOINTS, joints.data(), modes.data());
-
-    yarp::os::Time::delay(0.01);  // give time to update control modes value
-    m_ictrlmode[part]->getControlModes(NUMBER_OF_JOINTS, joints.data(), modes.data());
-    for (size_t i=0; i<NUMBER_OF_JOINTS; i++)
+    lock_guard<mutex> lock(m_dances_mutex);
+
+    auto it = m_dances.find(dance_file);
+    if (it != m_dances.end())
     {
-        if(modes[i] != ctrlMode)
+        struct stat info;
+        if (::stat(it->second.path.c_str(), &info) == 0 && info.st_mtime == it->second.mtime)
         {
-            yCError(TINY_DANCER) << "Joint " << i << " not in correct control mode for part" << part;
-            return false;
+            steps = it->second.steps;
+            return true;
         }
+        //the file has been modified or removed
+        m_dances.erase(it);
     }
 
+    string path = m_rf.findFileByName(dance_file);
+    Dance dance;
+    if (path == "" || !compileDance(path, dance))
+    {
+        yCError(TINY_DANCER) << dance_file.c_str() << "could not be compiled";
+        return false;
+    }
+
+    yCInfo(TINY_DANCER) << dance_file.c_str() << "compiled";
+    m_dances[dance_file] = dance;
+    steps = dance.steps;
     return true;
 }
 
 // --------------------------------------------------------------- //
-bool TinyDancer::setJointsSpeed(const int part, const double time, Bottle* joint_pos)
+bool TinyDancer::areJointsOk()
 {
-    int NUMBER_OF_JOINTS;
-    vector<int>    joints;
-    vector<double> speeds;
-    m_iposctrl[part]->getAxes(&NUMBER_OF_JOINTS);
-    for (int i_joint=0; i_joint < NUMBER_OF_JOINTS; i_joint++)
-    { 
-        double start, goal;
-        m_iencoder[part]->getEncoder(i_joint,&start);
-        goal = joint_pos->get(i_joint).asFloat32();
-        double disp = start - goal;
-        if(disp<0.0) disp *= -1;
-
-        joints.push_back(i_joint);
-        speeds.push_back(disp/time);
-    } 
-
-    return m_iposctrl[part]->setRefSpeeds(NUMBER_OF_JOINTS, joints.data(), speeds.data());
+    return m_body.areJointsOk();
 }
 
-
 // --------------------------------------------------------------- //
-bool TinyDancer::movePart(const int part, Bottle* joint_pos)
+bool TinyDancer::setCtrlMode(const int part, int ctrlMode)
 {
-    int NUMBER_OF_JOINTS;
-    std::vector<int>    joints;
-    std::vector<double> positions;
-    m_iposctrl[part]->getAxes(&NUMBER_OF_JOINTS);
-    for (int i_joint=0; i_joint < NUMBER_OF_JOINTS; i_joint++)
-    { 
-        joints.push_back(i_joint);
-        positions.push_back(joint_pos->get(i_joint).asFloat32());
-    } 
-
-    return m_iposctrl[part]->positionMove(NUMBER_OF_JOINTS, joints.data(), positions.data());
+    return m_body.setControlMode(part, ctrlMode);
 }
 
-
 // --------------------------------------------------------------- //
 bool TinyDancer::doDance(string& dance_name)
 {      
     if (!areJointsOk())
         return false;
 
-
     string dance_file = "dances/" + (dance_name.find(".ini") == string::npos ? dance_name + ".ini" : dance_name);
 
-    string path_to_file = m_rf.findFileByName(dance_file);
-    ifstream file;
-    file.open(path_to_file);
-
-    if (!file)
-    {
-        yCError(TINY_DANCER) << dance_name.c_str() << "could not be opened";
+    vector<DanceStep> steps;
+    if (!getDance(dance_file, steps))
         return false;
-    }
 
-    
-    for (string line; getline(file, line);)
+    bool ok = true;
+    bool direct[4] = {false, false, false, false};     //parts set in position direct mode
+    for (const auto& step : steps)
     {
-        if (!line.empty() && line[0] != ';' && line[0] != '#') // if not empty and not
+        //the pauses start when the previous move is over
+        if (step.pause)
         {
-            /* must be a key[=: ]value pair */
-            size_t endKey = line.find_first_of("=: ");
-            if (endKey != string::npos) 
-            {
-                string line_cmd = line.substr(endKey + 1);
-                Bottle cmd;
-                cmd.fromString(line_cmd);
-                if (cmd.get(0).asString() == "pause")
-                {
-                    double time = cmd.get(1).asFloat32();
-                    Time::delay(time);
-                }
-                else if (cmd.get(0).asString() == "move")
-                {
-                    Bottle* motion = cmd.get(1).asList();
-                    
-                    double time = -1.0;
-                    if (motion->check("time"))
-                        time = motion->find("time").asFloat32();
-
-                    Bottle* armR_joints=motion->find("right_arm").asList();
-                    Bottle* armL_joints=motion->find("left_arm").asList();
-                    Bottle* head_joints=motion->find("head").asList();
-                    Bottle* torso_joints=motion->find("torso").asList();
-
-                    //Setting control mode e joint speed before moving
-                    bool ok = true;
-                    if (armR_joints)
-                    {
-                        ok = ok && setCtrlMode(0, VOCAB_CM_POSITION);
-                        if (time >= 0)
-                            ok = ok && setJointsSpeed(0, time, armR_joints);
-                    }
-                    if (armL_joints)
-                    {
-                        ok = ok && setCtrlMode(1, VOCAB_CM_POSITION);
-                        if (time >= 0)
-                            ok = ok && setJointsSpeed(1, time, armL_joints);
-                    }
-                    if (head_joints)
-                    {
-                        ok = ok && setCtrlMode(2, VOCAB_CM_POSITION);
-                        if (time >= 0)
-                            ok = ok && setJointsSpeed(2, time, head_joints);
-                    }
-                    if (torso_joints)
-                    {
-                        ok = ok && setCtrlMode(3, VOCAB_CM_POSITION);
-                        if (time >= 0)
-                            ok = ok && setJointsSpeed(3, time, torso_joints);
-                    }
-
-                    //Check that no error occurred
-                    if (!ok || !areJointsOk())
-                    {
-                        yCError(TINY_DANCER) << "An error occurred occured while preparing motion";
-                        return false;
-                    }
-
-                    //Move each part
-                    if (armR_joints)
-                        ok = ok && movePart(0, armR_joints);
-                    if (armL_joints)
-                        ok = ok && movePart(1, armL_joints);
-                    if (head_joints)
-                        ok = ok && movePart(2, head_joints);
-                    if (torso_joints)
-                        ok = ok && movePart(3, torso_joints);
-
-                    //Check again that no error occurred
-                    if (!ok || !areJointsOk())
-                    {
-                        yCError(TINY_DANCER) << "An error occurred occured during motion";
-                        return false;
-                    }
+            Time::delay(step.time);
+            continue;
+        }
 
-                }
+        //Setting control mode before moving
+        vector<vector<double>> targets(4);
+        for (int part = 0; part < 4; part++)
+        {
+            if (!step.moves[part])
+                continue;
+            if (!direct[part])
+            {
+                m_engine->release(part);
+                ok = ok && setCtrlMode(part, VOCAB_CM_POSITION_DIRECT);
+                direct[part] = true;
             }
+            targets[part] = step.joints[part];
         }
-    }  
-    
 
-    return true;
-}
+        //Check that no error occurred
+        if (!ok || !areJointsOk())
+        {
+            yCError(TINY_DANCER) << "An error occurred occured while preparing motion";
+            ok = false;
+            break;
+        }
 
+        //Move all the parts together, until the end of the motion
+        ok = m_engine->moveTo(targets, step.time) && m_engine->waitMotionDone();
 
-// --------------------------------------------------------------- //
-void TinyDancer::close()
-{
-    if(m_drivers[0].isValid())
-    {
-        m_drivers[0].close();
+        //Check again that no error occurred
+        if (!ok || !areJointsOk())
+        {
+            yCError(TINY_DANCER) << "An error occurred occured during motion";
+            ok = false;
+            break;
+        }
     }
 
-    if(m_drivers[1].isValid())
+    //the other modules expect the parts in position mode
+    m_engine->halt();
+    for (int part = 0; part < 4; part++)
     {
-        m_drivers[1].close();
+        if (direct[part])
+            setCtrlMode(part, VOCAB_CM_POSITION);
     }
 
-    if(m_drivers[2].isValid())
-    {
-        m_drivers[2].close();
-    }
+    return ok;
+}
+
 
-    if(m_drivers[3].isValid())
+// --------------------------------------------------------------- //
+void TinyDancer::close()
+{
+    if(m_engine)
     {
-        m_drivers[3].close();
+        m_engine->close();
+        delete m_engine;
+        m_engine = nullptr;
     }
 
+    m_body.close();
+
     yCInfo(TINY_DANCER, "Thread released");
 }
 
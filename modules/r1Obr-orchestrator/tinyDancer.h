@@ -24,6 +24,12 @@
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <vector>
 #include <fstream>
+#include <unordered_map>
+#include <mutex>
+#include <sys/stat.h>
+#include <dirent.h>
+#include "trajectoryEngine.h"
+#include "poseController.h"
 
 
 using namespace yarp::os;
@@ -34,13 +40,34 @@ class TinyDancer
 {
 
 private:
-    PolyDriver          m_drivers[4];
-    IControlMode*       m_ictrlmode[4];     //to set the Position control mode
-    IPositionControl*   m_iposctrl[4];      //to retrieve the number of joints of each part
-    IEncoders*          m_iencoder[4];      //to retrieve joint position
+    //a line of a dance file, parsed once
+    struct DanceStep
+    {
+        bool                pause;
+        double              time;           //duration of the pause, or of the move (-1 if not specified)
+        bool                moves[4];       //right_arm, left_arm, head, torso
+        vector<double>      joints[4];      //target positions of the moved parts
+    };
+
+    struct Dance
+    {
+        string              path;
+        time_t              mtime;          //the dance is compiled again if the file changes
+        vector<DanceStep>   steps;
+    };
+
+    PoseController      m_body;             //right_arm, left_arm, head, torso
+    TrajectoryEngine*   m_engine;           //streams the moves to all the parts
 
     string              m_robot;
     ResourceFinder&     m_rf;
+
+    mutex               m_dances_mutex;
+    unordered_map<string, Dance> m_dances;  //key: file name, e.g. "dances/hi.ini"
+
+    bool compileDance(const string& path, Dance& dance);
+    bool getDance(const string& dance_file, vector<DanceStep>& steps);
+    void loadDances();
     
 public:
     TinyDancer(ResourceFinder &_rf);
@@ -51,8 +78,6 @@ public:
 
     bool areJointsOk();
     bool setCtrlMode(const int part, int ctrlMode);
-    bool setJointsSpeed(const int part, const double time, Bottle* joint_pos);
-    bool movePart(const int part, Bottle* joint_pos);
     bool doDance(string& dance_name);
 
 };
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "searchTelemetry.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+
+YARP_LOG_COMPONENT(SEARCH_TELEMETRY, "r1_obr.searchTelemetry")
+
+
+/****************************************************************/
+SearchTelemetry::SearchTelemetry(const string& module) :
+    PeriodicThread(5.0),
+    m_module(module),
+    m_enabled(false),
+    m_window_size(500),
+    m_dirty(false),
+    m_jsonl(false),
+    m_max_file_size(10.0e6),
+    m_max_files(3)
+{
+    m_port_name = "/" + module + "/telemetry:o";
+    m_file_name = "";
+}
+
+
+/****************************************************************/
+bool SearchTelemetry::configure(ResourceFinder& rf)
+{
+    if(!rf.check("TELEMETRY"))
+        return true;
+
+    Searchable& config = rf.findGroup("TELEMETRY");
+    m_enabled = config.check("enabled") && config.find("enabled").asBool();
+    if (!m_enabled)
+        return true;
+
+    if(config.check("period"))          {setPeriod(config.find("period").asFloat32());}
+    if(config.check("window"))          {m_window_size = (size_t)max(1, config.find("window").asInt32());}
+    if(config.check("port"))            {m_port_name = config.find("port").asString();}
+    if(config.check("file"))            {m_file_name = config.find("file").asString();}
+    if(config.check("format"))          {m_jsonl = config.find("format").asString() == "jsonl";}
+    if(config.check("max_file_size"))   {m_max_file_size = config.find("max_file_size").asFloat32() * 1.0e6;}
+    if(config.check("max_files"))       {m_max_files = config.find("max_files").asInt32();}
+
+    if(!m_port.open(m_port_name))
+    {
+        yCError(SEARCH_TELEMETRY) << "Cannot open port" << m_port_name;
+        return false;
+    }
+
+    if(m_file_name != "" && !openFile())
+        yCWarning(SEARCH_TELEMETRY) << "Cannot open file" << m_file_name << ". Telemetry published only on" << m_port_name;
+
+    yCInfo(SEARCH_TELEMETRY) << "Search telemetry of" << m_module << "published on" << m_port_name;
+
+    return PeriodicThread::start();
+}
+
+
+/****************************************************************/
+void SearchTelemetry::close()
+{
+    if (isRunning())
+        stop();     //calls threadRelease
+}
+
+
+/****************************************************************/
+void SearchTelemetry::threadRelease()
+{
+    run();  //last samples
+
+    if(!m_port.isClosed())
+        m_port.close();
+
+    if(m_file.is_open())
+        m_file.close();
+}
+
+
+/****************************************************************/
+void SearchTelemetry::addSample(const string& phase, double start_time)
+{
+    if (!m_enabled)
+        return;
+
+    double sample = Time::now() - start_time;
+
+    lock_guard<mutex> lock(m_mutex);
+    Phase& p = m_phases[phase];
+    if (p.window.empty())
+        p.window.resize(m_window_size);
+    p.window[p.head] = sample;
+    p.head = (p.head + 1) % p.window.size();
+    if (p.filled < p.window.size())
+        p.filled++;
+    p.count++;
+    p.max = max(p.max, sample);
+    m_dirty = true;
+}
+
+
+/****************************************************************/
+void SearchTelemetry::increment(const string& counter, long n)
+{
+    if (!m_enabled)
+        return;
+
+    lock_guard<mutex> lock(m_mutex);
+    m_counters[counter] += n;
+    m_dirty = true;
+}
+
+
+/****************************************************************/
+double SearchTelemetry::percentile(vector<double>& sorted, double p)
+{
+    //nearest rank
+    size_t rank = (size_t)ceil(p * sorted.size());
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+
+/****************************************************************/
+void SearchTelemetry::run()
+{
+    struct Row
+    {
+        string  name;
+        size_t  count;
+        double  p50, p95, p99, max;
+    };
+    vector<Row> rows;
+    vector<pair<string,long>> counters;
+    bool dirty;
+
+    {
+        lock_guard<mutex> lock(m_mutex);
+        for (auto& it : m_phases)
+        {
+            vector<double> sorted(it.second.window.begin(), it.second.window.begin() + it.second.filled);
+            sort(sorted.begin(), sorted.end());
+            rows.push_back({it.first, it.second.count, percentile(sorted, 0.50), percentile(sorted, 0.95), percentile(sorted, 0.99), it.second.max});
+        }
+        counters.assign(m_counters.begin(), m_counters.end());
+        dirty = m_dirty;
+        m_dirty = false;
+    }
+
+    double now = Time::now();
+
+    // --------- port --------- //
+    //<module> (phases (<name> <count> <p50> <p95> <p99> <max>) ...) (counters (<name> <value>) ...)
+    Bottle& out = m_port.prepare();
+    out.clear();
+    out.addString(m_module);
+    Bottle& phases = out.addList();
+    phases.addString("phases");
+    for (auto& r : rows)
+    {
+        Bottle& b = phases.addList();
+        b.addString(r.name);
+        b.addInt32((int)r.count);
+        b.addFloat64(r.p50);
+        b.addFloat64(r.p95);
+        b.addFloat64(r.p99);
+        b.addFloat64(r.max);
+    }
+    Bottle& counts = out.addList();
+    counts.addString("counters");
+    for (auto& c : counters)
+    {
+        Bottle& b = counts.addList();
+        b.addString(c.first);
+        b.addInt64(c.second);
+    }
+    m_port.write();
+
+    // --------- file --------- //
+    if (!dirty || !m_file.is_open())
+        return;
+
+    char time_str[32];
+    snprintf(time_str, sizeof(time_str), "%.3f", now);
+    if (m_jsonl)
+    {
+        m_file << "{\"time\":" << time_str << ",\"module\":\"" << m_module << "\",\"phases\":{";
+        for (size_t i=0; i<rows.size(); i++)
+        {
+            m_file << (i>0 ? "," : "") << "\"" << rows[i].name << "\":{\"count\":" << rows[i].count
+                   << ",\"p50\":" << rows[i].p50 << ",\"p95\":" << rows[i].p95
+                   << ",\"p99\":" << rows[i].p99 << ",\"max\":" << rows[i].max << "}";
+        }
+        m_file << "},\"counters\":{";
+        for (size_t i=0; i<counters.size(); i++)
+            m_file << (i>0 ? "," : "") << "\"" << counters[i].first << "\":" << counters[i].second;
+        m_file << "}}\n";
+    }
+    else
+    {
+        for (auto& r : rows)
+            m_file << time_str << "," << m_module << "," << r.name << ",phase," << r.count << ","
+                   << r.p50 << "," << r.p95 << "," << r.p99 << "," << r.max << "\n";
+        for (auto& c : counters)
+            m_file << time_str << "," << m_module << "," << c.first << ",counter," << c.second << ",,,,\n";
+    }
+    m_file.flush();
+
+    if ((double)m_file.tellp() > m_max_file_size)
+        rotateFile();
+}
+
+
+/****************************************************************/
+bool SearchTelemetry::openFile()
+{
+    m_file.open(m_file_name, ios::out | ios::app | ios::ate);
+    if (!m_file.is_open())
+        return false;
+
+    if (!m_jsonl && m_file.tellp() == 0)
+        m_file << "time,module,name,type,count,p50,p95,p99,max\n";
+
+    return true;
+}
+
+
+/****************************************************************/
+void SearchTelemetry::rotateFile()
+{
+    m_file.close();
+
+    //<file>.1 is the most recent one, the oldest is removed
+    for (int i=m_max_files-1; i>0; i--)
+    {
+        string from = m_file_name + "." + to_string(i);
+        string to = m_file_name + "." + to_string(i+1);
+        rename(from.c_str(), to.c_str());
+    }
+    if (m_max_files > 0)
+        rename(m_file_name.c_str(), (m_file_name + ".1").c_str());
+    else
+        remove(m_file_name.c_str());
+
+    if (!openFile())
+        yCWarning(SEARCH_TELEMETRY) << "Cannot open file" << m_file_name;
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef SEARCH_TELEMETRY_H
+#define SEARCH_TELEMETRY_H
+
+#include <yarp/os/all.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <fstream>
+
+using namespace std;
+using namespace yarp::os;
+
+// Per-phase timings and counters of a module taking part in the search.
+// The samples of each phase are kept in a fixed-size window, from which the percentiles are
+// computed every "period" seconds and published on a port and, optionally, appended to a file.
+// When the TELEMETRY group is missing or "enabled" is false, every call returns immediately.
+class SearchTelemetry : public PeriodicThread
+{
+private:
+    struct Phase
+    {
+        vector<double>  window;     //last samples, allocated at the first one
+        size_t          head{0};
+        size_t          filled{0};
+        size_t          count{0};   //total number of samples
+        double          max{0.0};
+    };
+
+    string                  m_module;
+    bool                    m_enabled;
+    size_t                  m_window_size;
+    bool                    m_dirty;            //new data since the last file write
+
+    mutex                   m_mutex;
+    map<string, Phase>      m_phases;
+    map<string, long>       m_counters;
+
+    string                  m_port_name;
+    BufferedPort<Bottle>    m_port;
+
+    string                  m_file_name;
+    bool                    m_jsonl;
+    double                  m_max_file_size;    //bytes
+    int                     m_max_files;
+    ofstream                m_file;
+
+public:
+    SearchTelemetry(const string& module);
+    ~SearchTelemetry() = default;
+
+    bool configure(ResourceFinder& rf);
+    void close();
+
+    bool isEnabled() const { return m_enabled; }
+
+    //time now, or 0 if disabled: to be passed to addSample together with the phase name
+    double startTime() const { return m_enabled ? Time::now() : 0.0; }
+    void addSample(const string& phase, double start_time);
+    void increment(const string& counter, long n = 1);
+
+    //inherited from PeriodicThread
+    virtual void run() override;
+    virtual void threadRelease() override;
+
+    //measures the time from its creation to stop() or to the end of the scope
+    class Timer
+    {
+    private:
+        SearchTelemetry*    m_telemetry;
+        const char*         m_phase;
+        double              m_start;
+
+    public:
+        Timer(SearchTelemetry* telemetry, const char* phase) :
+            m_telemetry(telemetry), m_phase(phase),
+            m_start(telemetry && telemetry->isEnabled() ? Time::now() : -1.0) {}
+        ~Timer() { stop(); }
+        void stop()
+        {
+            if (m_start < 0)
+                return;
+            m_telemetry->addSample(m_phase, m_start);
+            m_start = -1.0;
+        }
+    };
+
+private:
+    static double percentile(vector<double>& sorted, double p);
+    bool openFile();
+    void rotateFile();
+};
+
+#endif
@@ -73,6 +73,7 @@ class YarpYolo(yarp.RFModule):
         # self.model = YOLO("yolov8s.pt")
         
         self.label_num = -1 
+        self._image_stamp = yarp.Stamp()
 
         #Define COCO Labels
         self.labels = {0: u'__background__', 1: u'person', 2: u'bicycle',3: u'car', 4: u'motorcycle', 5: u'airplane', 6: u'bus', 7: u'train', 8: u'truck', 9: u'boat', 10: u'traffic light', 11: u'fire hydrant', 12: u'stop sign', 13: u'parking meter', 14: u'bench', 15: u'bird', 16: u'cat', 17: u'dog', 18: u'horse', 19: u'sheep', 20: u'cow', 21: u'elephant', 22: u'bear', 23: u'zebra', 24: u'giraffe', 25: u'backpack', 26: u'umbrella', 27: u'handbag', 28: u'tie', 29: u'suitcase', 30: u'frisbee', 31: u'skis', 32: u'snowboard', 33: u'sports ball', 34: u'kite', 35: u'baseball bat', 36: u'baseball glove', 37: u'skateboard', 38: u'surfboard', 39: u'tennis racket', 40: u'bottle', 41: u'wine glass', 42: u'cup', 43: u'fork', 44: u'knife', 45: u'spoon', 46: u'bowl', 47: u'banana', 48: u'apple', 49: u'sandwich', 50: u'orange', 51: u'broccoli', 52: u'carrot', 53: u'hot dog', 54: u'pizza', 55: u'donut', 56: u'cake', 57: u'chair', 58: u'couch', 59: u'potted plant', 60: u'bed', 61: u'dining table', 62: u'toilet', 63: u'tv', 64: u'laptop', 65: u'mouse', 66: u'remote', 67: u'keyboard', 68: u'cell phone', 69: u'microwave', 70: u'oven', 71: u'toaster', 72: u'sink', 73: u'refrigerator', 74: u'book', 75: u'clock', 76: u'vase', 77: u'scissors', 78: u'teddy bear', 79: u'hair drier', 80: u'toothbrush'}
@@ -192,14 +193,18 @@ class YarpYolo(yarp.RFModule):
                 b.addFloat32(float(box[-2]))
                 b.addFloat32((float(box[0]) + float(box[2]))/2)
                 b.addFloat32((float(box[1]) + float(box[3]))/2)
+                for i in range(4):                  # bounding box: top left and bottom right corners
+                    b.addFloat32(float(box[i]))
                 smtg = 1
         if smtg == 0:
             bout.addString('nothing')
+        self.output_coords_port.setEnvelope(self._image_stamp)
         self.output_coords_port.write()
  
 
     def updateModule(self):
         received_image = self._input_image_port.read()
+        self._input_image_port.getEnvelope(self._image_stamp)   # detections are stamped with the time of the analysed image
         self._in_buf_image.copy(received_image)   
         assert self._in_buf_array.__array_interface__['data'][0] == self._in_buf_image.getRawImage().__int__()
         frame = self._in_buf_array